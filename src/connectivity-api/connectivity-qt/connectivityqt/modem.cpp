@@ -96,6 +96,9 @@ Modem::Modem(const QDBusObjectPath& path,
     connect(d->m_propertyCache.get(),
                 &util::DBusPropertyCache::propertyChanged, d.get(),
                 &Priv::propertyChanged);
+    connect(d->m_propertyCache.get(),
+                &util::DBusPropertyCache::initialized, this,
+                &Modem::initialized);
 
     d->simsUpdated();
 
@@ -121,6 +124,11 @@ Sim *Modem::sim() const
     return d->m_sim.get();
 }
 
+bool Modem::isInitialized() const
+{
+    return d->m_propertyCache->isInitialized();
+}
+
 QString Modem::serial() const
 {
     return d->m_propertyCache->get("Serial").toString();
@@ -55,10 +55,14 @@ public:
     Q_PROPERTY(connectivityqt::Sim* sim READ sim NOTIFY simChanged)
     Sim* sim() const;
 
+    Q_PROPERTY(bool initialized READ isInitialized NOTIFY initialized)
+    bool isInitialized() const;
+
 public Q_SLOTS:
 
 Q_SIGNALS:
     void simChanged(Sim *sim);
+    void initialized();
 
 protected:
     class Priv;
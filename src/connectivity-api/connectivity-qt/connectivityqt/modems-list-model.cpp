@@ -48,6 +48,7 @@ public:
         {
             current << m->path();
         }
+        current.unite(m_pendingModems.keys().toSet());
 
         auto toRemove(current);
         toRemove.subtract(paths);
@@ -55,6 +56,11 @@ public:
         auto toAdd(paths);
         toAdd.subtract(current);
 
+        for (const auto& path: toRemove)
+        {
+            m_pendingModems.remove(path);
+        }
+
         QMutableListIterator<Modem::SPtr> i(m_modems);
         int idx = 0;
         while (i.hasNext())
@@ -72,18 +78,32 @@ public:
             }
         }
 
-        if (!toAdd.isEmpty())
+        // Modems only become rows once their properties have arrived, as
+        // the index is exposed as a constant
+        for (const auto& path: toAdd)
         {
-            p.beginInsertRows(QModelIndex(), m_modems.size(), m_modems.size() + toAdd.size() - 1);
-            for (const auto& path: toAdd)
+            auto modem = std::make_shared<Modem>(path, m_propertyCache->connection(), m_sims);
+            m_pendingModems[path] = modem;
+            connect(modem.get(), &Modem::initialized, this, [this, path]()
             {
-                auto modem = std::make_shared<Modem>(path, m_propertyCache->connection(), m_sims);
-                m_objectOwner(modem.get());
-                m_modems << modem;
-                connect(modem.get(), &Modem::simChanged, this, &Priv::simChanged);
-            }
-            p.endInsertRows();
+                modemInitialized(path);
+            });
+        }
+    }
+
+    void modemInitialized(const QDBusObjectPath& path)
+    {
+        auto modem = m_pendingModems.take(path);
+        if (!modem)
+        {
+            return;
         }
+
+        p.beginInsertRows(QModelIndex(), m_modems.size(), m_modems.size());
+        m_objectOwner(modem.get());
+        m_modems << modem;
+        connect(modem.get(), &Modem::simChanged, this, &Priv::simChanged);
+        p.endInsertRows();
     }
 
     QModelIndex findModem(QObject* o)
@@ -123,6 +143,7 @@ public:
     SimsListModel::SPtr m_sims;
     QList<QDBusObjectPath> m_dbus_paths;
     QList<Modem::SPtr> m_modems;
+    QMap<QDBusObjectPath, Modem::SPtr> m_pendingModems;
 
     shared_ptr<ComUbuntuConnectivity1PrivateInterface> m_writeInterface;
     util::DBusPropertyCache::SPtr m_propertyCache;
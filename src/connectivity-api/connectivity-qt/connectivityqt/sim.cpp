@@ -89,6 +89,9 @@ Sim::Sim(const QDBusObjectPath& path, const QDBusConnection& connection, QObject
     connect(d->m_propertyCache.get(),
                 &util::DBusPropertyCache::propertyChanged, d.get(),
                 &Priv::propertyChanged);
+    connect(d->m_propertyCache.get(),
+                &util::DBusPropertyCache::initialized, this,
+                &Sim::initialized);
 }
 
 Sim::~Sim()
@@ -140,6 +143,11 @@ QList<QString> Sim::preferredLanguages() const
     return d->m_propertyCache->get("PreferredLanguages").toStringList();
 }
 
+bool Sim::isInitialized() const
+{
+    return d->m_propertyCache->isInitialized();
+}
+
 bool Sim::dataRoamingEnabled() const
 {
     return d->m_propertyCache->get("DataRoamingEnabled").toBool();
@@ -70,6 +70,9 @@ public:
     bool dataRoamingEnabled() const;
     void setDataRoamingEnabled(bool value);
 
+    Q_PROPERTY(bool initialized READ isInitialized NOTIFY initialized)
+    bool isInitialized() const;
+
 public Q_SLOTS:
 
     void unlock();
@@ -83,6 +86,7 @@ Q_SIGNALS:
     void mccChanged(const QString &value);
     void mncChanged(const QString &value);
     void preferredLanguagesChanged();
+    void initialized();
 
 protected:
     class Priv;
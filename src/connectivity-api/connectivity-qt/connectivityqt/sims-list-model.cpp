@@ -47,6 +47,7 @@ public:
         {
             current << m->path();
         }
+        current.unite(m_pendingSims.keys().toSet());
 
         auto toRemove(current);
         toRemove.subtract(paths);
@@ -54,6 +55,11 @@ public:
         auto toAdd(paths);
         toAdd.subtract(current);
 
+        for (const auto& path: toRemove)
+        {
+            m_pendingSims.remove(path);
+        }
+
         QMutableListIterator<Sim::SPtr> i(m_sims);
         int idx = 0;
         while (i.hasNext())
@@ -71,26 +77,42 @@ public:
             }
         }
 
-        if (!toAdd.isEmpty())
+        // SIMs only become rows once their properties have arrived, as
+        // the ICCID is exposed as a constant
+        for (const auto& path: toAdd)
         {
-            p.beginInsertRows(QModelIndex(), m_sims.size(), m_sims.size() + toAdd.size() - 1);
-            for (const auto& path: toAdd)
+            auto sim = std::make_shared<Sim>(path, m_propertyCache->connection(), nullptr);
+            m_pendingSims[path] = sim;
+            connect(sim.get(), &Sim::initialized, this, [this, path]()
             {
-                auto sim = std::make_shared<Sim>(path, m_propertyCache->connection(), nullptr);
-                m_objectOwner(sim.get());
-                m_sims << sim;
-                connect(sim.get(), &Sim::lockedChanged, this, &Priv::lockedChanged);
-                connect(sim.get(), &Sim::presentChanged, this, &Priv::presentChanged);
-                connect(sim.get(), &Sim::dataRoamingEnabledChanged, this, &Priv::dataRoamingEnabledChanged);
-                connect(sim.get(), &Sim::imsiChanged, this, &Priv::imsiChanged);
-                connect(sim.get(), &Sim::primaryPhoneNumberChanged, this, &Priv::primaryPhoneNumberChanged);
-                connect(sim.get(), &Sim::mccChanged, this, &Priv::mccChanged);
-                connect(sim.get(), &Sim::mncChanged, this, &Priv::mncChanged);
-                connect(sim.get(), &Sim::preferredLanguagesChanged, this, &Priv::preferredLanguagesChanged);
-            }
-            p.endInsertRows();
+                simInitialized(path);
+            });
+        }
+
+        Q_EMIT p.simsUpdated();
+    }
+
+    void simInitialized(const QDBusObjectPath& path)
+    {
+        auto sim = m_pendingSims.take(path);
+        if (!sim)
+        {
+            return;
         }
 
+        p.beginInsertRows(QModelIndex(), m_sims.size(), m_sims.size());
+        m_objectOwner(sim.get());
+        m_sims << sim;
+        connect(sim.get(), &Sim::lockedChanged, this, &Priv::lockedChanged);
+        connect(sim.get(), &Sim::presentChanged, this, &Priv::presentChanged);
+        connect(sim.get(), &Sim::dataRoamingEnabledChanged, this, &Priv::dataRoamingEnabledChanged);
+        connect(sim.get(), &Sim::imsiChanged, this, &Priv::imsiChanged);
+        connect(sim.get(), &Sim::primaryPhoneNumberChanged, this, &Priv::primaryPhoneNumberChanged);
+        connect(sim.get(), &Sim::mccChanged, this, &Priv::mccChanged);
+        connect(sim.get(), &Sim::mncChanged, this, &Priv::mncChanged);
+        connect(sim.get(), &Sim::preferredLanguagesChanged, this, &Priv::preferredLanguagesChanged);
+        p.endInsertRows();
+
         Q_EMIT p.simsUpdated();
     }
 
@@ -166,6 +188,7 @@ public:
     function<void(QObject*)> m_objectOwner;
     QList<QDBusObjectPath> m_dbus_paths;
     QList<Sim::SPtr> m_sims;
+    QMap<QDBusObjectPath, Sim::SPtr> m_pendingSims;
 
     shared_ptr<ComUbuntuConnectivity1PrivateInterface> m_writeInterface;
     util::DBusPropertyCache::SPtr m_propertyCache;
@@ -83,6 +83,9 @@ VpnConnection::VpnConnection(const QDBusObjectPath& path, const QDBusConnection&
     connect(d->m_propertyCache.get(),
                 &util::DBusPropertyCache::propertyChanged, d.get(),
                 &Priv::propertyChanged);
+    connect(d->m_propertyCache.get(),
+                &util::DBusPropertyCache::initialized, this,
+                &VpnConnection::initialized);
 }
 
 VpnConnection::~VpnConnection()
@@ -114,6 +117,11 @@ bool VpnConnection::activatable() const
     return d->m_propertyCache->get("activatable").toBool();
 }
 
+bool VpnConnection::isInitialized() const
+{
+    return d->m_propertyCache->isInitialized();
+}
+
 void VpnConnection::setId(const QString& id) const
 {
     d->m_propertyCache->set("id", id);
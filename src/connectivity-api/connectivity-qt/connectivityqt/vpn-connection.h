@@ -65,6 +65,9 @@ public:
     Q_PROPERTY(Type type READ type)
     virtual Type type() const = 0;
 
+    Q_PROPERTY(bool initialized READ isInitialized NOTIFY initialized)
+    bool isInitialized() const;
+
 public Q_SLOTS:
     void setId(const QString& id) const;
 
@@ -85,6 +88,8 @@ Q_SIGNALS:
 
     void remove() const;
 
+    void initialized();
+
 protected:
     class Priv;
     std::shared_ptr<Priv> d;
@@ -29,6 +29,8 @@
 #include <QDBusObjectPath>
 #include <QDebug>
 #include <QList>
+#include <QMap>
+#include <QSet>
 
 using namespace std;
 
@@ -58,6 +60,8 @@ public:
         {
             current << connection->path();
         }
+        current.unite(m_pendingVpnConnections.keys().toSet());
+        current.unite(m_pendingTypes.keys().toSet());
 
         auto toRemove(current);
         toRemove.subtract(paths);
@@ -65,6 +69,13 @@ public:
         auto toAdd(paths);
         toAdd.subtract(current);
 
+        for (const auto& path: toRemove)
+        {
+            m_pendingTypes.remove(path);
+            m_pendingVpnConnections.remove(path);
+            m_pendingAddFinished.remove(path);
+        }
+
         QMutableListIterator<VpnConnection::SPtr> i(m_vpnConnections);
         int idx = 0;
         while (i.hasNext())
@@ -82,37 +93,72 @@ public:
             }
         }
 
-        if (!toAdd.isEmpty())
+        // The type decides which class to build, so fetch it first
+        for (const auto& path: toAdd)
         {
-            p.beginInsertRows(QModelIndex(), m_vpnConnections.size(), m_vpnConnections.size() + toAdd.size() - 1);
-            for (const auto& path: toAdd)
+            util::DBusPropertyCache::SPtr typeCache(
+                    new util::DBusPropertyCache(
+                            DBusTypes::DBUS_NAME,
+                            ComUbuntuConnectivity1VpnVpnConnectionInterface::staticInterfaceName(),
+                            path.path(), m_propertyCache->connection()),
+                    [](QObject* self){self->deleteLater();});
+            m_pendingTypes[path] = typeCache;
+            typeCache->whenInitialized(this, [this, path]()
             {
-                ComUbuntuConnectivity1VpnVpnConnectionInterface vpnInterface(
-                        DBusTypes::DBUS_NAME, path.path(), m_propertyCache->connection());
+                typeFetched(path);
+            });
+        }
+    }
 
-                VpnConnection::SPtr vpnConnection;
-                switch(vpnInterface.type())
-                {
-                    case VpnConnection::Type::OPENVPN:
-                        vpnConnection.reset(new OpenvpnConnection(path, m_propertyCache->connection()),
-                                [](QObject* self){self->deleteLater();});
-                        break;
-                    default:
-                        vpnConnection.reset(new PptpConnection(path, m_propertyCache->connection()),
-                                [](QObject* self){self->deleteLater();});
-                        break;
-                }
-                if (vpnConnection)
-                {
-                    m_objectOwner(vpnConnection.get());
-                    m_vpnConnections << vpnConnection;
-                    connect(vpnConnection.get(), &VpnConnection::idChanged, this, &Priv::connectionIdChanged);
-                    connect(vpnConnection.get(), &VpnConnection::activeChanged, this, &Priv::connectionActiveChanged);
-                    connect(vpnConnection.get(), &VpnConnection::activatableChanged, this, &Priv::connectionActivatableChanged);
-                    connect(vpnConnection.get(), &VpnConnection::remove, this, &Priv::removeRequested);
-                }
-            }
-            p.endInsertRows();
+    void typeFetched(const QDBusObjectPath& path)
+    {
+        auto typeCache = m_pendingTypes.take(path);
+        if (!typeCache)
+        {
+            return;
+        }
+
+        VpnConnection::SPtr vpnConnection;
+        switch(typeCache->get("type").toInt())
+        {
+            case VpnConnection::Type::OPENVPN:
+                vpnConnection.reset(new OpenvpnConnection(path, m_propertyCache->connection()),
+                        [](QObject* self){self->deleteLater();});
+                break;
+            default:
+                vpnConnection.reset(new PptpConnection(path, m_propertyCache->connection()),
+                        [](QObject* self){self->deleteLater();});
+                break;
+        }
+
+        // Connections only become rows once their properties have arrived
+        m_pendingVpnConnections[path] = vpnConnection;
+        connect(vpnConnection.get(), &VpnConnection::initialized, this, [this, path]()
+        {
+            vpnConnectionInitialized(path);
+        });
+    }
+
+    void vpnConnectionInitialized(const QDBusObjectPath& path)
+    {
+        auto vpnConnection = m_pendingVpnConnections.take(path);
+        if (!vpnConnection)
+        {
+            return;
+        }
+
+        p.beginInsertRows(QModelIndex(), m_vpnConnections.size(), m_vpnConnections.size());
+        m_objectOwner(vpnConnection.get());
+        m_vpnConnections << vpnConnection;
+        connect(vpnConnection.get(), &VpnConnection::idChanged, this, &Priv::connectionIdChanged);
+        connect(vpnConnection.get(), &VpnConnection::activeChanged, this, &Priv::connectionActiveChanged);
+        connect(vpnConnection.get(), &VpnConnection::activatableChanged, this, &Priv::connectionActivatableChanged);
+        connect(vpnConnection.get(), &VpnConnection::remove, this, &Priv::removeRequested);
+        p.endInsertRows();
+
+        if (m_pendingAddFinished.remove(path))
+        {
+            Q_EMIT p.addFinished(vpnConnection.get());
         }
     }
 
@@ -186,6 +232,10 @@ public Q_SLOTS:
             {
                 Q_EMIT p.addFinished(connection.get());
             }
+            else if (m_pendingVpnConnections.contains(path) || m_pendingTypes.contains(path))
+            {
+                m_pendingAddFinished << path;
+            }
             else
             {
                 qWarning() << __PRETTY_FUNCTION__ << "New connection with path:" << path.path() << " could not be found";
@@ -223,6 +273,13 @@ public:
     util::DBusPropertyCache::SPtr m_propertyCache;
 
     QList<VpnConnection::SPtr> m_vpnConnections;
+
+    // Connections whose type hasn't arrived yet
+    QMap<QDBusObjectPath, util::DBusPropertyCache::SPtr> m_pendingTypes;
+
+    QMap<QDBusObjectPath, VpnConnection::SPtr> m_pendingVpnConnections;
+
+    QSet<QDBusObjectPath> m_pendingAddFinished;
 };
 
 VpnConnectionsListModel::VpnConnectionsListModel(const internal::VpnConnectionsListModelParameters& parameters) :
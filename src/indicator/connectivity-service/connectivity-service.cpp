@@ -29,6 +29,8 @@
 #include <dbus-types.h>
 #include <util/dbus-utils.h>
 
+#include <QDate>
+
 using namespace nmofono;
 using namespace nmofono::vpn;
 using namespace std;
@@ -186,6 +188,13 @@ public Q_SLOTS:
         });
     }
 
+    void throughputUpdated()
+    {
+        notifyPrivateProperties({
+            "LinkThroughput"
+        });
+    }
+
     void updateSims()
     {
         auto current_iccids = m_sims.keys().toSet();
@@ -384,6 +393,16 @@ public Q_SLOTS:
                     reply.first.createReply(QVariant::fromValue(reply.second)));
         }
     }
+
+    void vpnAddFailed(const QString& uuid, const QString& message)
+    {
+        if (m_addQueue.contains(uuid))
+        {
+            m_connection.send(
+                    m_addQueue.take(uuid).createErrorReply(QDBusError::InvalidArgs,
+                                                           message));
+        }
+    }
 };
 
 ConnectivityService::ConnectivityService(Manager::Ptr manager,
@@ -417,10 +436,12 @@ ConnectivityService::ConnectivityService(Manager::Ptr manager,
     connect(d->m_manager.get(), &Manager::simsChanged, d.get(), &Private::updateSims);
     connect(d->m_manager.get(), &Manager::modemsChanged, d.get(), &Private::updateModems);
     connect(d->m_manager.get(), &Manager::simForMobileDataChanged, d.get(), &Private::simForMobileDataUpdated);
+    connect(d->m_manager.get(), &Manager::throughputChanged, d.get(), &Private::throughputUpdated);
 
     connect(d->m_manager.get(), &Manager::reportError, d->m_privateService.get(), &PrivateService::ReportError);
 
     connect(d->m_vpnManager.get(), &vpn::VpnManager::connectionsChanged, d.get(), &Private::updateVpnList);
+    connect(d->m_vpnManager.get(), &vpn::VpnManager::addConnectionFailed, d.get(), &Private::vpnAddFailed);
 
     d->updateSims();
     d->updateModems();
@@ -574,18 +595,10 @@ QDBusObjectPath PrivateService::AddVpnConnection(int type)
     }
     else
     {
-        try
-        {
-            QString uuid = p.d->m_vpnManager->addConnection(
-                    static_cast<VpnConnection::Type>(type));
-            p.d->m_addQueue[uuid] = message();
-        }
-        catch (domain_error& e)
-        {
-            p.d->m_connection.send(
-                    message().createErrorReply(QDBusError::InvalidArgs,
-                                               e.what()));
-        }
+        // Answered from updateVpnList, or vpnAddFailed
+        QString uuid = p.d->m_vpnManager->addConnection(
+                static_cast<VpnConnection::Type>(type));
+        p.d->m_addQueue[uuid] = message();
     }
 
     return QDBusObjectPath();
@@ -615,6 +628,32 @@ void PrivateService::RemoveVpnConnection(const QDBusObjectPath &path)
     }
 }
 
+void PrivateService::SetLinkRefreshRate(const QString &link, uint refreshRateMs)
+{
+    p.d->m_manager->setStatisticsRefreshRate(link, refreshRateMs);
+}
+
+QVariantDictMap PrivateService::GetDataUsage(uint days)
+{
+    // Zero days means everything we have recorded
+    qint64 sinceDay = 0;
+    if (days > 0)
+    {
+        sinceDay = QDate::currentDate().toJulianDay() - days + 1;
+    }
+
+    QVariantDictMap result;
+    auto usage = p.d->m_manager->dataUsage(sinceDay);
+    for (auto it = usage.cbegin(); it != usage.cend(); ++it)
+    {
+        result[it.key()] = QVariantMap{
+            {"TxBytes", it->txBytes},
+            {"RxBytes", it->rxBytes}
+        };
+    }
+    return result;
+}
+
 QString PrivateService::hotspotPassword() const
 {
     return p.d->m_manager->hotspotPassword();
@@ -709,6 +748,37 @@ QList<QDBusObjectPath> PrivateService::sims() const
     return paths;
 }
 
+quint64 PrivateService::statisticsSignalCount() const
+{
+    return p.d->m_manager->statisticsSignalCount();
+}
+
+quint64 PrivateService::accessPointUpdatesCoalesced() const
+{
+    return p.d->m_manager->accessPointUpdatesCoalesced();
+}
+
+quint64 PrivateService::accessPointUpdatesEmitted() const
+{
+    return p.d->m_manager->accessPointUpdatesEmitted();
+}
+
+QVariantDictMap PrivateService::linkThroughput() const
+{
+    QVariantDictMap result;
+    auto throughput = p.d->m_manager->throughput();
+    for (auto it = throughput.cbegin(); it != throughput.cend(); ++it)
+    {
+        result[it.key()] = QVariantMap{
+            {"TxRate", it->txRate},
+            {"RxRate", it->rxRate},
+            {"RecentTxRate", it->recentTxRate},
+            {"RecentRxRate", it->recentRxRate}
+        };
+    }
+    return result;
+}
+
 }
 
 #include "connectivity-service.moc"
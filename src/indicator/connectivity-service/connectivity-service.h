@@ -23,6 +23,8 @@
 #include <nmofono/manager.h>
 #include <nmofono/vpn/vpn-manager.h>
 
+#include <dbus-types.h>
+
 #include <QDBusContext>
 #include <QDBusConnection>
 #include <QObject>
@@ -121,6 +123,20 @@ public:
     Q_PROPERTY(QList<QDBusObjectPath> Sims READ sims)
     QList<QDBusObjectPath> sims() const;
 
+    Q_PROPERTY(QVariantDictMap LinkThroughput READ linkThroughput)
+    QVariantDictMap linkThroughput() const;
+
+    // Not notified, it changes with every statistics update
+    Q_PROPERTY(quint64 StatisticsSignalCount READ statisticsSignalCount)
+    quint64 statisticsSignalCount() const;
+
+    // Not notified either, they are for tuning the scan debounce
+    Q_PROPERTY(quint64 AccessPointUpdatesCoalesced READ accessPointUpdatesCoalesced)
+    quint64 accessPointUpdatesCoalesced() const;
+
+    Q_PROPERTY(quint64 AccessPointUpdatesEmitted READ accessPointUpdatesEmitted)
+    quint64 accessPointUpdatesEmitted() const;
+
 protected Q_SLOTS:
     void UnlockAllModems();
 
@@ -144,6 +160,10 @@ protected Q_SLOTS:
 
     void RemoveVpnConnection(const QDBusObjectPath &path);
 
+    void SetLinkRefreshRate(const QString &link, uint refreshRateMs);
+
+    QVariantDictMap GetDataUsage(uint days);
+
     void setMobileDataEnabled(bool enabled);
 
     void setSimForMobileData(const QDBusObjectPath &path);
@@ -19,7 +19,6 @@
 
 #include <connectivity-service/dbus-openvpn-connection.h>
 #include <OpenVpnAdaptor.h>
-#include <util/dbus-utils.h>
 
 using namespace std;
 using namespace nmofono::vpn;
@@ -30,6 +29,14 @@ type DBusOpenvpnConnection::varname() const\
     return m_openvpnConnection->varname();\
 }
 
+// Secrets are only fetched from NetworkManager once somebody reads one
+#define DEFINE_SECRET_PROPERTY_GETTER(varname, type)\
+type DBusOpenvpnConnection::varname() const\
+{\
+    m_vpnConnection->requestSecrets();\
+    return m_openvpnConnection->varname();\
+}
+
 #define DEFINE_PROPERTY_GETTER_ENUM(varname)\
 int DBusOpenvpnConnection::varname() const\
 {\
@@ -42,24 +49,9 @@ void DBusOpenvpnConnection::set##uppername(int value)\
     m_openvpnConnection->set##uppername(static_cast<OpenvpnConnection::type>(value));\
 }
 
-#define DEFINE_PROPERTY_UPDATER(varname, strname, type)\
-void DBusOpenvpnConnection::varname##Updated(type)\
-{\
-    notifyProperty(strname);\
-}
-
-#define DEFINE_PROPERTY_UPDATER_ENUM(varname, strname, type)\
-void DBusOpenvpnConnection::varname##Updated(OpenvpnConnection::type)\
-{\
-    notifyProperty(strname);\
-}
-
 #define DEFINE_PROPERTY_CONNECTION_FORWARD(uppername)\
 connect(this, &DBusOpenvpnConnection::set##uppername, m_openvpnConnection.get(), &OpenvpnConnection::set##uppername);
 
-#define DEFINE_PROPERTY_CONNECTION_REVERSE(varname)\
-connect(m_openvpnConnection.get(), &OpenvpnConnection::varname##Changed, this, &DBusOpenvpnConnection::varname##Updated);
-
 namespace connectivity_service
 {
 
@@ -127,65 +119,9 @@ DBusOpenvpnConnection::DBusOpenvpnConnection(VpnConnection::SPtr vpnConnection,
     DEFINE_PROPERTY_CONNECTION_FORWARD(ProxyUsername)
     DEFINE_PROPERTY_CONNECTION_FORWARD(ProxyPassword)
 
-
-
-    // Basic properties
-
-    DEFINE_PROPERTY_CONNECTION_REVERSE(ca)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(cert)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(certPass)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(connectionType)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(key)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(localIp)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(password)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(remote)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(remoteIp)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(staticKey)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(staticKeyDirection)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(username)
-
-    // Advanced general properties
-
-    DEFINE_PROPERTY_CONNECTION_REVERSE(port)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(portSet)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(renegSeconds)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(renegSecondsSet)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(compLzo)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(protoTcp)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(dev)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(devType)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(devTypeSet)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(tunnelMtu)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(tunnelMtuSet)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(fragmentSize)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(fragmentSizeSet)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(mssFix)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(remoteRandom)
-
-    // Advanced security properties
-
-    DEFINE_PROPERTY_CONNECTION_REVERSE(cipher)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(keysize)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(keysizeSet)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(auth)
-
-    // Advanced TLS auth properties
-
-    DEFINE_PROPERTY_CONNECTION_REVERSE(tlsRemote)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(remoteCertTls)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(remoteCertTlsSet)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(ta)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(taDir)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(taSet)
-
-    // Advanced proxy settings
-
-    DEFINE_PROPERTY_CONNECTION_REVERSE(proxyPassword)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(proxyPort)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(proxyRetry)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(proxyServer)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(proxyType)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(proxyUsername)
+    // Every property change is announced under the same name on the
+    // D-Bus interface, so there is no list to keep in step here
+    forwardPropertyChanges(m_openvpnConnection.get(), OpenVpnAdaptor::staticMetaObject);
 
     registerDBusObject();
 }
@@ -214,11 +150,11 @@ DEFINE_PROPERTY_SETTER_ENUM(ProxyType, ProxyType)
 
 DEFINE_PROPERTY_GETTER(ca, QString)
 DEFINE_PROPERTY_GETTER(cert, QString)
-DEFINE_PROPERTY_GETTER(certPass, QString)
+DEFINE_SECRET_PROPERTY_GETTER(certPass, QString)
 DEFINE_PROPERTY_GETTER_ENUM(connectionType)
 DEFINE_PROPERTY_GETTER(key, QString)
 DEFINE_PROPERTY_GETTER(localIp, QString)
-DEFINE_PROPERTY_GETTER(password, QString)
+DEFINE_SECRET_PROPERTY_GETTER(password, QString)
 DEFINE_PROPERTY_GETTER(remote, QString)
 DEFINE_PROPERTY_GETTER(remoteIp, QString)
 DEFINE_PROPERTY_GETTER(staticKey, QString)
@@ -266,75 +202,6 @@ DEFINE_PROPERTY_GETTER(proxyServer, QString)
 DEFINE_PROPERTY_GETTER(proxyPort, int)
 DEFINE_PROPERTY_GETTER(proxyRetry, bool)
 DEFINE_PROPERTY_GETTER(proxyUsername, QString)
-DEFINE_PROPERTY_GETTER(proxyPassword, QString)
-
-void DBusOpenvpnConnection::notifyProperty(const QString& propertyName)
-{
-    DBusUtils::notifyPropertyChanged(
-        m_connection,
-        *this,
-        m_path.path(),
-        OpenVpnAdaptor::staticMetaObject.classInfo(OpenVpnAdaptor::staticMetaObject.indexOfClassInfo("D-Bus Interface")).value(),
-        {propertyName}
-    );
-}
-
-// Basic properties
-
-DEFINE_PROPERTY_UPDATER(ca, "ca", const QString &)
-DEFINE_PROPERTY_UPDATER(cert, "cert", const QString &)
-DEFINE_PROPERTY_UPDATER(certPass, "certPass", const QString &)
-DEFINE_PROPERTY_UPDATER_ENUM(connectionType, "connectionType", ConnectionType)
-DEFINE_PROPERTY_UPDATER(key, "key", const QString &)
-DEFINE_PROPERTY_UPDATER(localIp, "localIp", const QString &)
-DEFINE_PROPERTY_UPDATER(password, "password", const QString &)
-DEFINE_PROPERTY_UPDATER(remote, "remote", const QString &)
-DEFINE_PROPERTY_UPDATER(remoteIp, "remoteIp", const QString &)
-DEFINE_PROPERTY_UPDATER(staticKey, "staticKey", const QString &)
-DEFINE_PROPERTY_UPDATER_ENUM(staticKeyDirection, "staticKeyDirection", KeyDir)
-DEFINE_PROPERTY_UPDATER(username, "username", const QString &)
-
-// Advanced general properties
-
-DEFINE_PROPERTY_UPDATER(port, "port", int)
-DEFINE_PROPERTY_UPDATER(portSet, "portSet", bool)
-DEFINE_PROPERTY_UPDATER(renegSeconds, "renegSeconds", int)
-DEFINE_PROPERTY_UPDATER(renegSecondsSet, "renegSecondsSet", bool)
-DEFINE_PROPERTY_UPDATER(compLzo, "compLzo", bool)
-DEFINE_PROPERTY_UPDATER(protoTcp, "protoTcp", bool)
-DEFINE_PROPERTY_UPDATER(dev, "dev", const QString &)
-DEFINE_PROPERTY_UPDATER_ENUM(devType, "devType", DevType)
-DEFINE_PROPERTY_UPDATER(devTypeSet, "devTypeSet", bool)
-DEFINE_PROPERTY_UPDATER(tunnelMtu, "tunnelMtu", int)
-DEFINE_PROPERTY_UPDATER(tunnelMtuSet, "tunnelMtuSet", bool)
-DEFINE_PROPERTY_UPDATER(fragmentSize, "fragmentSize", int)
-DEFINE_PROPERTY_UPDATER(fragmentSizeSet, "fragmentSizeSet", bool)
-DEFINE_PROPERTY_UPDATER(mssFix, "mssFix", bool)
-DEFINE_PROPERTY_UPDATER(remoteRandom, "remoteRandom", bool)
-
-// Advanced security properties
-
-DEFINE_PROPERTY_UPDATER_ENUM(cipher, "cipher", Cipher)
-DEFINE_PROPERTY_UPDATER(keysize, "keysize", int)
-DEFINE_PROPERTY_UPDATER(keysizeSet, "keysizeSet", bool)
-DEFINE_PROPERTY_UPDATER_ENUM(auth, "auth", Auth)
-
-// Advanced TLS auth properties
-
-DEFINE_PROPERTY_UPDATER(tlsRemote, "tlsRemote", const QString &)
-DEFINE_PROPERTY_UPDATER_ENUM(remoteCertTls, "remoteCertTls", TlsType)
-DEFINE_PROPERTY_UPDATER(remoteCertTlsSet, "remoteCertTlsSet", bool)
-DEFINE_PROPERTY_UPDATER(ta, "ta", const QString &)
-DEFINE_PROPERTY_UPDATER_ENUM(taDir, "taDir", KeyDir)
-DEFINE_PROPERTY_UPDATER(taSet, "taSet", bool)
-
-// Advanced proxy settings
-
-DEFINE_PROPERTY_UPDATER_ENUM(proxyType, "proxyType", ProxyType)
-DEFINE_PROPERTY_UPDATER(proxyServer, "proxyServer", const QString &)
-DEFINE_PROPERTY_UPDATER(proxyPort, "proxyPort", int)
-DEFINE_PROPERTY_UPDATER(proxyRetry, "proxyRetry", bool)
-DEFINE_PROPERTY_UPDATER(proxyUsername, "proxyUsername", const QString &)
-DEFINE_PROPERTY_UPDATER(proxyPassword, "proxyPassword", const QString &)
+DEFINE_SECRET_PROPERTY_GETTER(proxyPassword, QString)
 
 }
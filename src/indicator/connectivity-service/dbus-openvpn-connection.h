@@ -179,9 +179,6 @@ public:
     Q_PROPERTY(QString proxyUsername READ proxyUsername WRITE setProxyUsername)
     QString proxyUsername() const;
 
-protected:
-    void notifyProperty(const QString& propertyName);
-
 protected Q_SLOTS:
     // Enum properties
     void setConnectionType(int value);
@@ -200,102 +197,6 @@ protected Q_SLOTS:
 
     void setProxyType(int value);
 
-    // Basic properties
-
-    void caUpdated(const QString &value);
-
-    void certUpdated(const QString &value);
-
-    void certPassUpdated(const QString &value);
-
-    void connectionTypeUpdated(nmofono::vpn::OpenvpnConnection::ConnectionType value);
-
-    void keyUpdated(const QString &value);
-
-    void localIpUpdated(const QString &value);
-
-    void passwordUpdated(const QString &value);
-
-    void remoteUpdated(const QString &value);
-
-    void remoteIpUpdated(const QString &value);
-
-    void staticKeyUpdated(const QString &value);
-
-    void staticKeyDirectionUpdated(nmofono::vpn::OpenvpnConnection::KeyDir value);
-
-    void usernameUpdated(const QString& value);
-
-    // Advanced general properties
-
-    void portUpdated(int value);
-
-    void portSetUpdated(bool value);
-
-    void renegSecondsUpdated(int value);
-
-    void renegSecondsSetUpdated(bool value);
-
-    void compLzoUpdated(bool value);
-
-    void protoTcpUpdated(bool value);
-
-    void devUpdated(const QString &value);
-
-    void devTypeUpdated(nmofono::vpn::OpenvpnConnection::DevType value);
-
-    void devTypeSetUpdated(bool value);
-
-    void tunnelMtuUpdated(int value);
-
-    void tunnelMtuSetUpdated(bool value);
-
-    void fragmentSizeUpdated(int value);
-
-    void fragmentSizeSetUpdated(bool value);
-
-    void mssFixUpdated(bool value);
-
-    void remoteRandomUpdated(bool value);
-
-    // Advanced security properties
-
-    void cipherUpdated(nmofono::vpn::OpenvpnConnection::Cipher value);
-
-    void keysizeUpdated(int value);
-
-    void keysizeSetUpdated(bool value);
-
-    void authUpdated(nmofono::vpn::OpenvpnConnection::Auth value);
-
-    // Advanced TLS auth properties
-
-    void tlsRemoteUpdated(const QString &value);
-
-    void remoteCertTlsUpdated(nmofono::vpn::OpenvpnConnection::TlsType value);
-
-    void remoteCertTlsSetUpdated(bool value);
-
-    void taUpdated(const QString &value);
-
-    void taDirUpdated(nmofono::vpn::OpenvpnConnection::KeyDir value);
-
-    void taSetUpdated(bool value);
-
-    // Advanced proxy tings
-
-    void proxyTypeUpdated(nmofono::vpn::OpenvpnConnection::ProxyType value);
-
-    void proxyServerUpdated(const QString &value);
-
-    void proxyPortUpdated(int value);
-
-    void proxyRetryUpdated(bool value);
-
-    void proxyUsernameUpdated(const QString &value);
-
-    void proxyPasswordUpdated(const QString &value);
-
 Q_SIGNALS:
     // Basic properties
 
@@ -19,7 +19,6 @@
 
 #include <connectivity-service/dbus-pptp-connection.h>
 #include <PptpAdaptor.h>
-#include <util/dbus-utils.h>
 
 using namespace std;
 using namespace nmofono::vpn;
@@ -30,6 +29,14 @@ type DBusPptpConnection::varname() const\
     return m_pptpConnection->varname();\
 }
 
+// Secrets are only fetched from NetworkManager once somebody reads one
+#define DEFINE_SECRET_PROPERTY_GETTER(varname, type)\
+type DBusPptpConnection::varname() const\
+{\
+    m_vpnConnection->requestSecrets();\
+    return m_pptpConnection->varname();\
+}
+
 #define DEFINE_PROPERTY_GETTER_ENUM(varname)\
 int DBusPptpConnection::varname() const\
 {\
@@ -42,24 +49,9 @@ void DBusPptpConnection::set##uppername(int value)\
     m_pptpConnection->set##uppername(static_cast<PptpConnection::type>(value));\
 }
 
-#define DEFINE_PROPERTY_UPDATER(varname, strname, type)\
-void DBusPptpConnection::varname##Updated(type)\
-{\
-    notifyProperty(strname);\
-}
-
-#define DEFINE_PROPERTY_UPDATER_ENUM(varname, strname, type)\
-void DBusPptpConnection::varname##Updated(PptpConnection::type)\
-{\
-    notifyProperty(strname);\
-}
-
 #define DEFINE_PROPERTY_CONNECTION_FORWARD(uppername)\
 connect(this, &DBusPptpConnection::set##uppername, m_pptpConnection.get(), &PptpConnection::set##uppername);
 
-#define DEFINE_PROPERTY_CONNECTION_REVERSE(varname)\
-connect(m_pptpConnection.get(), &PptpConnection::varname##Changed, this, &DBusPptpConnection::varname##Updated);
-
 namespace connectivity_service
 {
 
@@ -92,32 +84,9 @@ DBusPptpConnection::DBusPptpConnection(VpnConnection::SPtr vpnConnection,
     DEFINE_PROPERTY_CONNECTION_FORWARD(TcpHeaderCompression)
     DEFINE_PROPERTY_CONNECTION_FORWARD(SendPppEchoPackets)
 
-
-
-
-    // Basic properties
-
-    DEFINE_PROPERTY_CONNECTION_REVERSE(gateway)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(user)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(password)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(domain)
-
-    // Advanced properties
-
-    DEFINE_PROPERTY_CONNECTION_REVERSE(allowPap)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(allowChap)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(allowMschap)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(allowMschapv2)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(allowEap)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(requireMppe)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(mppeType)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(mppeStateful)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(bsdCompression)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(deflateCompression)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(tcpHeaderCompression)
-    DEFINE_PROPERTY_CONNECTION_REVERSE(sendPppEchoPackets)
-
-
+    // Every property change is announced under the same name on the
+    // D-Bus interface, so there is no list to keep in step here
+    forwardPropertyChanges(m_pptpConnection.get(), PptpAdaptor::staticMetaObject);
 
     registerDBusObject();
 }
@@ -142,7 +111,7 @@ DEFINE_PROPERTY_SETTER_ENUM(MppeType, MppeType)
 
 DEFINE_PROPERTY_GETTER(gateway, QString)
 DEFINE_PROPERTY_GETTER(user, QString)
-DEFINE_PROPERTY_GETTER(password, QString)
+DEFINE_SECRET_PROPERTY_GETTER(password, QString)
 DEFINE_PROPERTY_GETTER(domain, QString)
 
 // Advanced properties
@@ -160,39 +129,4 @@ DEFINE_PROPERTY_GETTER(deflateCompression, bool)
 DEFINE_PROPERTY_GETTER(tcpHeaderCompression, bool)
 DEFINE_PROPERTY_GETTER(sendPppEchoPackets, bool)
 
-
-void DBusPptpConnection::notifyProperty(const QString& propertyName)
-{
-    DBusUtils::notifyPropertyChanged(
-        m_connection,
-        *this,
-        m_path.path(),
-        PptpAdaptor::staticMetaObject.classInfo(PptpAdaptor::staticMetaObject.indexOfClassInfo("D-Bus Interface")).value(),
-        {propertyName}
-    );
-}
-
-// Basic properties
-
-DEFINE_PROPERTY_UPDATER(gateway, "gateway", const QString &)
-DEFINE_PROPERTY_UPDATER(user, "user", const QString &)
-DEFINE_PROPERTY_UPDATER(password, "password", const QString &)
-DEFINE_PROPERTY_UPDATER(domain, "domain", const QString &)
-
-// Advanced properties
-
-DEFINE_PROPERTY_UPDATER(allowPap, "allowPap", bool)
-DEFINE_PROPERTY_UPDATER(allowChap, "allowChap", bool)
-DEFINE_PROPERTY_UPDATER(allowMschap, "allowMschap", bool)
-DEFINE_PROPERTY_UPDATER(allowMschapv2, "allowMschapv2", bool)
-DEFINE_PROPERTY_UPDATER(allowEap, "allowEap", bool)
-DEFINE_PROPERTY_UPDATER(requireMppe, "requireMppe", bool)
-DEFINE_PROPERTY_UPDATER_ENUM(mppeType, "mppeType", MppeType)
-DEFINE_PROPERTY_UPDATER(mppeStateful, "mppeStateful", bool)
-DEFINE_PROPERTY_UPDATER(bsdCompression, "bsdCompression", bool)
-DEFINE_PROPERTY_UPDATER(deflateCompression, "deflateCompression", bool)
-DEFINE_PROPERTY_UPDATER(tcpHeaderCompression, "tcpHeaderCompression", bool)
-DEFINE_PROPERTY_UPDATER(sendPppEchoPackets, "sendPppEchoPackets", bool)
-
-
 }
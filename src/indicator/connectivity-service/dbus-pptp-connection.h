@@ -92,49 +92,10 @@ public:
     Q_PROPERTY(bool sendPppEchoPackets READ sendPppEchoPackets WRITE setSendPppEchoPackets)
     bool sendPppEchoPackets() const;
 
-protected:
-    void notifyProperty(const QString& propertyName);
-
 protected Q_SLOTS:
     // Enum properties
     void setMppeType(int value);
 
-    // Basic properties
-
-    void gatewayUpdated(const QString &value);
-
-    void userUpdated(const QString &value);
-
-    void passwordUpdated(const QString &value);
-
-    void domainUpdated(const QString &value);
-
-    // Advanced properties
-
-    void allowPapUpdated(bool value);
-
-    void allowChapUpdated(bool value);
-
-    void allowMschapUpdated(bool value);
-
-    void allowMschapv2Updated(bool value);
-
-    void allowEapUpdated(bool value);
-
-    void requireMppeUpdated(bool value);
-
-    void mppeTypeUpdated(nmofono::vpn::PptpConnection::MppeType value);
-
-    void mppeStatefulUpdated(bool value);
-
-    void bsdCompressionUpdated(bool value);
-
-    void deflateCompressionUpdated(bool value);
-
-    void tcpHeaderCompressionUpdated(bool value);
-
-    void sendPppEchoPacketsUpdated(bool value);
-
 Q_SIGNALS:
     // Basic properties
 
@@ -22,6 +22,8 @@
 #include <dbus-types.h>
 #include <util/dbus-utils.h>
 
+#include <QMetaProperty>
+
 using namespace std;
 using namespace nmofono::vpn;
 
@@ -92,6 +94,41 @@ void DBusVpnConnection::notifyProperties(const QStringList& propertyNames)
     );
 }
 
+void DBusVpnConnection::forwardPropertyChanges(QObject* source, const QMetaObject& adaptor)
+{
+    m_sourceInterface = adaptor.classInfo(adaptor.indexOfClassInfo("D-Bus Interface")).value();
+
+    auto slot = staticMetaObject.method(staticMetaObject.indexOfSlot("sourcePropertyChanged()"));
+    auto metaObject = source->metaObject();
+    for (int i = metaObject->propertyOffset(); i < metaObject->propertyCount(); ++i)
+    {
+        auto property = metaObject->property(i);
+        if (!property.hasNotifySignal())
+        {
+            continue;
+        }
+        m_sourceProperties.insert(property.notifySignalIndex(), QString::fromLatin1(property.name()));
+        connect(source, property.notifySignal(), this, slot);
+    }
+}
+
+void DBusVpnConnection::sourcePropertyChanged()
+{
+    auto it = m_sourceProperties.constFind(senderSignalIndex());
+    if (it == m_sourceProperties.constEnd())
+    {
+        return;
+    }
+
+    DBusUtils::notifyPropertyChanged(
+        m_connection,
+        *this,
+        m_path.path(),
+        m_sourceInterface,
+        {*it}
+    );
+}
+
 QString DBusVpnConnection::id() const
 {
     return m_vpnConnection->id();
@@ -24,6 +24,7 @@
 #include <QDBusConnection>
 #include <QDBusContext>
 #include <QDBusObjectPath>
+#include <QHash>
 #include <QObject>
 #include <QString>
 
@@ -83,12 +84,22 @@ protected Q_SLOTS:
 
     void neverDefaultUpdated(bool neverDefault);
 
+private Q_SLOTS:
+    void sourcePropertyChanged();
+
 private:
     void notifyProperties(const QStringList& propertyNames);
 
 protected:
     void registerDBusObject();
 
+    /**
+     * Connects every notifying property of source, so a change to one is
+     * announced as a change to the property of the same name on the
+     * adaptor's interface.
+     */
+    void forwardPropertyChanges(QObject* source, const QMetaObject& adaptor);
+
     Q_PROPERTY(int type READ intType)
     int intType() const;
 
@@ -97,6 +108,12 @@ protected:
     QDBusConnection m_connection;
 
     QDBusObjectPath m_path;
+
+private:
+    QString m_sourceInterface;
+
+    // Property names by the index of their notify signal
+    QHash<int, QString> m_sourceProperties;
 };
 
 }
@@ -23,6 +23,7 @@
 #include <util/localisation.h>
 #include <dbus-types.h>
 #include <nmofono/manager-impl.h>
+#include <nmofono/object-snapshot.h>
 #include <nmofono/urfkill-flight-mode-toggle.h>
 #include <nmofono/null-flight-mode-toggle.h>
 #include <nmofono/wifi/network-manager-wifi-toggle.h>
@@ -46,6 +47,21 @@ struct Factory::Private
 
     nmofono::HotspotManager::SPtr m_hotspotManager;
 
+    // Only held until the objects it is used to build have been created
+    nmofono::ObjectSnapshot::SPtr m_objectSnapshot;
+
+    bool m_objectSnapshotFetched = false;
+
+    nmofono::ObjectSnapshot::SPtr objectSnapshot()
+    {
+        if (!m_objectSnapshotFetched)
+        {
+            m_objectSnapshot = nmofono::ObjectSnapshot::fetch(QDBusConnection::systemBus());
+            m_objectSnapshotFetched = true;
+        }
+        return m_objectSnapshot;
+    }
+
     notify::NotificationManager::SPtr singletonNotificationManager()
     {
         if (!m_notificationManager)
@@ -103,7 +119,11 @@ struct Factory::Private
                     wifiToggle,
                     singletonHotspotManager(),
                     singletonActiveConnectionManager(),
-                    QDBusConnection::systemBus());
+                    QDBusConnection::systemBus(),
+                    objectSnapshot());
+
+            // Everything after this follows NetworkManager's signals
+            m_objectSnapshot.reset();
         }
         return m_nmofono;
     }
@@ -113,7 +133,7 @@ struct Factory::Private
         if (!m_activeConnectionManager)
         {
             m_activeConnectionManager = make_shared<nmofono::connection::ActiveConnectionManager>(
-                    QDBusConnection::systemBus());
+                    QDBusConnection::systemBus(), objectSnapshot());
         }
         return m_activeConnectionManager;
     }
@@ -251,11 +271,15 @@ SwitchItem::UPtr Factory::newHotspotSwitch()
     return hotspotSwitch;
 }
 
-BusName::UPtr Factory::newBusName(string name,
-                                  function<void(string)> acquired,
-                                  function<void(string)> lost)
+function<BusName::UPtr()> Factory::newBusNameRequest(string name,
+                                                     function<void(string)> acquired,
+                                                     function<void(string)> lost)
 {
-    return make_unique<BusName>(name, acquired, lost, d->singletonSessionBus());
+    auto sessionBus = d->singletonSessionBus();
+    return [name, acquired, lost, sessionBus]()
+    {
+        return make_unique<BusName>(name, acquired, lost, sessionBus);
+    };
 }
 
 VpnStatusNotifier::UPtr Factory::newVpnStatusNotifier()
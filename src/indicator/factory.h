@@ -79,9 +79,13 @@ public:
 
     virtual SwitchItem::UPtr newHotspotSwitch();
 
-    virtual BusName::UPtr newBusName(std::string name,
-                                     std::function<void(std::string)> acquired,
-                                     std::function<void(std::string)> lost);
+    /**
+     * Claims the name when the returned function is called. That may be
+     * after the factory is gone.
+     */
+    virtual std::function<BusName::UPtr()> newBusNameRequest(std::string name,
+                                                             std::function<void(std::string)> acquired,
+                                                             std::function<void(std::string)> lost);
 
 
     virtual VpnStatusNotifier::UPtr newVpnStatusNotifier();
@@ -21,92 +21,92 @@
 
 using namespace nmofono;
 
-QString Icons::strengthIcon(int8_t strength)
+const IconCache::Entry& Icons::strengthIcon(int8_t strength)
 {
     /* Using same values as used by Android, not linear (LP: #1329945)*/
     if (strength >= 39)
-        return "gsm-3g-full";
+        return IconCache::get(QStringLiteral("gsm-3g-full"));
     else if (strength >= 26)
-        return "gsm-3g-high";
+        return IconCache::get(QStringLiteral("gsm-3g-high"));
     else if (strength >= 16)
-        return "gsm-3g-medium";
+        return IconCache::get(QStringLiteral("gsm-3g-medium"));
     else if (strength >= 6)
-        return "gsm-3g-low";
+        return IconCache::get(QStringLiteral("gsm-3g-low"));
     else
-        return "gsm-3g-none";
+        return IconCache::get(QStringLiteral("gsm-3g-none"));
 }
 
-QString Icons::bearerIcon(wwan::Modem::Bearer bearer)
+const IconCache::Entry& Icons::bearerIcon(wwan::Modem::Bearer bearer)
 {
     switch (bearer)
     {
     case wwan::Modem::Bearer::notAvailable:
-        return "";
+        return IconCache::get(QString());
     case wwan::Modem::Bearer::gprs:
-        return "network-cellular-pre-edge";
+        return IconCache::get(QStringLiteral("network-cellular-pre-edge"));
     case wwan::Modem::Bearer::edge:
-        return "network-cellular-edge";
+        return IconCache::get(QStringLiteral("network-cellular-edge"));
     case wwan::Modem::Bearer::umts:
-        return "network-cellular-3g";
+        return IconCache::get(QStringLiteral("network-cellular-3g"));
     case wwan::Modem::Bearer::hspa:
-        return "network-cellular-hspa";
+        return IconCache::get(QStringLiteral("network-cellular-hspa"));
     case wwan::Modem::Bearer::hspa_plus:
-        return "network-cellular-hspa-plus";
+        return IconCache::get(QStringLiteral("network-cellular-hspa-plus"));
     case wwan::Modem::Bearer::lte:
-        return "network-cellular-lte";
+        return IconCache::get(QStringLiteral("network-cellular-lte"));
     }
     // shouldn't be reached
-    return QString();
+    return IconCache::get(QString());
 }
 
-QString Icons::wifiIcon(nmofono::wifi::WifiLink::Signal signal)
+const IconCache::Entry& Icons::wifiIcon(nmofono::wifi::WifiLink::Signal signal)
 {
     switch (signal)
     {
     case wifi::WifiLink::Signal::disconnected:
-        return "wifi-no-connection";
+        return IconCache::get(QStringLiteral("wifi-no-connection"));
     case wifi::WifiLink::Signal::signal_0:
-        return "nm-signal-00";
+        return IconCache::get(QStringLiteral("nm-signal-00"));
     case wifi::WifiLink::Signal::signal_0_secure:
-        return "nm-signal-00-secure";
+        return IconCache::get(QStringLiteral("nm-signal-00-secure"));
     case wifi::WifiLink::Signal::signal_25:
-        return "nm-signal-25";
+        return IconCache::get(QStringLiteral("nm-signal-25"));
     case wifi::WifiLink::Signal::signal_25_secure:
-        return "nm-signal-25-secure";
+        return IconCache::get(QStringLiteral("nm-signal-25-secure"));
     case wifi::WifiLink::Signal::signal_50:
-        return "nm-signal-50";
+        return IconCache::get(QStringLiteral("nm-signal-50"));
     case wifi::WifiLink::Signal::signal_50_secure:
-        return "nm-signal-50-secure";
+        return IconCache::get(QStringLiteral("nm-signal-50-secure"));
     case wifi::WifiLink::Signal::signal_75:
-        return "nm-signal-75";
+        return IconCache::get(QStringLiteral("nm-signal-75"));
     case wifi::WifiLink::Signal::signal_75_secure:
-        return "nm-signal-75-secure";
+        return IconCache::get(QStringLiteral("nm-signal-75-secure"));
     case wifi::WifiLink::Signal::signal_100:
-        return "nm-signal-100";
+        return IconCache::get(QStringLiteral("nm-signal-100"));
     case wifi::WifiLink::Signal::signal_100_secure:
-        return "nm-signal-100-secure";
+        return IconCache::get(QStringLiteral("nm-signal-100-secure"));
     }
     // shouldn't be reached
-    return QString();
+    return IconCache::get(QString());
 }
 
-QString Icons::ethernetIcon(nmofono::Link::Status status)
+const IconCache::Entry& Icons::ethernetIcon(nmofono::Link::Status status)
 {
     switch (status)
     {
     case Link::Status::connected:
-        return "network-wired-connected";
+        return IconCache::get(QStringLiteral("network-wired-connected"));
     case Link::Status::connecting:
-        return "network-wired-connecting";
+        return IconCache::get(QStringLiteral("network-wired-connecting"));
     case Link::Status::disabled:
-        return "network-wired-disabled";
+        return IconCache::get(QStringLiteral("network-wired-disabled"));
     case Link::Status::offline:
-        return "network-wired-offline";
+        return IconCache::get(QStringLiteral("network-wired-offline"));
     case Link::Status::online:
-        return "network-wired-active";
+        return IconCache::get(QStringLiteral("network-wired-active"));
     case Link::Status::failed:
-        return "network-wired-error";
+        return IconCache::get(QStringLiteral("network-wired-error"));
     }
     // shouldn't be reached
-    return QString();
+    return IconCache::get(QString());
 }
@@ -22,6 +22,12 @@
 #include <nmofono/wifi/wifi-link.h>
 #include <nmofono/wwan/modem.h>
 
+#include "menumodel-cpp/icon-cache.h"
+
+/**
+ * Maps link state to icons. The entries are interned in IconCache, so
+ * looking one up neither allocates nor re-serializes the GIcon.
+ */
 class Icons
 {
 public:
@@ -29,11 +35,11 @@ public:
 
     ~Icons() = delete;
 
-    static QString strengthIcon(int8_t strength);
+    static const IconCache::Entry& strengthIcon(int8_t strength);
 
-    static QString bearerIcon(nmofono::wwan::Modem::Bearer bearer);
+    static const IconCache::Entry& bearerIcon(nmofono::wwan::Modem::Bearer bearer);
 
-    static QString wifiIcon(nmofono::wifi::WifiLink::Signal signal);
+    static const IconCache::Entry& wifiIcon(nmofono::wifi::WifiLink::Signal signal);
 
-    static QString ethernetIcon(nmofono::Link::Status status);
+    static const IconCache::Entry& ethernetIcon(nmofono::Link::Status status);
 };
@@ -178,17 +178,33 @@ MenuBuilder::MenuBuilder(nmofono::Manager::Ptr manager, Factory& factory) :
 
     d->m_ubiquityMenuExporter = factory.newMenuExporter("/com/canonical/indicator/network/ubiquity", d->m_ubiquityMenu->menu());
 
-    d->m_busName = factory.newBusName("com.canonical.indicator.network",
-                                [](std::string) {
+    // Only claim the bus name once the actions are on the bus, so clients
+    // never see the menus without them. The menus carry on being built
+    // in the meantime.
+    auto newBusName = factory.newBusNameRequest("com.canonical.indicator.network",
+                                    [](std::string) {
 #ifdef INDICATOR_NETWORK_TRACE_MESSAGES
-        std::cout << "acquired" << std::endl;
+            std::cout << "acquired" << std::endl;
 #endif
-                                },
-                                [](std::string) {
+                                    },
+                                    [](std::string) {
 #ifdef INDICATOR_NETWORK_TRACE_MESSAGES
-                                    std::cout << "lost" << std::endl;
+                                        std::cout << "lost" << std::endl;
 #endif
-                                });
+                                    });
+    auto requestBusName = [this, newBusName]()
+    {
+        d->m_busName = newBusName();
+    };
+
+    if (d->m_actionGroupExporter->isExported())
+    {
+        requestBusName();
+    }
+    else
+    {
+        connect(d->m_actionGroupExporter.get(), &ActionGroupExporter::exported, d.get(), requestBusName);
+    }
 }
 
 #include "menu-builder.moc"
@@ -66,10 +66,12 @@ EthernetItem::EthernetItem(unsigned int id, bool isSettingsMenu)
     connect(d->m_actionConnected.get(), &Action::activated, d.get(), &Private::actionActivated);
 
     d->m_item = make_shared<MenuItem>();
+    d->m_item->beginTransaction();
     d->m_item->setAction("indicator." + statusConnectedActionId);
 
     d->m_item->setAttribute("x-canonical-type", TypedVariant<string>("com.canonical.indicator.switch"));
     d->m_item->setAttribute("x-canonical-subtitle-action", TypedVariant<string>("indicator." + statusLabelActionId.toStdString()));
+    d->m_item->commitTransaction();
 }
 
 EthernetItem::~EthernetItem()
@@ -50,6 +50,7 @@ ModemInfoItem::ModemInfoItem()
 
     d->m_item = std::make_shared<MenuItem>();
 
+    d->m_item->beginTransaction();
     d->m_item->setAttribute("x-canonical-type", TypedVariant<std::string>("com.canonical.indicator.network.modeminfoitem"));
     d->m_item->setAttribute("x-canonical-modem-status-label-action", TypedVariant<std::string>("indicator." + statusLabelActionId.toStdString()));
     d->m_item->setAttribute("x-canonical-modem-status-icon-action", TypedVariant<std::string>("indicator." + statusIconActionId.toStdString()));
@@ -57,6 +58,7 @@ ModemInfoItem::ModemInfoItem()
     d->m_item->setAttribute("x-canonical-modem-sim-identifier-label-action", TypedVariant<std::string>("indicator." +  simIdentifierActionId.toStdString()));
     d->m_item->setAttribute("x-canonical-modem-roaming-action", TypedVariant<std::string>("indicator." +  roamingActionId.toStdString()));
     d->m_item->setAttribute("x-canonical-modem-locked-action", TypedVariant<std::string>("indicator." +  lockedActionId.toStdString()));
+    d->m_item->commitTransaction();
 
 
 
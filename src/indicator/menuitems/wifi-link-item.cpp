@@ -25,6 +25,7 @@
 #include "menumodel-cpp/action-group-merger.h"
 #include "menumodel-cpp/menu.h"
 #include "menumodel-cpp/menu-merger.h"
+#include "menumodel-cpp/sorted-menu.h"
 
 #include <util/qhash-sharedptr.h>
 #include <util/localisation.h>
@@ -52,14 +53,12 @@ public:
     Menu::Ptr m_topMenu;
 
     Menu::Ptr m_connectedBeforeApsMenu;
-    Menu::Ptr m_neverConnectedApsMenu;
+    SortedMenu::Ptr m_neverConnectedApsMenu;
     MenuMerger::Ptr m_apsMerger;
 
     MenuMerger::Ptr m_rootMerger;
     MenuItem::Ptr m_item;
 
-    std::function<bool(MenuItem::Ptr a, MenuItem::Ptr b)> m_accessPointCompare;
-
     std::string m_icon;
     std::string m_a11ydesc;
 
@@ -76,25 +75,13 @@ public:
         m_topMenu = std::make_shared<Menu>();
 
         m_connectedBeforeApsMenu = std::make_shared<Menu>();
-        m_neverConnectedApsMenu = std::make_shared<Menu>();
+        m_neverConnectedApsMenu = std::make_shared<SortedMenu>();
         m_apsMerger = std::make_shared<MenuMerger>();
 
         m_rootMerger = std::make_shared<MenuMerger>();
 
-        m_accessPointCompare = [](MenuItem::Ptr a, MenuItem::Ptr b){
-            // order alphabetically by SSID
-
-            QString a_label = a->label();
-            QString b_label = b->label();
-
-            QString a_upper = a_label.toUpper();
-            QString b_upper = b_label.toUpper();
-
-            return a_upper < b_upper;
-        };
-
-        updateAccessPoints(m_link->accessPoints());
-        connect(m_link.get(), &wifi::WifiLink::accessPointsUpdated, this, &Private::updateAccessPoints);
+        updateAccessPoints(m_link->accessPoints(), {});
+        connect(m_link.get(), &wifi::WifiLink::accessPointsChanged, this, &Private::updateAccessPoints);
 
         updateActiveAccessPoint(m_link->activeAccessPoint());
         connect(m_link.get(), &wifi::WifiLink::activeAccessPointUpdated, this, &Private::updateActiveAccessPoint);
@@ -108,33 +95,43 @@ public:
         m_item = MenuItem::newSection(m_rootMerger);
     }
 
+    static QString sortKey(MenuItem::Ptr item)
+    {
+        // order alphabetically by SSID
+        return item->label().toUpper();
+    }
+
 public Q_SLOTS:
-    void updateAccessPoints(const QSet<wifi::AccessPoint::Ptr>& accessPoints)
+    void updateAccessPoints(const QSet<wifi::AccessPoint::Ptr>& added,
+                            const QSet<wifi::AccessPoint::Ptr>& removed)
     {
         /// @todo previously connected
         /// @todo apply visibility policy.
 
-        auto old(m_accessPoints.keys().toSet());
-
-        auto added(accessPoints);
-        added.subtract(old);
-
-        auto removed(old);
-        removed.subtract(accessPoints);
-
+        // publish every insertion and removal below as a single change
+        ScopedTransaction<MenuMerger> mergerTransaction(*m_apsMerger);
+        ScopedTransaction<Menu> connectedTransaction(*m_connectedBeforeApsMenu);
+        ScopedTransaction<SortedMenu> neverConnectedTransaction(*m_neverConnectedApsMenu);
 
         for (auto ap: removed) {
+            // Hidden access points never got an item
+            auto it = m_accessPoints.find(ap);
+            if (it == m_accessPoints.end())
+                continue;
+
             bool isActive = (ap == m_activeAccessPoint);
             if (isActive)
-                m_connectedBeforeApsMenu->removeAll(m_accessPoints[ap]->menuItem());
+                m_connectedBeforeApsMenu->removeAll((*it)->menuItem());
             else
-                m_neverConnectedApsMenu->removeAll(m_accessPoints[ap]->menuItem());
+                m_neverConnectedApsMenu->remove((*it)->menuItem());
             /// @todo disconnect activated...
-            m_actionGroupMerger->remove(m_accessPoints[ap]->actionGroup());
-            m_accessPoints.remove(ap);
+            m_actionGroupMerger->remove((*it)->actionGroup());
+            m_accessPoints.erase(it);
         }
 
         for (auto ap : added) {
+            if (m_accessPoints.contains(ap))
+                continue;
 
             /// @todo handle hidden APs all the way
             if (ap->ssid().isEmpty())
@@ -150,7 +147,7 @@ public Q_SLOTS:
             if (isActive) {
                 updateActiveAccessPoint(m_activeAccessPoint);
             } else {
-                m_neverConnectedApsMenu->insert(item->menuItem(), m_accessPointCompare);
+                m_neverConnectedApsMenu->insert(item->menuItem(), sortKey(item->menuItem()));
             }
         }
     }
@@ -159,10 +156,14 @@ public Q_SLOTS:
     {
         m_activeAccessPoint = ap;
 
+        ScopedTransaction<MenuMerger> mergerTransaction(*m_apsMerger);
+        ScopedTransaction<Menu> connectedTransaction(*m_connectedBeforeApsMenu);
+        ScopedTransaction<SortedMenu> neverConnectedTransaction(*m_neverConnectedApsMenu);
+
         auto current = m_connectedBeforeApsMenu->begin();
         if (current != m_connectedBeforeApsMenu->end()) {
             // move to other menu
-            m_neverConnectedApsMenu->insert(*current, m_accessPointCompare);
+            m_neverConnectedApsMenu->insert(*current, sortKey(*current));
             m_connectedBeforeApsMenu->clear();
         }
 
@@ -173,7 +174,7 @@ public Q_SLOTS:
             if (ap && ap == i.key()) {
                 m_connectedBeforeApsMenu->insert(menuItem->menuItem(), m_connectedBeforeApsMenu->begin());
                 menuItem->setActive(true);
-                m_neverConnectedApsMenu->removeAll(menuItem->menuItem());
+                m_neverConnectedApsMenu->remove(menuItem->menuItem());
                 continue;
             }
             menuItem->setActive(false);
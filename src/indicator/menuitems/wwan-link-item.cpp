@@ -138,7 +138,7 @@ WwanLinkItem::Private::update()
                 /* fallthrough */
             case wwan::Modem::ModemStatus::registered:
                 if (m_modem->strength() != 0) {
-                    m_infoItem->setStatusIcon(Icons::strengthIcon(m_modem->strength()));
+                    m_infoItem->setStatusIcon(Icons::strengthIcon(m_modem->strength()).name);
                     m_infoItem->setStatusText(m_modem->operatorName());
                 } else {
                     m_infoItem->setStatusIcon("gsm-3g-no-service");
@@ -146,7 +146,7 @@ WwanLinkItem::Private::update()
                 }
 
                 if (m_modem->dataEnabled()) {
-                    m_infoItem->setConnectivityIcon(Icons::bearerIcon(m_modem->bearer()));
+                    m_infoItem->setConnectivityIcon(Icons::bearerIcon(m_modem->bearer()).name);
                 } else {
                     m_infoItem->setConnectivityIcon("");
                 }
@@ -22,6 +22,11 @@
 
 #include <NetworkManager.h>
 
+#include <QHash>
+#include <QMultiHash>
+
+#include <functional>
+
 using namespace std;
 
 namespace nmofono
@@ -39,7 +44,7 @@ public:
     {
     }
 
-    void updateConnections(const QList<QDBusObjectPath>& connectionsList)
+    void updateConnections(const QList<QDBusObjectPath>& connectionsList, ObjectSnapshot::SPtr snapshot = ObjectSnapshot::SPtr())
     {
         auto current(m_connections.keys().toSet());
         auto connections(connectionsList.toSet());
@@ -50,23 +55,137 @@ public:
         auto toAdd(connections);
         toAdd.subtract(current);
 
+        QSet<QDBusObjectPath> touched;
+
         for (const auto& path: toRemove)
         {
             m_connections.remove(path);
+            touched << unindex(path);
         }
 
         for (const auto& path: toAdd)
         {
-            m_connections[path] = make_shared<ActiveConnection>(path, m_manager->connection());
+            ActiveConnection::SPtr connection;
+            if (snapshot && snapshot->contains(path, NM_DBUS_INTERFACE_ACTIVE_CONNECTION))
+            {
+                connection = make_shared<ActiveConnection>(
+                        path, m_manager->connection(),
+                        snapshot->properties(path, NM_DBUS_INTERFACE_ACTIVE_CONNECTION));
+            }
+            else
+            {
+                connection = make_shared<ActiveConnection>(path, m_manager->connection());
+            }
+            touched << insert(connection);
         }
 
         if (!toRemove.isEmpty() || !toAdd.isEmpty())
         {
+            for (const auto& settingsPath: touched)
+            {
+                notifyWatches(settingsPath);
+            }
+
             Q_EMIT p.connectionsChanged(m_connections.values().toSet());
             Q_EMIT p.connectionsUpdated();
         }
     }
 
+    QDBusObjectPath insert(ActiveConnection::SPtr connection)
+    {
+        auto path = connection->path();
+        m_connections.insert(path, connection);
+
+        connect(connection.get(), &ActiveConnection::connectionPathChanged, this,
+                [this, path]()
+                {
+                    connectionPathChanged(path);
+                });
+
+        return index(connection);
+    }
+
+    QDBusObjectPath index(ActiveConnection::SPtr connection)
+    {
+        auto settingsPath = connection->connectionPath();
+        m_settingsPaths.insert(connection->path(), settingsPath);
+        m_bySettings.insert(settingsPath, connection);
+        return settingsPath;
+    }
+
+    QDBusObjectPath unindex(const QDBusObjectPath& path)
+    {
+        auto settingsPath = m_settingsPaths.take(path);
+
+        auto it = m_bySettings.find(settingsPath);
+        if (it != m_bySettings.end() && (*it)->path() == path)
+        {
+            m_bySettings.erase(it);
+
+            // NetworkManager can briefly keep an old activation of the
+            // same settings connection around while it starts a new one
+            for (auto i = m_settingsPaths.cbegin(); i != m_settingsPaths.cend(); ++i)
+            {
+                if (i.value() == settingsPath)
+                {
+                    m_bySettings.insert(settingsPath, m_connections.value(i.key()));
+                    break;
+                }
+            }
+        }
+
+        return settingsPath;
+    }
+
+    void connectionPathChanged(const QDBusObjectPath& path)
+    {
+        auto connection = m_connections.value(path);
+        if (!connection)
+        {
+            return;
+        }
+
+        auto oldSettingsPath = unindex(path);
+        auto newSettingsPath = index(connection);
+        notifyWatches(oldSettingsPath);
+        notifyWatches(newSettingsPath);
+    }
+
+    void notifyWatches(const QDBusObjectPath& settingsPath)
+    {
+        auto connection = m_bySettings.value(settingsPath);
+
+        auto it = m_watches.find(settingsPath);
+        while (it != m_watches.end() && it.key() == settingsPath)
+        {
+            auto watch = it->lock();
+            if (!watch)
+            {
+                it = m_watches.erase(it);
+                continue;
+            }
+
+            watch->setActiveConnection(connection);
+            ++it;
+        }
+    }
+
+    void pruneWatches(const QDBusObjectPath& settingsPath)
+    {
+        auto it = m_watches.find(settingsPath);
+        while (it != m_watches.end() && it.key() == settingsPath)
+        {
+            if (it->expired())
+            {
+                it = m_watches.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
     ActiveConnection::SPtr addConnection(const QDBusObjectPath& path)
     {
         ActiveConnection::SPtr connection;
@@ -75,7 +194,7 @@ public:
         if (it == m_connections.constEnd())
         {
             connection = make_shared<ActiveConnection>(path, m_manager->connection());
-            m_connections.insert(path, connection);
+            notifyWatches(insert(connection));
             Q_EMIT p.connectionsChanged(m_connections.values().toSet());
             Q_EMIT p.connectionsUpdated();
         }
@@ -87,6 +206,29 @@ public:
         return connection;
     }
 
+    PendingActiveConnection::SPtr watch(const QDBusPendingCall& pendingCall,
+            function<ActiveConnection::SPtr(const QDBusPendingCall&)> resolve)
+    {
+        auto pending = make_shared<PendingActiveConnection>();
+
+        // The lambda holds the handle until the call has finished
+        auto watcher(new QDBusPendingCallWatcher(pendingCall, this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [pending, resolve](QDBusPendingCallWatcher *call)
+                {
+                    call->deleteLater();
+                    if (call->isError())
+                    {
+                        qWarning() << call->error().message();
+                        pending->finish(ActiveConnection::SPtr(), call->error().message());
+                        return;
+                    }
+                    pending->finish(resolve(*call));
+                });
+
+        return pending;
+    }
+
 public Q_SLOTS:
     void propertiesChanged(const QVariantMap &properties)
     {
@@ -99,9 +241,7 @@ public Q_SLOTS:
 
             if (property == "ActiveConnections")
             {
-                QList<QDBusObjectPath> activeConnections;
-                value.value<QDBusArgument>() >> activeConnections;
-                updateConnections(activeConnections);
+                updateConnections(ObjectSnapshot::pathList(value));
             }
         }
     }
@@ -112,14 +252,40 @@ public:
     shared_ptr<OrgFreedesktopNetworkManagerInterface> m_manager;
 
     QMap<QDBusObjectPath, ActiveConnection::SPtr> m_connections;
+
+    // Settings connection path of each active connection
+    QHash<QDBusObjectPath, QDBusObjectPath> m_settingsPaths;
+
+    QHash<QDBusObjectPath, ActiveConnection::SPtr> m_bySettings;
+
+    QMultiHash<QDBusObjectPath, weak_ptr<ActiveConnectionWatch>> m_watches;
 };
 
-ActiveConnectionManager::ActiveConnectionManager(const QDBusConnection& systemConnection) :
+ActiveConnectionManager::ActiveConnectionManager(const QDBusConnection& systemConnection,
+                                                 ObjectSnapshot::SPtr snapshot) :
+        ActiveConnectionManager(
+                make_shared<OrgFreedesktopNetworkManagerInterface>(NM_DBUS_SERVICE, NM_DBUS_PATH, systemConnection),
+                snapshot)
+{
+}
+
+ActiveConnectionManager::ActiveConnectionManager(shared_ptr<OrgFreedesktopNetworkManagerInterface> nm,
+                                                 ObjectSnapshot::SPtr snapshot) :
         d(new Priv(*this))
 {
-    d->m_manager = make_shared<OrgFreedesktopNetworkManagerInterface>(NM_DBUS_SERVICE, NM_DBUS_PATH, systemConnection);
+    d->m_manager = nm;
 
-    d->updateConnections(d->m_manager->activeConnections());
+    if (snapshot && snapshot->contains(QDBusObjectPath(NM_DBUS_PATH), NM_DBUS_INTERFACE))
+    {
+        d->updateConnections(
+                ObjectSnapshot::pathList(snapshot->properties(QDBusObjectPath(NM_DBUS_PATH), NM_DBUS_INTERFACE)
+                        .value("ActiveConnections")),
+                snapshot);
+    }
+    else
+    {
+        d->updateConnections(d->m_manager->activeConnections());
+    }
 
     connect(d->m_manager.get(), &OrgFreedesktopNetworkManagerInterface::PropertiesChanged, d.get(), &Priv::propertiesChanged);
 }
@@ -144,41 +310,56 @@ ActiveConnection::SPtr ActiveConnectionManager::connection(const QDBusObjectPath
     return connection;
 }
 
-bool ActiveConnectionManager::deactivate(ActiveConnection::SPtr activeConnection)
+ActiveConnection::SPtr ActiveConnectionManager::connectionForSettings(const QDBusObjectPath& settingsPath) const
 {
-    auto reply = d->m_manager->DeactivateConnection(activeConnection->path());
-    reply.waitForFinished();
-    if (reply.isError())
-    {
-        qWarning() << reply.error().message();
-        return false;
-    }
-    return true;
+    return d->m_bySettings.value(settingsPath);
 }
 
-ActiveConnection::SPtr ActiveConnectionManager::activate(const QDBusObjectPath& connection, const QDBusObjectPath& device, const QDBusObjectPath& specificObject)
+ActiveConnectionWatch::SPtr ActiveConnectionManager::watch(const QDBusObjectPath& settingsPath)
 {
-    auto reply = d->m_manager->ActivateConnection(connection, device, specificObject);
-    reply.waitForFinished();
-    if (reply.isError())
+    auto watch = make_shared<ActiveConnectionWatch>(settingsPath);
+    watch->setActiveConnection(d->m_bySettings.value(settingsPath));
+    d->m_watches.insert(settingsPath, watch);
+
+    // By the time destroyed is emitted the watch's entry has expired
+    auto priv = d.get();
+    connect(watch.get(), &QObject::destroyed, priv, [priv, settingsPath]()
     {
-        qWarning() << reply.error().message();
-        return ActiveConnection::SPtr();
-    }
-    return d->addConnection(reply);
+        priv->pruneWatches(settingsPath);
+    });
+
+    return watch;
+}
+
+PendingActiveConnection::SPtr ActiveConnectionManager::deactivateAsync(ActiveConnection::SPtr activeConnection)
+{
+    return d->watch(d->m_manager->DeactivateConnection(activeConnection->path()),
+                    [activeConnection](const QDBusPendingCall&)
+                    {
+                        return activeConnection;
+                    });
 }
 
+PendingActiveConnection::SPtr ActiveConnectionManager::activateAsync(const QDBusObjectPath& connection, const QDBusObjectPath& device, const QDBusObjectPath& specificObject)
+{
+    auto priv = d.get();
+    return d->watch(d->m_manager->ActivateConnection(connection, device, specificObject),
+                    [priv](const QDBusPendingCall& call)
+                    {
+                        QDBusPendingReply<QDBusObjectPath> reply(call);
+                        return priv->addConnection(reply);
+                    });
+}
 
-ActiveConnection::SPtr ActiveConnectionManager::addAndActivate(const QVariantDictMap &connection, const QDBusObjectPath &device, const QDBusObjectPath &specificObject)
+PendingActiveConnection::SPtr ActiveConnectionManager::addAndActivateAsync(const QVariantDictMap &connection, const QDBusObjectPath &device, const QDBusObjectPath &specificObject)
 {
-    auto reply = d->m_manager->AddAndActivateConnection(connection, device, specificObject);
-    reply.waitForFinished();
-    if (reply.isError())
-    {
-        qWarning() << reply.error().message();
-        return ActiveConnection::SPtr();
-    }
-    return d->addConnection(reply.argumentAt<1>());
+    auto priv = d.get();
+    return d->watch(d->m_manager->AddAndActivateConnection(connection, device, specificObject),
+                    [priv](const QDBusPendingCall& call)
+                    {
+                        QDBusPendingReply<QDBusObjectPath, QDBusObjectPath> reply(call);
+                        return priv->addConnection(reply.argumentAt<1>());
+                    });
 }
 
 }
@@ -23,8 +23,15 @@
 #include <QSet>
 
 #include <nmofono/connection/active-connection.h>
+#include <nmofono/connection/active-connection-watch.h>
+#include <nmofono/connection/pending-active-connection.h>
+#include <nmofono/object-snapshot.h>
 #include <dbus-types.h>
 
+#include <memory>
+
+class OrgFreedesktopNetworkManagerInterface;
+
 namespace nmofono
 {
 namespace connection
@@ -37,7 +44,11 @@ class ActiveConnectionManager: public QObject
 public:
     UNITY_DEFINES_PTRS(ActiveConnectionManager);
 
-    ActiveConnectionManager(const QDBusConnection& systemConnection);
+    ActiveConnectionManager(const QDBusConnection& systemConnection,
+                            ObjectSnapshot::SPtr snapshot = ObjectSnapshot::SPtr());
+
+    ActiveConnectionManager(std::shared_ptr<OrgFreedesktopNetworkManagerInterface> nm,
+                            ObjectSnapshot::SPtr snapshot = ObjectSnapshot::SPtr());
 
     ~ActiveConnectionManager() = default;
 
@@ -45,11 +56,25 @@ public:
 
     ActiveConnection::SPtr connection(const QDBusObjectPath& path) const;
 
-    bool deactivate(ActiveConnection::SPtr activeConnection);
+    /**
+     * The activation of the given settings connection, or null.
+     */
+    ActiveConnection::SPtr connectionForSettings(const QDBusObjectPath& settingsPath) const;
+
+    /**
+     * Unlike connectionsChanged, the watch is only told about activations
+     * of its own settings connection.
+     */
+    ActiveConnectionWatch::SPtr watch(const QDBusObjectPath& settingsPath);
+
+    // The returned handle resolves once NetworkManager has answered;
+    // deactivateAsync resolves to the connection being deactivated.
+
+    PendingActiveConnection::SPtr deactivateAsync(ActiveConnection::SPtr activeConnection);
 
-    ActiveConnection::SPtr activate(const QDBusObjectPath& connection, const QDBusObjectPath& device = QDBusObjectPath("/"), const QDBusObjectPath& specificObject = QDBusObjectPath("/"));
+    PendingActiveConnection::SPtr activateAsync(const QDBusObjectPath& connection, const QDBusObjectPath& device = QDBusObjectPath("/"), const QDBusObjectPath& specificObject = QDBusObjectPath("/"));
 
-    ActiveConnection::SPtr addAndActivate(const QVariantDictMap &connection, const QDBusObjectPath &device, const QDBusObjectPath &specificObject);
+    PendingActiveConnection::SPtr addAndActivateAsync(const QVariantDictMap &connection, const QDBusObjectPath &device, const QDBusObjectPath &specificObject);
 
 Q_SIGNALS:
     void connectionsChanged(const QSet<ActiveConnection::SPtr>& connections);
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/connection/active-connection-watch.h>
+
+namespace nmofono
+{
+namespace connection
+{
+
+ActiveConnectionWatch::ActiveConnectionWatch(const QDBusObjectPath& settingsPath) :
+        m_settingsPath(settingsPath)
+{
+}
+
+QDBusObjectPath ActiveConnectionWatch::settingsPath() const
+{
+    return m_settingsPath;
+}
+
+ActiveConnection::SPtr ActiveConnectionWatch::activeConnection() const
+{
+    return m_activeConnection;
+}
+
+void ActiveConnectionWatch::setActiveConnection(ActiveConnection::SPtr activeConnection)
+{
+    if (m_activeConnection == activeConnection)
+    {
+        return;
+    }
+
+    m_activeConnection = activeConnection;
+    Q_EMIT activeConnectionChanged(m_activeConnection);
+}
+
+}
+}
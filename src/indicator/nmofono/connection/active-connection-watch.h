@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <QDBusObjectPath>
+#include <QObject>
+
+#include <unity/util/DefinesPtrs.h>
+
+#include <nmofono/connection/active-connection.h>
+
+namespace nmofono
+{
+namespace connection
+{
+
+/**
+ * Follows the activation of a single settings connection.
+ *
+ * Handed out by the ActiveConnectionManager, which only updates the
+ * watches for the settings connection an activation belongs to. The
+ * watch stops receiving updates once the last reference is dropped.
+ */
+class ActiveConnectionWatch: public QObject
+{
+    Q_OBJECT
+
+public:
+    UNITY_DEFINES_PTRS(ActiveConnectionWatch);
+
+    ActiveConnectionWatch(const QDBusObjectPath& settingsPath);
+
+    ~ActiveConnectionWatch() = default;
+
+    QDBusObjectPath settingsPath() const;
+
+    /**
+     * Null while the settings connection is not active.
+     */
+    ActiveConnection::SPtr activeConnection() const;
+
+    /**
+     * Called by the ActiveConnectionManager.
+     */
+    void setActiveConnection(ActiveConnection::SPtr activeConnection);
+
+Q_SIGNALS:
+    void activeConnectionChanged(ActiveConnection::SPtr activeConnection);
+
+protected:
+    QDBusObjectPath m_settingsPath;
+
+    ActiveConnection::SPtr m_activeConnection;
+};
+
+}
+}
@@ -171,6 +171,17 @@ ActiveConnection::ActiveConnection(const QDBusObjectPath& path, const QDBusConne
     connect(d->m_activeConnection.get(), &OrgFreedesktopNetworkManagerConnectionActiveInterface::PropertiesChanged, d.get(), &Priv::propertiesChanged);
 }
 
+ActiveConnection::ActiveConnection(const QDBusObjectPath& path, const QDBusConnection& systemConnection, const QVariantMap& properties) :
+        d(new Priv(*this))
+{
+    d->m_activeConnection = make_shared<OrgFreedesktopNetworkManagerConnectionActiveInterface>(NM_DBUS_SERVICE, path.path(), systemConnection);
+
+    d->m_uuid = properties.value("Uuid").toString();
+    d->propertiesChanged(properties);
+
+    connect(d->m_activeConnection.get(), &OrgFreedesktopNetworkManagerConnectionActiveInterface::PropertiesChanged, d.get(), &Priv::propertiesChanged);
+}
+
 QString ActiveConnection::id() const
 {
     return d->m_id;
@@ -21,6 +21,7 @@
 #include <QDBusConnection>
 #include <QDBusObjectPath>
 #include <QObject>
+#include <QVariantMap>
 
 #include <unity/util/DefinesPtrs.h>
 #include <NetworkManager.h>
@@ -50,6 +51,9 @@ public:
 
     ActiveConnection(const QDBusObjectPath& path, const QDBusConnection& systemConnection);
 
+    // Builds the connection from already known properties, without reading them over D-Bus
+    ActiveConnection(const QDBusObjectPath& path, const QDBusConnection& systemConnection, const QVariantMap& properties);
+
     ~ActiveConnection() = default;
 
     QString id() const;
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/connection/pending-active-connection.h>
+
+namespace nmofono
+{
+namespace connection
+{
+
+bool PendingActiveConnection::isFinished() const
+{
+    return m_finished;
+}
+
+bool PendingActiveConnection::isError() const
+{
+    return m_finished && !m_activeConnection;
+}
+
+QString PendingActiveConnection::errorMessage() const
+{
+    return m_errorMessage;
+}
+
+ActiveConnection::SPtr PendingActiveConnection::activeConnection() const
+{
+    return m_activeConnection;
+}
+
+void PendingActiveConnection::finish(ActiveConnection::SPtr activeConnection, const QString& errorMessage)
+{
+    m_finished = true;
+    m_activeConnection = activeConnection;
+    m_errorMessage = errorMessage;
+    Q_EMIT finished(m_activeConnection);
+}
+
+}
+}
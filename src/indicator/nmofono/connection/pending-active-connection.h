@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#include <unity/util/DefinesPtrs.h>
+
+#include <nmofono/connection/active-connection.h>
+
+namespace nmofono
+{
+namespace connection
+{
+
+/**
+ * Handle for an activation or deactivation request that is still in flight.
+ *
+ * The handle resolves to the ActiveConnection once NetworkManager answers,
+ * or to a null pointer if the request failed. The ActiveConnectionManager
+ * keeps the handle alive until it has finished, so callers that do not
+ * care about the result can simply drop it.
+ */
+class PendingActiveConnection: public QObject
+{
+    Q_OBJECT
+
+public:
+    UNITY_DEFINES_PTRS(PendingActiveConnection);
+
+    PendingActiveConnection() = default;
+
+    ~PendingActiveConnection() = default;
+
+    bool isFinished() const;
+
+    bool isError() const;
+
+    QString errorMessage() const;
+
+    /**
+     * Null until the request has finished successfully.
+     */
+    ActiveConnection::SPtr activeConnection() const;
+
+    /**
+     * Resolves the handle, called by the ActiveConnectionManager.
+     */
+    void finish(ActiveConnection::SPtr activeConnection, const QString& errorMessage = QString());
+
+Q_SIGNALS:
+    void finished(ActiveConnection::SPtr activeConnection);
+
+protected:
+    bool m_finished = false;
+
+    QString m_errorMessage;
+
+    ActiveConnection::SPtr m_activeConnection;
+};
+
+}
+}
@@ -90,6 +90,16 @@ void ConnectivityServiceSettings::setSimForMobileData(const QString &iccid)
     d->m_settings->setValue("SimForMobileData", iccid);
 }
 
+QVariant ConnectivityServiceSettings::wifiScanDebounce()
+{
+    return d->m_settings->value("WifiScanDebounceMs");
+}
+
+QVariant ConnectivityServiceSettings::wifiScanMaxLatency()
+{
+    return d->m_settings->value("WifiScanMaxLatencyMs");
+}
+
 QStringList ConnectivityServiceSettings::knownSims()
 {
     QVariant ret;
@@ -52,6 +52,9 @@ public:
     QVariant simForMobileData();
     void setSimForMobileData(const QString &iccid);
 
+    QVariant wifiScanDebounce();
+    QVariant wifiScanMaxLatency();
+
     QStringList knownSims();
     void setKnownSims(const QStringList &list);
 
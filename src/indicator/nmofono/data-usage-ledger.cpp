@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/data-usage-ledger.h>
+
+#include <QDate>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QStandardPaths>
+
+#include <cstring>
+
+using namespace std;
+
+namespace nmofono
+{
+
+namespace
+{
+
+static constexpr char const MAGIC[4] = {'N', 'D', 'U', 'L'};
+
+static constexpr quint32 VERSION = 1;
+
+static constexpr int KEY_SIZE = 40;
+
+// The file grows a page at a time
+static constexpr quint32 GROWTH = 64;
+
+struct Header
+{
+    char magic[4];
+    quint32 version;
+    quint32 count;
+    char reserved[52];
+};
+
+struct Record
+{
+    quint32 day;
+    quint8 keyLength;
+    quint8 reserved[3];
+    quint64 txBytes;
+    quint64 rxBytes;
+    char key[KEY_SIZE];
+};
+
+static_assert(sizeof(Header) == 64, "ledger header must be 64 bytes");
+static_assert(sizeof(Record) == 64, "ledger record must be 64 bytes");
+
+}
+
+class DataUsageLedger::Private
+{
+public:
+    QFile m_file;
+
+    uchar* m_map{nullptr};
+
+    quint32 m_capacity{0};
+
+    // Record index of each network's entry for m_day
+    QHash<QByteArray, quint32> m_current;
+
+    qint64 m_day{-1};
+
+    Private(const QString& path) :
+        m_file(path)
+    {
+    }
+
+    Header* header() const
+    {
+        return reinterpret_cast<Header*>(m_map);
+    }
+
+    Record* record(quint32 index) const
+    {
+        return reinterpret_cast<Record*>(m_map + sizeof(Header)) + index;
+    }
+
+    bool map(quint32 capacity)
+    {
+        if (m_map)
+        {
+            m_file.unmap(m_map);
+            m_map = nullptr;
+        }
+
+        qint64 size = sizeof(Header) + qint64(capacity) * sizeof(Record);
+        if (m_file.size() < size && !m_file.resize(size))
+        {
+            qWarning() << "Could not grow data usage ledger" << m_file.fileName() << m_file.errorString();
+            return false;
+        }
+
+        m_map = m_file.map(0, size);
+        if (!m_map)
+        {
+            qWarning() << "Could not map data usage ledger" << m_file.fileName() << m_file.errorString();
+            return false;
+        }
+
+        m_capacity = capacity;
+        return true;
+    }
+
+    void open()
+    {
+        QFileInfo info(m_file);
+        QDir().mkpath(info.absolutePath());
+
+        if (!m_file.open(QIODevice::ReadWrite))
+        {
+            qWarning() << "Could not open data usage ledger" << m_file.fileName() << m_file.errorString();
+            return;
+        }
+
+        qint64 size = m_file.size();
+        quint32 capacity = 0;
+        if (size >= qint64(sizeof(Header)))
+        {
+            capacity = (size - sizeof(Header)) / sizeof(Record);
+        }
+
+        if (!map(max(capacity, GROWTH)))
+        {
+            return;
+        }
+
+        auto h = header();
+        if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0
+                || h->version != VERSION || h->count > m_capacity)
+        {
+            if (size > 0)
+            {
+                qWarning() << "Discarding unreadable data usage ledger" << m_file.fileName();
+            }
+            memset(m_map, 0, sizeof(Header) + qint64(m_capacity) * sizeof(Record));
+            memcpy(h->magic, MAGIC, sizeof(MAGIC));
+            h->version = VERSION;
+            h->count = 0;
+        }
+    }
+
+    void rollOver(qint64 day)
+    {
+        m_day = day;
+        m_current.clear();
+
+        // Pick up records already written today, e.g. before a restart
+        for (quint32 i = 0; i < header()->count; ++i)
+        {
+            auto r = record(i);
+            if (r->day == day)
+            {
+                m_current.insert(QByteArray(r->key, r->keyLength), i);
+            }
+        }
+    }
+
+    Record* append(const QByteArray& key)
+    {
+        auto index = header()->count;
+        if (index == m_capacity && !map(m_capacity + GROWTH))
+        {
+            return nullptr;
+        }
+
+        auto r = record(index);
+        memset(r, 0, sizeof(Record));
+        r->day = m_day;
+        r->keyLength = min(key.size(), KEY_SIZE);
+        memcpy(r->key, key.constData(), r->keyLength);
+
+        header()->count = index + 1;
+        m_current.insert(key, index);
+        return r;
+    }
+};
+
+DataUsageLedger::DataUsageLedger(const QString& path) :
+        d(new Private(path))
+{
+    d->open();
+}
+
+DataUsageLedger::~DataUsageLedger()
+{
+    // Unmapping leaves the dirty pages for the kernel to write back
+    if (d->m_map)
+    {
+        d->m_file.unmap(d->m_map);
+    }
+}
+
+QString
+DataUsageLedger::defaultPath()
+{
+    if (qEnvironmentVariableIsSet("INDICATOR_NETWORK_SETTINGS_PATH"))
+    {
+        // For testing only
+        return QString::fromUtf8(qgetenv("INDICATOR_NETWORK_SETTINGS_PATH")) + "/data-usage.ledger";
+    }
+
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)
+            + "/connectivity-service/data-usage.ledger";
+}
+
+QByteArray
+DataUsageLedger::key(Kind kind, const QByteArray& id)
+{
+    if (id.size() >= KEY_SIZE)
+    {
+        qWarning() << "Truncating data usage key" << id;
+    }
+
+    QByteArray result;
+    result.reserve(KEY_SIZE);
+    result.append(static_cast<char>(kind));
+    result.append(id.left(KEY_SIZE - 1));
+    return result;
+}
+
+void
+DataUsageLedger::add(const QByteArray& key, quint64 txBytes, quint64 rxBytes)
+{
+    add(key, txBytes, rxBytes, QDate::currentDate().toJulianDay());
+}
+
+void
+DataUsageLedger::add(const QByteArray& key, quint64 txBytes, quint64 rxBytes, qint64 day)
+{
+    if (!d->m_map || key.isEmpty())
+    {
+        return;
+    }
+
+    if (day != d->m_day)
+    {
+        d->rollOver(day);
+    }
+
+    Record* r = nullptr;
+    auto it = d->m_current.constFind(key);
+    if (it != d->m_current.constEnd())
+    {
+        r = d->record(*it);
+    }
+    else
+    {
+        r = d->append(key);
+    }
+
+    if (r)
+    {
+        r->txBytes += txBytes;
+        r->rxBytes += rxBytes;
+    }
+}
+
+QMap<QString, DataUsage>
+DataUsageLedger::totals(qint64 sinceDay) const
+{
+    QMap<QString, DataUsage> result;
+    if (!d->m_map)
+    {
+        return result;
+    }
+
+    for (quint32 i = 0; i < d->header()->count; ++i)
+    {
+        auto r = d->record(i);
+        if (r->day < sinceDay || r->keyLength == 0)
+        {
+            continue;
+        }
+
+        QString name;
+        switch (static_cast<Kind>(r->key[0]))
+        {
+            case Kind::sim:
+                name = "sim:";
+                break;
+            case Kind::wifi:
+                name = "wifi:";
+                break;
+            case Kind::ethernet:
+                name = "ethernet:";
+                break;
+            default:
+                continue;
+        }
+        name += QString::fromUtf8(r->key + 1, r->keyLength - 1);
+
+        auto& usage = result[name];
+        usage.txBytes += r->txBytes;
+        usage.rxBytes += r->rxBytes;
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+
+#include <memory>
+#include <unity/util/DefinesPtrs.h>
+
+namespace nmofono
+{
+
+struct DataUsage
+{
+    quint64 txBytes{0};
+    quint64 rxBytes{0};
+};
+
+/**
+ * Accumulates transferred bytes per network and per day.
+ *
+ * The ledger is a file of fixed size records that is memory mapped. There is
+ * one record for each network on each day. Records for earlier days are never
+ * touched again, and a new day's records are appended. Updates only dirty the
+ * mapped pages, and the kernel writes them back, so recording a sample never
+ * waits for the disk.
+ */
+class DataUsageLedger
+{
+public:
+    UNITY_DEFINES_PTRS(DataUsageLedger);
+
+    enum class Kind : char
+    {
+        sim = 's',
+        wifi = 'w',
+        ethernet = 'e'
+    };
+
+    explicit DataUsageLedger(const QString& path = defaultPath());
+
+    ~DataUsageLedger();
+
+    static QString defaultPath();
+
+    /**
+     * Builds the key a network is recorded under. Callers should keep hold
+     * of it, so that recording a sample doesn't allocate.
+     */
+    static QByteArray key(Kind kind, const QByteArray& id);
+
+    void add(const QByteArray& key, quint64 txBytes, quint64 rxBytes);
+
+    void add(const QByteArray& key, quint64 txBytes, quint64 rxBytes, qint64 day);
+
+    /**
+     * Totals per network, starting from the given Julian day. The networks
+     * are named "sim:<ICCID>", "wifi:<SSID>" or "ethernet:<UUID>".
+     */
+    QMap<QString, DataUsage> totals(qint64 sinceDay = 0) const;
+
+private:
+    class Private;
+    std::unique_ptr<Private> d;
+};
+
+}
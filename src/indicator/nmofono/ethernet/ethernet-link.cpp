@@ -206,6 +206,17 @@ public Q_SLOTS:
         }
     }
 
+    void
+    dbusCallFinished(QDBusPendingCallWatcher *call)
+    {
+        QDBusPendingReply<> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << reply.error().message();
+        }
+        call->deleteLater();
+    }
+
 public:
     EthernetLink& p;
 
@@ -318,19 +329,15 @@ EthernetLink::setAutoConnect(bool autoConnect)
     {
         if (d->m_preferredConnection)
         {
-            d->m_connectionManager->activate(d->m_preferredConnection->path(), QDBusObjectPath(d->m_dev->path()));
+            d->m_connectionManager->activateAsync(d->m_preferredConnection->path(), QDBusObjectPath(d->m_dev->path()));
         }
         d->m_dev->setAutoconnect(true);
     }
     else
     {
         d->m_dev->setAutoconnect(false);
-        auto reply = d->m_dev->Disconnect();
-        reply.waitForFinished();
-        if (reply.isError())
-        {
-            qWarning() << reply.error().message();
-        }
+        auto watcher(new QDBusPendingCallWatcher(d->m_dev->Disconnect(), d.get()));
+        connect(watcher, &QDBusPendingCallWatcher::finished, d.get(), &Private::dbusCallFinished);
     }
 
     Q_EMIT autoConnectChanged(autoConnect);
@@ -348,7 +355,7 @@ EthernetLink::setPreferredConnection(AvailableConnection::SPtr preferredConnecti
 
     if (d->m_autoConnect && preferredConnection)
     {
-        d->m_connectionManager->activate(d->m_preferredConnection->path(), QDBusObjectPath(d->m_dev->path()));
+        d->m_connectionManager->activateAsync(d->m_preferredConnection->path(), QDBusObjectPath(d->m_dev->path()));
     }
 
     Q_EMIT preferredConnectionChanged(preferredConnection);
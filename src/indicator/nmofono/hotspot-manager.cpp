@@ -20,21 +20,27 @@
 
 #include <nmofono/hotspot-manager.h>
 #include <qpowerd/qpowerd.h>
-#include <NetworkManagerActiveConnectionInterface.h>
 #include <NetworkManagerDeviceInterface.h>
 #include <NetworkManagerInterface.h>
 #include <NetworkManagerSettingsInterface.h>
 #include <NetworkManagerSettingsConnectionInterface.h>
+#include <PropertiesInterface.h>
 #include <URfkillInterface.h>
 
 #include <QStringList>
 #include <QDBusReply>
 #include <QtDebug>
-#include <QDBusInterface>
+#include <QDBusMessage>
 #include <QDBusMetaType>
+#include <QDBusPendingCallWatcher>
+#include <QProcess>
 #include <QRegularExpression>
+#include <QTimer>
+#include <QVector>
 #include <NetworkManager.h>
 
+#include <functional>
+
 using namespace std;
 
 namespace nmofono
@@ -51,6 +57,31 @@ struct ApDevice
     QString m_interface;
 };
 
+/**
+ * The properties of every NetworkManager device, gathered while looking for
+ * the AP device.
+ */
+struct DeviceProbe
+{
+    QList<QDBusObjectPath> m_paths;
+    QVector<QVariantMap> m_properties;
+    int m_outstanding = 0;
+};
+
+/**
+ * The steps of enabling a hotspot. Each step waits for a D-Bus reply or
+ * signal rather than blocking, and the waits for the AP device and the
+ * activation are bounded by m_timeout.
+ */
+enum class EnableStep
+{
+    idle,
+    firmware,
+    device,
+    connection,
+    activation
+};
+
 class HotspotManager::Priv: public QObject
 {
 
@@ -58,100 +89,299 @@ public:
     Priv(HotspotManager& parent) :
         p(parent)
     {
+        m_timeout.setSingleShot(true);
+        m_timeout.setInterval(2000);
+        connect(&m_timeout, &QTimer::timeout, this, &Priv::timedOut);
     }
 
-    void addConnection()
+    bool enabling() const
     {
-        qDebug() << "Adding new hotspot connection";
-        QVariantDictMap connection = createConnectionSettings(m_ssid, m_password,
-                                                              m_mode, m_auth);
+        return m_step != EnableStep::idle;
+    }
 
-        auto add_connection_reply = m_settings->AddConnection(connection);
-        add_connection_reply.waitForFinished();
+    /**
+     * Starts enabling a hotspot, progress is driven by D-Bus replies
+     * and signals from here on.
+     */
+    void startEnable()
+    {
+        m_step = EnableStep::firmware;
+        int attempt = ++m_attempt;
 
-        if (add_connection_reply.isError())
+        // We use Hybris to load the new device firmware
+        setInterfaceFirmware("/", m_mode, [this, attempt](bool)
         {
-            qCritical() << "Failed to add connection: "
-                    << add_connection_reply.error().message();
-            Q_EMIT p.reportError(0);
-            m_hotspot.reset();
+            if (attempt == m_attempt)
+            {
+                waitForApDevice();
+            }
+        });
+    }
 
-            setStored(false);
-            return;
+    /**
+     * Abandons any enable that is in progress.
+     */
+    void cancelEnable()
+    {
+        ++m_attempt;
+        m_step = EnableStep::idle;
+        m_activationDone = function<void(bool)>();
+        stopWaiting();
+    }
+
+    void stopWaiting()
+    {
+        m_timeout.stop();
+        disconnect(m_deviceAddedConnection);
+        disconnect(m_activationStateConnection);
+        m_watchedDevices.clear();
+    }
+
+    void finishEnable(bool success)
+    {
+        m_step = EnableStep::idle;
+        stopWaiting();
+        setEnable(success);
+        if (success)
+        {
+            // If our connection gets booted, reconnect
+            connect(m_activeConnectionManager.get(),
+                    &connection::ActiveConnectionManager::connectionsUpdated, this,
+                    &Priv::reactivateConnection,
+                    Qt::ConnectionType(Qt::QueuedConnection | Qt::UniqueConnection));
         }
+    }
 
-        QDBusObjectPath connectionPath(add_connection_reply);
+    void waitForApDevice()
+    {
+        m_step = EnableStep::device;
+        m_device.reset();
 
-        m_hotspot = make_shared<
-                OrgFreedesktopNetworkManagerSettingsConnectionInterface>(
-                NM_DBUS_SERVICE, connectionPath.path(), m_manager->connection());
+        m_deviceAddedConnection = connect(m_manager.get(),
+                &OrgFreedesktopNetworkManagerInterface::DeviceAdded, this,
+                &Priv::checkApDevice);
+        m_timeout.start();
 
-        setStored(true);
+        int attempt = m_attempt;
+        withTetheringInterface([this, attempt]()
+        {
+            if (attempt == m_attempt)
+            {
+                checkApDevice();
+            }
+        });
     }
 
-    void updateConnection()
+    void checkApDevice()
     {
-        qDebug() << "Updating hotspot connection";
-        // Get new settings
-        QVariantDictMap new_settings = createConnectionSettings(m_ssid,
-                                                                m_password,
-                                                                m_mode, m_auth);
-        auto updating = m_hotspot->Update(new_settings);
-        updating.waitForFinished();
-        if (!updating.isValid())
+        // Until getprop answers we cannot tell which device to use
+        if (m_step != EnableStep::device || !m_tetherInterfaceKnown)
         {
-            qCritical()
-                    << "Could not update connection:"
-                    << updating.error().message();
+            return;
         }
+
+        qDebug() << "Searching for AP device";
+        int attempt = m_attempt;
+        findApDevice([this, attempt](const QStringList& unavailable)
+        {
+            if (attempt != m_attempt || m_step != EnableStep::device)
+            {
+                return;
+            }
+
+            if (!m_device)
+            {
+                // Wait for the candidate devices to become available
+                for (const auto& path : unavailable)
+                {
+                    if (m_watchedDevices.contains(path))
+                    {
+                        continue;
+                    }
+                    auto device = make_shared<OrgFreedesktopNetworkManagerDeviceInterface>(
+                            NM_DBUS_SERVICE, path, m_manager->connection());
+                    connect(device.get(), &OrgFreedesktopNetworkManagerDeviceInterface::StateChanged,
+                            this, &Priv::checkApDevice);
+                    m_watchedDevices[path] = device;
+                }
+                return;
+            }
+
+            stopWaiting();
+            storeConnection();
+        });
     }
 
-    bool activateConnection(const QDBusObjectPath& device)
+    void storeConnection()
     {
-        auto activeConnectionObject = m_activeConnectionManager->activate(QDBusObjectPath(m_hotspot->path()), device);
-        if (!activeConnectionObject)
+        m_step = EnableStep::connection;
+        int attempt = m_attempt;
+
+        auto done = [this, attempt](bool success)
         {
-            qCritical() << "Could not activate hotspot connection";
-            return false;
-        }
+            if (attempt != m_attempt)
+            {
+                return;
+            }
 
-        OrgFreedesktopNetworkManagerConnectionActiveInterface activeConnection (
-                    NM_DBUS_SERVICE, activeConnectionObject->path().path (),
-                    m_manager->connection());
+            if (!success || !m_hotspot)
+            {
+                qWarning() << "Could not find a hotspot setup to enable";
+                finishEnable(false);
+                return;
+            }
 
-        int count = 0;
-        // Wait for connection to activate
-        while (count < 20 && activeConnection.state() != NM_ACTIVE_CONNECTION_STATE_ACTIVATED)
+            qDebug() << "Activating hotspot on device" << m_device->m_path.path();
+            activateConnection(m_device->m_path, [this](bool success)
+            {
+                finishEnable(success);
+            });
+        };
+
+        if (m_stored)
+        {
+            updateConnection(done);
+        }
+        else
         {
-            qDebug() << "Waiting for hotspot to connect";
-            QThread::msleep(100);
-            ++count;
+            addConnection(done);
         }
+    }
 
-        return (activeConnection.state() == NM_ACTIVE_CONNECTION_STATE_ACTIVATED);
+    void timedOut()
+    {
+        switch (m_step)
+        {
+            case EnableStep::device:
+                qWarning() << "Failed to create AP device";
+                cancelEnable();
+                Q_EMIT p.reportError(1);
+                setDisconnectWifi(false);
+                break;
+            case EnableStep::activation:
+                qWarning() << "Timed out waiting for hotspot to connect";
+                activationFinished(false);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void addConnection(function<void(bool)> done)
+    {
+        qDebug() << "Adding new hotspot connection";
+        QVariantDictMap connection = createConnectionSettings(m_ssid, m_password,
+                                                              m_mode, m_auth);
+
+        auto watcher(new QDBusPendingCallWatcher(m_settings->AddConnection(connection), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [this, done](QDBusPendingCallWatcher *call)
+                {
+                    call->deleteLater();
+
+                    QDBusPendingReply<QDBusObjectPath> reply = *call;
+                    if (reply.isError())
+                    {
+                        qCritical() << "Failed to add connection: "
+                                << reply.error().message();
+                        Q_EMIT p.reportError(0);
+                        m_hotspot.reset();
+
+                        setStored(false);
+                        done(false);
+                        return;
+                    }
+
+                    QDBusObjectPath connectionPath(reply);
+
+                    m_hotspot = make_shared<
+                            OrgFreedesktopNetworkManagerSettingsConnectionInterface>(
+                            NM_DBUS_SERVICE, connectionPath.path(), m_manager->connection());
+
+                    setStored(true);
+                    done(true);
+                });
+    }
+
+    void updateConnection(function<void(bool)> done)
+    {
+        qDebug() << "Updating hotspot connection";
+        // Get new settings
+        QVariantDictMap new_settings = createConnectionSettings(m_ssid,
+                                                                m_password,
+                                                                m_mode, m_auth);
+        auto watcher(new QDBusPendingCallWatcher(m_hotspot->Update(new_settings), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [done](QDBusPendingCallWatcher *call)
+                {
+                    call->deleteLater();
+                    if (call->isError())
+                    {
+                        qCritical()
+                                << "Could not update connection:"
+                                << call->error().message();
+                    }
+                    // Activate whatever is stored, as before
+                    done(true);
+                });
     }
 
     /**
-     * Enables a hotspot.
+     * Activates the hotspot connection and waits for NetworkManager to
+     * report it as activated, or for the timeout. done is called with
+     * the outcome.
      */
-    void enable(const QDBusObjectPath& device)
+    void activateConnection(const QDBusObjectPath& device, function<void(bool)> done)
     {
-        if (!m_hotspot)
-        {
-            qWarning() << "Could not find a hotspot setup to enable";
-            return;
-        }
+        m_step = EnableStep::activation;
+        m_activationDone = done;
+        int attempt = m_attempt;
 
-        qDebug() << "Activating hotspot on device" << device.path();
-        bool success = activateConnection(device);
-        setEnable(success);
-        if (success)
+        auto pending = m_activeConnectionManager->activateAsync(QDBusObjectPath(m_hotspot->path()), device);
+        connect(pending.get(), &connection::PendingActiveConnection::finished, this,
+                [this, attempt](connection::ActiveConnection::SPtr activeConnection)
+                {
+                    if (attempt != m_attempt)
+                    {
+                        return;
+                    }
+
+                    if (!activeConnection)
+                    {
+                        qCritical() << "Could not activate hotspot connection";
+                        activationFinished(false);
+                        return;
+                    }
+
+                    if (activeConnection->state() == connection::ActiveConnection::State::activated)
+                    {
+                        activationFinished(true);
+                        return;
+                    }
+
+                    qDebug() << "Waiting for hotspot to connect";
+                    m_timeout.start();
+                    m_activationStateConnection = connect(activeConnection.get(),
+                            &connection::ActiveConnection::stateChanged, this,
+                            [this](connection::ActiveConnection::State state)
+                            {
+                                if (state == connection::ActiveConnection::State::activated)
+                                {
+                                    activationFinished(true);
+                                }
+                            });
+                });
+    }
+
+    void activationFinished(bool success)
+    {
+        auto done = m_activationDone;
+        m_activationDone = function<void(bool)>();
+        m_step = EnableStep::idle;
+        stopWaiting();
+        if (done)
         {
-            // If our connection gets booted, reconnect
-            connect(m_activeConnectionManager.get(),
-                    &connection::ActiveConnectionManager::connectionsUpdated, this,
-                    &Priv::reactivateConnection,
-                    Qt::QueuedConnection);
+            done(success);
         }
     }
 
@@ -160,6 +390,8 @@ public:
      */
     void disable()
     {
+        cancelEnable();
+
         disconnect(m_activeConnectionManager.get(),
                    &connection::ActiveConnectionManager::connectionsUpdated,
                    this, &Priv::reactivateConnection);
@@ -167,7 +399,7 @@ public:
         auto activeConnection = getActiveConnection();
         if (activeConnection)
         {
-            m_activeConnectionManager->deactivate(activeConnection);
+            m_activeConnectionManager->deactivateAsync(activeConnection);
         }
 
         setInterfaceFirmware("/", "sta");
@@ -244,109 +476,212 @@ public:
 
     // wpa_supplicant interaction
 
-    QString getTetheringInterface()
+    /**
+     * Calls done once the tethering interface is known. getprop is only
+     * run the first time, the property does not change while we run.
+     */
+    void withTetheringInterface(function<void()> done)
     {
-        QString program("getprop");
-        QStringList arguments;
-        arguments << "wifi.tethering.interface";
-
-        QProcess getprop;
-        getprop.start(program, arguments);
+        if (m_tetherInterfaceKnown)
+        {
+            done();
+            return;
+        }
 
-        if (!getprop.waitForFinished())
+        m_tetherInterfaceWaiters.append(done);
+        if (m_getprop)
         {
-            qCritical() << "getprop process failed:" << getprop.errorString();
-            return QString();
+            // Already asked
+            return;
         }
 
-        QString output = getprop.readAllStandardOutput();
+        m_getprop = new QProcess(this);
+        connect(m_getprop,
+                static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+                this, &Priv::getpropFinished);
+        connect(m_getprop,
+                static_cast<void (QProcess::*)(QProcess::ProcessError)>(&QProcess::error),
+                this, &Priv::getpropFailed);
+        m_getprop->start("getprop", QStringList{"wifi.tethering.interface"});
+    }
+
+    void getpropFinished()
+    {
+        QString output = m_getprop->readAllStandardOutput();
         // Take just the first line
-        return output.split("\n").first();
+        setTetheringInterface(output.split("\n").first());
+    }
+
+    void getpropFailed(QProcess::ProcessError error)
+    {
+        // Anything else is followed by finished
+        if (error == QProcess::FailedToStart)
+        {
+            qCritical() << "getprop process failed:" << m_getprop->errorString();
+            setTetheringInterface(QString());
+        }
+    }
+
+    void setTetheringInterface(const QString& interface)
+    {
+        m_getprop->deleteLater();
+        m_getprop = nullptr;
+
+        m_tetherInterface = interface;
+        m_tetherInterfaceKnown = true;
+
+        auto waiters = m_tetherInterfaceWaiters;
+        m_tetherInterfaceWaiters.clear();
+        for (const auto& done : waiters)
+        {
+            done();
+        }
     }
 
     /**
-     * True if changed successfully, or there was no need. Otherwise false.
+     * Asynchronously changes the interface firmware. done is called with
+     * true if changed successfully, or there was no need. Otherwise false.
      * Supported modes are 'p2p', 'sta' and 'ap'.
      */
-    bool setInterfaceFirmware(const QString& interface, const QString& mode)
+    void setInterfaceFirmware(const QString& interface, const QString& mode,
+                              function<void(bool)> done = function<void(bool)>())
     {
         // Not supported.
         if (mode == "adhoc")
         {
-            return true;
+            if (done)
+            {
+                done(true);
+            }
+            return;
         }
 
-        QDBusInterface wpasIface(DBusTypes::WPASUPPLICANT_DBUS_NAME,
-                                 DBusTypes::WPASUPPLICANT_DBUS_PATH,
-                                 DBusTypes::WPASUPPLICANT_DBUS_INTERFACE,
-                                 m_manager->connection());
+        auto message = QDBusMessage::createMethodCall(
+                DBusTypes::WPASUPPLICANT_DBUS_NAME,
+                DBusTypes::WPASUPPLICANT_DBUS_PATH,
+                DBusTypes::WPASUPPLICANT_DBUS_INTERFACE,
+                "SetInterfaceFirmware");
+        message << QVariant::fromValue(QDBusObjectPath(interface)) << QVariant(mode);
 
-        auto set_interface = wpasIface.call(
-                "SetInterfaceFirmware", QVariant::fromValue(QDBusObjectPath(interface)),
-                QVariant(mode));
+        auto watcher(new QDBusPendingCallWatcher(m_manager->connection().asyncCall(message), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [done](QDBusPendingCallWatcher *call)
+                {
+                    call->deleteLater();
+                    if (call->isError())
+                    {
+                        qCritical() << "Failed to change interface firmware:"
+                                << call->error().message();
+                    }
+                    if (done)
+                    {
+                        done(!call->isError());
+                    }
+                });
+    }
 
-        if (set_interface.type() == QDBusMessage::ErrorMessage)
-        {
-            qCritical() << "Failed to change interface firmware:"
-                    << set_interface.errorMessage();
-            return false;
-        }
+    /**
+     * Looks for a usable AP device, fetching the device list and each
+     * device's properties asynchronously. done is called with the Wi-Fi
+     * devices on the tethering interface that are not available yet, and
+     * m_device set if one was found. Only the latest search completes.
+     */
+    void findApDevice(function<void(const QStringList&)> done)
+    {
+        int search = ++m_deviceSearch;
 
-        return true;
+        auto watcher(new QDBusPendingCallWatcher(m_manager->GetDevices(), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [this, search, done](QDBusPendingCallWatcher *call)
+                {
+                    call->deleteLater();
+                    if (search != m_deviceSearch)
+                    {
+                        return;
+                    }
+
+                    QDBusPendingReply<QList<QDBusObjectPath>> reply = *call;
+                    if (reply.isError())
+                    {
+                        qWarning() << "Failed to list devices:" << reply.error().message();
+                        m_device.reset();
+                        done(QStringList());
+                        return;
+                    }
+
+                    auto probe = make_shared<DeviceProbe>();
+                    probe->m_paths = reply.value();
+                    probe->m_properties.resize(probe->m_paths.size());
+                    probe->m_outstanding = probe->m_paths.size();
+                    if (probe->m_outstanding == 0)
+                    {
+                        chooseApDevice(*probe, done);
+                        return;
+                    }
+
+                    for (int i = 0; i < probe->m_paths.size(); ++i)
+                    {
+                        OrgFreedesktopDBusPropertiesInterface properties(
+                                NM_DBUS_SERVICE, probe->m_paths[i].path(),
+                                m_manager->connection());
+                        auto watcher(new QDBusPendingCallWatcher(
+                                properties.GetAll(NM_DBUS_INTERFACE_DEVICE), this));
+                        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                                [this, search, probe, i, done](QDBusPendingCallWatcher *call)
+                                {
+                                    call->deleteLater();
+
+                                    QDBusPendingReply<QVariantMap> reply = *call;
+                                    if (!reply.isError())
+                                    {
+                                        probe->m_properties[i] = reply.value();
+                                    }
+
+                                    if (--probe->m_outstanding == 0 && search == m_deviceSearch)
+                                    {
+                                        chooseApDevice(*probe, done);
+                                    }
+                                });
+                    }
+                });
     }
 
-    void findApDevice()
+    void chooseApDevice(const DeviceProbe& probe, function<void(const QStringList&)> done)
     {
-        m_device.release();
-        QString tetherIface = getTetheringInterface();
+        m_device.reset();
+        QStringList unavailable;
 
-        auto devices = QList<QDBusObjectPath>(m_manager->GetDevices()).toStdList();
-        // Iterate in reverse to attempt to minimise dbus calls (new device is likely at the end)
-        for (auto path = devices.rbegin(); path != devices.rend(); ++path)
+        // Prefer the most recently added device
+        for (int i = probe.m_paths.size() - 1; i >= 0; --i)
         {
-            OrgFreedesktopNetworkManagerDeviceInterface device(NM_DBUS_SERVICE, path->path(), m_manager->connection());
-
-            QString interface = device.interface();
+            const auto& properties = probe.m_properties[i];
+            QString interface = properties.value("Interface").toString();
 
-            if (!tetherIface.isEmpty())
+            if (!m_tetherInterface.isEmpty())
             {
-                if (tetherIface.compare(interface) != 0)
+                if (m_tetherInterface.compare(interface) != 0)
                 {
                     continue;
                 }
             }
 
-            if (device.deviceType() != NM_DEVICE_TYPE_WIFI)
+            if (properties.value("DeviceType").toUInt() != NM_DEVICE_TYPE_WIFI)
             {
                 continue;
             }
 
-            if (device.state() <= NM_DEVICE_STATE_UNAVAILABLE)
+            if (properties.value("State").toUInt() <= NM_DEVICE_STATE_UNAVAILABLE)
             {
+                unavailable.append(probe.m_paths[i].path());
                 continue;
             }
 
             qDebug() << "Using AP interface " << interface;
-            m_device = make_unique<ApDevice>(*path, interface);
+            m_device = make_unique<ApDevice>(probe.m_paths[i], interface);
             break;
         }
-    }
-
-    void createApDevice()
-    {
-        setInterfaceFirmware("/", m_mode);
-
-        m_device.release();
 
-        int count = 0;
-        // Wait for AP device to appear
-        while (count < 20 && !m_device)
-        {
-            QThread::msleep(100);
-            findApDevice();
-            qDebug() << "Searching for AP device";
-            ++count;
-        }
+        done(unavailable);
     }
 
     // wpa_supplicant interaction
@@ -551,17 +886,45 @@ public Q_SLOTS:
         }
 
 
-        findApDevice();
-
-        if (m_device)
+        if (enabling())
         {
-            qDebug() << "Reactivating hotspot connection on device" << m_device->m_path.path();
-            activateConnection(m_device->m_path);
+            return;
         }
-        else
+
+        int attempt = ++m_attempt;
+        withTetheringInterface([this, attempt]()
         {
-            qWarning() << "Could not get device when reactivating hotspot connection";
-        }
+            if (attempt != m_attempt)
+            {
+                return;
+            }
+
+            findApDevice([this, attempt](const QStringList&)
+            {
+                // Disabled, or put back by someone else, meanwhile
+                if (attempt != m_attempt || enabling() || !m_hotspot
+                        || getActiveConnection())
+                {
+                    return;
+                }
+
+                if (m_device)
+                {
+                    qDebug() << "Reactivating hotspot connection on device" << m_device->m_path.path();
+                    activateConnection(m_device->m_path, [](bool success)
+                    {
+                        if (!success)
+                        {
+                            qWarning() << "Could not reactivate hotspot connection";
+                        }
+                    });
+                }
+                else
+                {
+                    qWarning() << "Could not get device when reactivating hotspot connection";
+                }
+            });
+        });
     }
 
 public:
@@ -576,6 +939,33 @@ public:
 
     unique_ptr<ApDevice> m_device;
 
+    EnableStep m_step = EnableStep::idle;
+
+    // Incremented whenever an enable is started or abandoned, so that
+    // replies belonging to a stale attempt can be ignored.
+    int m_attempt = 0;
+
+    QTimer m_timeout;
+
+    // Incremented for every AP device search, only the latest completes
+    int m_deviceSearch = 0;
+
+    QString m_tetherInterface;
+
+    bool m_tetherInterfaceKnown = false;
+
+    QProcess* m_getprop = nullptr;
+
+    QList<function<void()>> m_tetherInterfaceWaiters;
+
+    QMetaObject::Connection m_deviceAddedConnection;
+
+    QMetaObject::Connection m_activationStateConnection;
+
+    function<void(bool)> m_activationDone;
+
+    QMap<QString, shared_ptr<OrgFreedesktopNetworkManagerDeviceInterface>> m_watchedDevices;
+
     QPowerd::UPtr m_powerd;
     QPowerd::RequestSPtr m_wakelock;
 
@@ -632,7 +1022,7 @@ HotspotManager::HotspotManager(connection::ActiveConnectionManager::SPtr activeC
 
 void HotspotManager::setEnabled(bool value)
 {
-    if (enabled() == value)
+    if (enabled() == value && !d->enabling())
     {
         return;
     }
@@ -640,6 +1030,12 @@ void HotspotManager::setEnabled(bool value)
     // We are enabling a hotspot
     if (value)
     {
+        if (d->enabling())
+        {
+            // Already on its way
+            return;
+        }
+
         // If the SSID is empty, we report an error.
         if (d->m_ssid.isEmpty())
         {
@@ -651,26 +1047,9 @@ void HotspotManager::setEnabled(bool value)
 
         d->setDisconnectWifi(true);
 
-        // We use Hybris to load the new device firmware
-        d->createApDevice();
-
-        if (!d->m_device)
-        {
-            qWarning() << "Failed to create AP device";
-            Q_EMIT reportError(1);
-            d->setDisconnectWifi(false);
-            return;
-        }
-
-        if (d->m_stored)
-        {
-            d->updateConnection();
-        }
-        else
-        {
-            d->addConnection();
-        }
-        d->enable(d->m_device->m_path);
+        // Firmware change, AP device, connection and activation follow
+        // asynchronously.
+        d->startEnable();
     }
     else
     {
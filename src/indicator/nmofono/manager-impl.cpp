@@ -21,8 +21,10 @@
 #include <nmofono/manager-impl.h>
 #include <nmofono/connectivity-service-settings.h>
 #include <nmofono/ethernet/ethernet-link.h>
+#include <nmofono/wifi/wifi-connection-index.h>
 #include <nmofono/wifi/wifi-link-impl.h>
 #include <nmofono/wifi/wifi-toggle.h>
+#include <nmofono/wwan/sim-index.h>
 #include <nmofono/wwan/sim-manager.h>
 #include <NetworkManagerInterface.h>
 
@@ -62,6 +64,7 @@ public:
     shared_ptr<OrgFreedesktopNetworkManagerSettingsInterface> m_settingsInterface;
     shared_ptr<QOfonoManager> m_ofono;
     connection::ActiveConnectionManager::SPtr m_activeConnectionManager;
+    wifi::WifiConnectionIndex::SPtr m_wifiConnectionIndex;
 
     bool m_unstoppableOperationHappening = false;
     Manager::NetworkingStatus m_status = NetworkingStatus::offline;
@@ -90,14 +93,20 @@ public:
     bool m_simForMobileDataPending = false;
 
     QList<wwan::Modem::Ptr> m_modems;
-    QList<wwan::Sim::Ptr> m_sims;
+
+    // Paths of the modems in m_modems
+    QSet<QString> m_readyModemPaths;
 
     wwan::SimManager::Ptr m_simManager;
 
+    wwan::SimIndex::Ptr m_simIndex;
+
     ConnectivityServiceSettings::Ptr m_settings;
 
     QTimer m_checkSimForMobileDataTimer;
 
+    DataUsageLedger::SPtr m_dataUsageLedger;
+
     NMDeviceStatisticsMonitor::Ptr m_statisticsMonitor;
 
     Private(Manager& parent) :
@@ -120,62 +129,51 @@ public Q_SLOTS:
             return;
         }
 
+        // Only present SIMs can be in a ready modem, so there is no need
+        // to look at every modem
+        wwan::Sim::Ptr onlySim;
         int presentSimCount = 0;
-        for (auto modem : m_modems)
+        for (auto sim : m_simIndex->presentSims())
         {
-            if (modem->sim())
+            if (m_readyModemPaths.contains(m_simIndex->modemForSim(sim->iccid())))
             {
+                onlySim = sim;
                 presentSimCount++;
             }
         }
 
         if (presentSimCount == 1)
         {
-            for (auto modem : m_modems)
-            {
-                if (modem->sim())
-                {
-                    setSimForMobileData(modem->sim());
-                    break;
-                }
-            }
+            setSimForMobileData(onlySim);
         }
     }
 
-    void matchModemsAndSims()
+    void attachSim(wwan::Modem::Ptr modem)
     {
-        for (wwan::Modem::Ptr modem: m_ofonoLinks)
-        {
-            bool match = false;
-            for(wwan::Sim::Ptr sim : m_sims)
-            {
-                if (sim->ofonoPath() == modem->ofonoPath())
-                {
-                    match = true;
-                    modem->setSim(sim);
+        auto sim = m_simIndex->simForModem(modem->ofonoPath());
+        modem->setSim(sim);
 
-                    if (m_mobileDataEnabledPending || m_simForMobileDataPending)
-                    {
-                        connect(modem->sim().get(), &wwan::Sim::initialDataOnSet, this, &Private::initialDataOnSet);
-                        if (modem->sim()->initialDataOn())
-                        {
-                            modem->sim()->initialDataOnSet();
-                        }
-                    }
-                    break;
-                }
-            }
-            if (!match)
+        if (sim && (m_mobileDataEnabledPending || m_simForMobileDataPending))
+        {
+            connect(sim.get(), &wwan::Sim::initialDataOnSet, this, &Private::initialDataOnSet, Qt::UniqueConnection);
+            if (sim->initialDataOn())
             {
-                modem->setSim(wwan::Sim::Ptr());
+                sim->initialDataOnSet();
             }
         }
     }
 
+    void simForModemChanged(const QString& modemPath)
+    {
+        auto modem = m_ofonoLinks.value(modemPath);
+        if (modem)
+        {
+            attachSim(modem);
+        }
+    }
+
     void simAdded(wwan::Sim::Ptr sim)
     {
-        m_sims.append(sim);
-        connect(sim.get(), &wwan::Sim::presentChanged, this, &Private::matchModemsAndSims);
         connect(sim.get(), &wwan::Sim::presentChanged, this, &Private::startCheckSimForMobileDataTimer);
         Q_EMIT p.simsChanged();
 
@@ -187,7 +185,7 @@ public Q_SLOTS:
             }
         }
 
-        matchModemsAndSims();
+        // The index has already told us which modem it is in
         m_checkSimForMobileDataTimer.start();
     }
 
@@ -224,10 +222,11 @@ public Q_SLOTS:
         auto modem = m_ofonoLinks[modem_raw->name()];
         if (!modem->sim())
         {
-            matchModemsAndSims();
+            attachSim(modem);
         }
 
         m_modems.append(modem);
+        m_readyModemPaths.insert(modem->ofonoPath());
         Q_EMIT p.modemsChanged();
 
         m_checkSimForMobileDataTimer.start();
@@ -275,16 +274,16 @@ public Q_SLOTS:
         }
         else
         {
-            QString iccid = ret.toString();
-            wwan::Sim::Ptr sim;
-            for(auto i = m_sims.begin(); i != m_sims.end(); i++)
+            setSimForMobileData(m_simIndex->sim(ret.toString()));
+        }
+
+        // SIMs that were already attached need watching for their initial data state
+        if (m_mobileDataEnabledPending || m_simForMobileDataPending)
+        {
+            for (auto modem : m_ofonoLinks)
             {
-                if ((*i)->iccid() == iccid) {
-                    sim = *i;
-                    break;
-                }
+                attachSim(modem);
             }
-            setSimForMobileData(sim);
         }
     }
 
@@ -369,6 +368,7 @@ public Q_SLOTS:
                 disconnect(modem.get(), &wwan::Modem::readyToUnlock, this, &Private::modemReadyToUnlock);
             }
             m_modems.removeAll(modem);
+            m_readyModemPaths.remove(path);
             Q_EMIT p.modemsChanged();
         }
 
@@ -384,6 +384,7 @@ public Q_SLOTS:
             m_ofonoLinks[path] = modem;
             connect(modem.get(), &wwan::Modem::readyToUnlock, this, &Private::modemReadyToUnlock);
             connect(modem.get(), &wwan::Modem::ready, this, &Private::modemReady);
+            attachSim(modem);
 
             for (const auto &nmobjpath : m_nmDevices)
             {
@@ -506,21 +507,25 @@ ManagerImpl::ManagerImpl(notify::NotificationManager::SPtr notificationManager,
                          wifi::WifiToggle::SPtr wifiToggle,
                          HotspotManager::SPtr hotspotManager,
                          connection::ActiveConnectionManager::SPtr activeConnectionManager,
-                         const QDBusConnection& systemConnection) :
+                         const QDBusConnection& systemConnection,
+                         ObjectSnapshot::SPtr snapshot) :
         d(new ManagerImpl::Private(*this))
 {
     d->m_nm = make_shared<OrgFreedesktopNetworkManagerInterface>(NM_DBUS_SERVICE, NM_DBUS_PATH, systemConnection);
     d->m_settingsInterface = make_shared<OrgFreedesktopNetworkManagerSettingsInterface>(
                     NM_DBUS_SERVICE, NM_DBUS_PATH_SETTINGS, systemConnection);
     d->m_activeConnectionManager = activeConnectionManager;
+    d->m_wifiConnectionIndex = make_shared<wifi::WifiConnectionIndex>(d->m_settingsInterface);
 
     d->m_unlockDialog = make_shared<SimUnlockDialog>(notificationManager);
     connect(d->m_unlockDialog.get(), &SimUnlockDialog::ready, d.get(), &Private::sim_unlock_ready);
 
-    d->m_statisticsMonitor = make_shared<NMDeviceStatisticsMonitor>();
+    d->m_dataUsageLedger = make_shared<DataUsageLedger>();
+    d->m_statisticsMonitor = make_shared<NMDeviceStatisticsMonitor>(d->m_dataUsageLedger);
 
     connect(d->m_statisticsMonitor.get(), &NMDeviceStatisticsMonitor::txChanged, this, &ManagerImpl::txChanged);
     connect(d->m_statisticsMonitor.get(), &NMDeviceStatisticsMonitor::rxChanged, this, &ManagerImpl::rxChanged);
+    connect(d->m_statisticsMonitor.get(), &NMDeviceStatisticsMonitor::throughputChanged, this, &ManagerImpl::throughputChanged);
 
 
     d->m_ofono = make_shared<QOfonoManager>();
@@ -529,11 +534,8 @@ ManagerImpl::ManagerImpl(notify::NotificationManager::SPtr notificationManager,
     d->m_settings = make_shared<ConnectivityServiceSettings>();
     d->m_simManager = make_shared<wwan::SimManager>(d->m_ofono, d->m_settings);
     connect(d->m_simManager.get(), &wwan::SimManager::simAdded, d.get(), &Private::simAdded);
-    d->m_sims = d->m_simManager->knownSims();
-    for (auto sim : d->m_sims)
-    {
-        connect(sim.get(), &wwan::Sim::presentChanged, d.get(), &Private::matchModemsAndSims);
-    }
+    d->m_simIndex = d->m_simManager->index();
+    connect(d->m_simIndex.get(), &wwan::SimIndex::simForModemChanged, d.get(), &Private::simForModemChanged);
 
     connect(d->m_ofono.get(), &QOfonoManager::modemsChanged, d.get(), &Private::modems_changed);
     d->modems_changed(d->m_ofono->modems());
@@ -556,13 +558,46 @@ ManagerImpl::ManagerImpl(notify::NotificationManager::SPtr notificationManager,
     connect(d->m_hotspotManager.get(), &HotspotManager::reportError, this, &Manager::reportError);
 
     connect(d->m_nm.get(), &OrgFreedesktopNetworkManagerInterface::DeviceAdded, this, &ManagerImpl::device_added);
-    QList<QDBusObjectPath> devices = d->m_nm->GetDevices();
-    for(const auto &path : devices) {
-        device_added(path);
+    QDBusObjectPath nmPath(NM_DBUS_PATH);
+    if (snapshot && snapshot->contains(nmPath, NM_DBUS_INTERFACE))
+    {
+        auto nmProperties = snapshot->properties(nmPath, NM_DBUS_INTERFACE);
+        for (const auto &path : ObjectSnapshot::pathList(nmProperties.value("Devices")))
+        {
+            addDevice(path, snapshot);
+        }
+
+        connect(d->m_nm.get(), &OrgFreedesktopNetworkManagerInterface::DeviceRemoved, this, &ManagerImpl::device_removed);
+        updateNetworkingStatus(nmProperties.value("State").toUInt());
+
+        // Pick up any device that appeared between taking the snapshot and
+        // connecting to DeviceAdded. Known devices are skipped.
+        auto watcher(new QDBusPendingCallWatcher(d->m_nm->GetDevices(), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher* call)
+        {
+            call->deleteLater();
+            QDBusPendingReply<QList<QDBusObjectPath>> reply = *call;
+            if (reply.isError())
+            {
+                qWarning() << "Failed to get devices:" << reply.error().message();
+                return;
+            }
+            for (const auto &path : reply.value())
+            {
+                device_added(path);
+            }
+        });
     }
+    else
+    {
+        QList<QDBusObjectPath> devices = d->m_nm->GetDevices();
+        for(const auto &path : devices) {
+            device_added(path);
+        }
 
-    connect(d->m_nm.get(), &OrgFreedesktopNetworkManagerInterface::DeviceRemoved, this, &ManagerImpl::device_removed);
-    updateNetworkingStatus(d->m_nm->state());
+        connect(d->m_nm.get(), &OrgFreedesktopNetworkManagerInterface::DeviceRemoved, this, &ManagerImpl::device_removed);
+        updateNetworkingStatus(d->m_nm->state());
+    }
     connect(d->m_nm.get(), &OrgFreedesktopNetworkManagerInterface::PropertiesChanged, this, &ManagerImpl::nm_properties_changed);
 
     /// @todo set by the default connections.
@@ -575,7 +610,7 @@ ManagerImpl::ManagerImpl(notify::NotificationManager::SPtr notificationManager,
     d->m_checkSimForMobileDataTimer.setInterval(5000);
     d->m_checkSimForMobileDataTimer.setSingleShot(true);
     connect(&d->m_checkSimForMobileDataTimer, &QTimer::timeout, d.get(), &Private::checkSimForMobileData);
-    for(auto sim : d->m_sims) {
+    for(auto sim : d->m_simIndex->sims()) {
         connect(sim.get(), &wwan::Sim::presentChanged, d.get(), &Private::startCheckSimForMobileDataTimer);
     }
     d->m_checkSimForMobileDataTimer.start();    
@@ -728,31 +763,61 @@ ManagerImpl::device_removed(const QDBusObjectPath &path)
 void
 ManagerImpl::device_added(const QDBusObjectPath &path)
 {
-    qDebug() << "Device Added:" << path.path();
-
-    d->m_nmDevices.append(path);
+    addDevice(path, ObjectSnapshot::SPtr());
+}
 
-    for (const auto &dev : d->m_nmLinks)
+void
+ManagerImpl::addDevice(const QDBusObjectPath &path, ObjectSnapshot::SPtr snapshot)
+{
+    if (d->m_nmDevices.contains(path))
     {
-        auto wifiLink = dynamic_pointer_cast<wifi::WifiLinkImpl>(dev);
-        if (wifiLink && wifiLink->device_path() == path) {
-            // already in the list
-            return;
-        }
+        // already in the list
+        return;
     }
 
+    qDebug() << "Device Added:" << path.path();
+
+    d->m_nmDevices.append(path);
+
     Link::SPtr link;
     try {
         auto dev = make_shared<OrgFreedesktopNetworkManagerDeviceInterface>(
             NM_DBUS_SERVICE, path.path(), d->m_nm->connection());
-        switch (dev->deviceType())
+
+        uint deviceType;
+        QString driver;
+        QString udi;
+        if (snapshot && snapshot->contains(path, NM_DBUS_INTERFACE_DEVICE))
+        {
+            auto properties = snapshot->properties(path, NM_DBUS_INTERFACE_DEVICE);
+            deviceType = properties.value("DeviceType").toUInt();
+            driver = properties.value("Driver").toString();
+            udi = properties.value("Udi").toString();
+        }
+        else
+        {
+            snapshot.reset();
+            deviceType = dev->deviceType();
+        }
+
+        switch (deviceType)
         {
             case NM_DEVICE_TYPE_WIFI:
             {
-                wifi::WifiLink::SPtr tmp = make_shared<wifi::WifiLinkImpl>(dev,
+                auto wifiLink = make_shared<wifi::WifiLinkImpl>(dev,
                                                     d->m_nm,
                                                     d->m_wifiToggle,
-                                                    d->m_activeConnectionManager);
+                                                    d->m_activeConnectionManager,
+                                                    d->m_wifiConnectionIndex,
+                                                    snapshot);
+
+                auto debounce = d->m_settings->wifiScanDebounce();
+                auto maxLatency = d->m_settings->wifiScanMaxLatency();
+                wifiLink->setScanDebounce(
+                        debounce.isNull() ? wifi::WifiLinkImpl::DEFAULT_SCAN_DEBOUNCE_MS : debounce.toInt(),
+                        maxLatency.isNull() ? wifi::WifiLinkImpl::DEFAULT_SCAN_MAX_LATENCY_MS : maxLatency.toInt());
+
+                wifi::WifiLink::SPtr tmp = wifiLink;
 
                 // We're not interested in showing access points
                 if (tmp->name() != d->m_hotspotManager->interface())
@@ -773,11 +838,16 @@ ManagerImpl::device_added(const QDBusObjectPath &path)
             }
             case NM_DEVICE_TYPE_MODEM:
             {
-                if (dev->driver() == "ofono")
+                if (!snapshot)
+                {
+                    driver = dev->driver();
+                    udi = dev->udi();
+                }
+                if (driver == "ofono")
                 {
                     for (const auto &modem : d->m_ofonoLinks)
                     {
-                        if (modem->ofonoPath() == dev->udi())
+                        if (modem->ofonoPath() == udi)
                         {
                             modem->setNmPath(path.path());
                             d->m_statisticsMonitor->addLink(modem);
@@ -1039,7 +1109,7 @@ ManagerImpl::modems() const
 QList<wwan::Sim::Ptr>
 ManagerImpl::sims() const
 {
-    return d->m_sims;
+    return d->m_simIndex->sims();
 }
 
 bool
@@ -1054,6 +1124,58 @@ ManagerImpl::rx() const
     return d->m_statisticsMonitor->rx();
 }
 
+QMap<QString, Throughput>
+ManagerImpl::throughput() const
+{
+    return d->m_statisticsMonitor->throughput();
+}
+
+QMap<QString, DataUsage>
+ManagerImpl::dataUsage(qint64 sinceDay) const
+{
+    return d->m_dataUsageLedger->totals(sinceDay);
+}
+
+quint64
+ManagerImpl::accessPointUpdatesCoalesced() const
+{
+    quint64 count = 0;
+    for (const auto& link : d->m_nmLinks)
+    {
+        if (auto wifiLink = dynamic_pointer_cast<wifi::WifiLinkImpl>(link))
+        {
+            count += wifiLink->coalescedUpdates();
+        }
+    }
+    return count;
+}
+
+quint64
+ManagerImpl::accessPointUpdatesEmitted() const
+{
+    quint64 count = 0;
+    for (const auto& link : d->m_nmLinks)
+    {
+        if (auto wifiLink = dynamic_pointer_cast<wifi::WifiLinkImpl>(link))
+        {
+            count += wifiLink->emittedUpdates();
+        }
+    }
+    return count;
+}
+
+quint64
+ManagerImpl::statisticsSignalCount() const
+{
+    return d->m_statisticsMonitor->signalCount();
+}
+
+void
+ManagerImpl::setStatisticsRefreshRate(const QString& linkName, uint refreshRateMs)
+{
+    d->m_statisticsMonitor->setRefreshRateOverride(linkName, refreshRateMs);
+}
+
 
 }
 
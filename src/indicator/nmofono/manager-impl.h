@@ -23,6 +23,7 @@
 #include <nmofono/manager.h>
 #include <nmofono/hotspot-manager.h>
 #include <nmofono/flight-mode-toggle.h>
+#include <nmofono/object-snapshot.h>
 #include <nmofono/wifi/wifi-toggle.h>
 
 #include <QDBusConnection>
@@ -47,6 +48,8 @@ Q_OBJECT
 
     void updateNetworkingStatus(uint state);
 
+    void addDevice(const QDBusObjectPath &path, ObjectSnapshot::SPtr snapshot);
+
 public:
     typedef std::shared_ptr<ManagerImpl> Ptr;
 
@@ -56,7 +59,8 @@ public:
             wifi::WifiToggle::SPtr wifiToggle,
             HotspotManager::SPtr hotspotManager,
             connection::ActiveConnectionManager::SPtr activeConnectionManager,
-            const QDBusConnection& systemBus);
+            const QDBusConnection& systemBus,
+            ObjectSnapshot::SPtr snapshot = ObjectSnapshot::SPtr());
 
     // Public API
     void setFlightMode(bool) override;
@@ -110,6 +114,18 @@ public:
 
     bool rx() const override;
 
+    QMap<QString, Throughput> throughput() const override;
+
+    QMap<QString, DataUsage> dataUsage(qint64 sinceDay) const override;
+
+    quint64 statisticsSignalCount() const override;
+
+    quint64 accessPointUpdatesCoalesced() const override;
+
+    quint64 accessPointUpdatesEmitted() const override;
+
+    void setStatisticsRefreshRate(const QString& linkName, uint refreshRateMs) override;
+
     void setHotspotEnabled(bool) override;
 
     void setHotspotSsid(const QByteArray&) override;
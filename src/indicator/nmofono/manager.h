@@ -20,7 +20,9 @@
 #pragma once
 
 #include <nmofono/hotspot-manager.h>
+#include <nmofono/data-usage-ledger.h>
 #include <nmofono/link.h>
+#include <nmofono/throughput-meter.h>
 #include <nmofono/ethernet/ethernet-link.h>
 #include <nmofono/wifi/wifi-link.h>
 #include <nmofono/wwan/modem.h>
@@ -167,6 +169,21 @@ public:
     Q_PROPERTY(bool rx READ rx NOTIFY rxChanged)
     virtual bool rx() const = 0;
 
+    virtual QMap<QString, Throughput> throughput() const = 0;
+
+    /**
+     * Bytes transferred per network, starting from the given Julian day.
+     */
+    virtual QMap<QString, DataUsage> dataUsage(qint64 sinceDay) const = 0;
+
+    virtual quint64 statisticsSignalCount() const = 0;
+
+    virtual quint64 accessPointUpdatesCoalesced() const = 0;
+
+    virtual quint64 accessPointUpdatesEmitted() const = 0;
+
+    virtual void setStatisticsRefreshRate(const QString& linkName, uint refreshRateMs) = 0;
+
 
 Q_SIGNALS:
     void flightModeUpdated(bool);
@@ -211,6 +228,8 @@ Q_SIGNALS:
 
     void rxChanged();
 
+    void throughputChanged();
+
 public Q_SLOTS:
     virtual void setWifiEnabled(bool) = 0;
 
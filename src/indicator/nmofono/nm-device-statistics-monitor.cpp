@@ -24,6 +24,7 @@
 
 #include <QDBusInterface>
 
+#include <QElapsedTimer>
 #include <QMap>
 #include <QDebug>
 
@@ -49,7 +50,50 @@ class NMDeviceStatisticsMonitor::Private : public QObject, public std::enable_sh
 
 public:
 
-    QMap<QString, std::shared_ptr<OrgFreedesktopNetworkManagerDeviceStatisticsInterface>> m_interfaces;
+    // Polling interval while a link is moving data
+    static constexpr uint ACTIVE_REFRESH_MS = 500;
+
+    // Polling interval once the counters have been flat for IDLE_TIMEOUT_MS
+    static constexpr uint IDLE_REFRESH_MS = 5000;
+
+    static constexpr int IDLE_TIMEOUT_MS = 2000;
+
+    struct Statistics
+    {
+        std::shared_ptr<OrgFreedesktopNetworkManagerDeviceStatisticsInterface> iface;
+        QString linkName;
+        ThroughputMeter meter;
+        quint64 txBytes{0};
+        quint64 rxBytes{0};
+        bool txKnown{false};
+        bool rxKnown{false};
+        QMetaObject::Connection connection;
+
+        // Network the traffic is charged to in the ledger, empty if unknown
+        QByteArray usageKey;
+
+        // Counters last charged to the ledger. They survive screen off,
+        // so the next update catches up on what was missed, unless the
+        // link moved to another network in the meantime.
+        quint64 ledgerTxBytes{0};
+        quint64 ledgerRxBytes{0};
+        bool ledgerKnown{false};
+
+        // What we last asked NM for, -1 if we don't know
+        int refreshRateMs{-1};
+        bool active{false};
+        QTimer idleTimer;
+    };
+
+    QMap<QString, std::shared_ptr<Statistics>> m_interfaces;
+
+    DataUsageLedger::SPtr m_ledger;
+
+    // Fixed refresh rates requested for particular links, by link name
+    QMap<QString, uint> m_refreshRateOverrides;
+
+    quint64 m_signalCount{0};
+    QElapsedTimer m_clock;
     QTimer m_txTimer;
     QTimer m_rxTimer;
 
@@ -77,8 +121,8 @@ public:
                                   // BUG: https://bugs.launchpad.net/ubuntu/+source/repowerd/+bug/1637722
     /***************/
 
-    Private(NMDeviceStatisticsMonitor& parent)
-        : p(parent)
+    Private(NMDeviceStatisticsMonitor& parent, DataUsageLedger::SPtr ledger)
+        : p(parent), m_ledger(ledger)
     {
         GSettings *settings{nullptr};
         if (qEnvironmentVariableIsSet("INDICATOR_NETWORK_UNDER_TESTING"))
@@ -114,11 +158,13 @@ public:
 
         m_txTimer.setInterval(1000);
         m_txTimer.setSingleShot(true);
-        connect(&m_rxTimer, &QTimer::timeout, this, &Private::txShot);
+        connect(&m_txTimer, &QTimer::timeout, this, &Private::txShot);
 
         m_rxTimer.setInterval(1000);
         m_rxTimer.setSingleShot(true);
         connect(&m_rxTimer, &QTimer::timeout, this, &Private::rxShot);
+
+        m_clock.start();
     }
 
     ~Private()
@@ -151,6 +197,38 @@ public:
         Q_EMIT p.rxChanged();
     }
 
+    void setRefreshRate(Statistics &stats, uint refreshRateMs)
+    {
+        if (stats.refreshRateMs == int(refreshRateMs))
+        {
+            return;
+        }
+
+#ifdef INDICATOR_NETWORK_TRACE_MESSAGES
+        qDebug() << "Refresh rate for" << stats.linkName << "is now" << refreshRateMs;
+#endif
+        stats.refreshRateMs = refreshRateMs;
+        stats.iface->setRefreshRateMs(refreshRateMs);
+    }
+
+    void updateRefreshRate(Statistics &stats)
+    {
+        if (!stats.connection)
+        {
+            return;
+        }
+
+        auto it = m_refreshRateOverrides.constFind(stats.linkName);
+        if (it != m_refreshRateOverrides.constEnd())
+        {
+            setRefreshRate(stats, *it);
+        }
+        else
+        {
+            setRefreshRate(stats, stats.active ? ACTIVE_REFRESH_MS : IDLE_REFRESH_MS);
+        }
+    }
+
 
     void setUpInterface(const QString &path)
     {
@@ -159,15 +237,24 @@ public:
             return;
         }
 
-        if (!m_enabled)
+        auto stats = m_interfaces[path];
+        if (stats->connection)
         {
             return;
         }
 
-        auto iface = m_interfaces[path];
-
-        connect(iface.get(), &OrgFreedesktopNetworkManagerDeviceStatisticsInterface::PropertiesChanged, this, &Private::propertiesChanged);
-        iface->setRefreshRateMs(500);
+        // Capture the entry directly so the update path needs no lookups
+        auto raw = stats.get();
+        stats->connection = connect(stats->iface.get(), &OrgFreedesktopNetworkManagerDeviceStatisticsInterface::PropertiesChanged, this,
+                [this, raw](const QVariantMap &properties)
+                {
+                    propertiesChanged(*raw, properties);
+                });
+
+        // Poll quickly at first so the rates settle, the idle timer backs off
+        stats->active = true;
+        stats->idleTimer.start();
+        updateRefreshRate(*stats);
     }
 
     void resetInterface(const QString &path)
@@ -176,9 +263,17 @@ public:
         {
             return;
         }
-        auto iface = m_interfaces[path];
-        disconnect(iface.get(), &OrgFreedesktopNetworkManagerDeviceStatisticsInterface::PropertiesChanged, this, &Private::propertiesChanged);
-        iface->setRefreshRateMs(0);
+        auto stats = m_interfaces[path];
+        disconnect(stats->connection);
+        stats->connection = QMetaObject::Connection();
+        stats->idleTimer.stop();
+        stats->active = false;
+        setRefreshRate(*stats, 0);
+
+        // Don't average across the time we weren't listening
+        stats->meter.reset();
+        stats->txKnown = false;
+        stats->rxKnown = false;
     }
 
     void connectAllInterfaces()
@@ -195,6 +290,132 @@ public:
         {
             resetInterface(path);
         }
+        Q_EMIT p.throughputChanged();
+    }
+
+    void propertiesChanged(Statistics &stats, const QVariantMap &properties)
+    {
+        ++m_signalCount;
+        bool changed = false;
+
+        auto tx = properties.constFind(QStringLiteral("TxBytes"));
+        if (tx != properties.constEnd())
+        {
+#ifdef INDICATOR_NETWORK_TRACE_MESSAGES
+            qDebug() << "TxBytes updated on" << stats.iface->path();
+#endif
+            stats.txBytes = tx->toULongLong();
+            stats.txKnown = true;
+            changed = true;
+            if (m_enabled)
+            {
+                setTx(true);
+                m_txTimer.start();
+            }
+        }
+
+        auto rx = properties.constFind(QStringLiteral("RxBytes"));
+        if (rx != properties.constEnd())
+        {
+#ifdef INDICATOR_NETWORK_TRACE_MESSAGES
+            qDebug() << "RxBytes updated on" << stats.iface->path();
+#endif
+            stats.rxBytes = rx->toULongLong();
+            stats.rxKnown = true;
+            changed = true;
+            if (m_enabled)
+            {
+                setRx(true);
+                m_rxTimer.start();
+            }
+        }
+
+        // NM only signals when the counters move, so silence means idle
+        if (changed)
+        {
+            stats.idleTimer.start();
+            if (!stats.active)
+            {
+                stats.active = true;
+                updateRefreshRate(stats);
+            }
+        }
+
+        // A sample needs both counters, or the missing one reads as a burst
+        if (changed && stats.txKnown && stats.rxKnown)
+        {
+            stats.meter.addSample(stats.txBytes, stats.rxBytes, m_clock.elapsed());
+            chargeLedger(stats);
+            Q_EMIT p.throughputChanged();
+        }
+    }
+
+    void chargeLedger(Statistics &stats)
+    {
+        if (stats.ledgerKnown && m_ledger && !stats.usageKey.isEmpty())
+        {
+            // Counters that went backwards were reset along with the device
+            quint64 tx = stats.txBytes >= stats.ledgerTxBytes ?
+                    stats.txBytes - stats.ledgerTxBytes : stats.txBytes;
+            quint64 rx = stats.rxBytes >= stats.ledgerRxBytes ?
+                    stats.rxBytes - stats.ledgerRxBytes : stats.rxBytes;
+            if (tx > 0 || rx > 0)
+            {
+                m_ledger->add(stats.usageKey, tx, rx);
+            }
+        }
+
+        stats.ledgerTxBytes = stats.txBytes;
+        stats.ledgerRxBytes = stats.rxBytes;
+        stats.ledgerKnown = true;
+    }
+
+    void setUsageKey(Statistics &stats, const QByteArray& key)
+    {
+        if (key == stats.usageKey)
+        {
+            return;
+        }
+
+        // What the counters last said still belongs to the old network
+        if (stats.txKnown && stats.rxKnown)
+        {
+            chargeLedger(stats);
+        }
+        stats.usageKey = key;
+
+        // There is no telling which network the traffic since then (maybe
+        // a whole screen off) went over, so start afresh from the next sample
+        stats.ledgerKnown = false;
+    }
+
+    static QByteArray usageKey(Link::SPtr link)
+    {
+        if (auto wifiLink = dynamic_pointer_cast<wifi::WifiLinkImpl>(link))
+        {
+            auto ap = wifiLink->activeAccessPoint();
+            if (ap)
+            {
+                return DataUsageLedger::key(DataUsageLedger::Kind::wifi, ap->raw_ssid());
+            }
+        }
+        else if (auto modem = dynamic_pointer_cast<wwan::Modem>(link))
+        {
+            auto sim = modem->sim();
+            if (sim)
+            {
+                return DataUsageLedger::key(DataUsageLedger::Kind::sim, sim->iccid().toUtf8());
+            }
+        }
+        else if (auto ethernetLink = dynamic_pointer_cast<ethernet::EthernetLink>(link))
+        {
+            auto connection = ethernetLink->preferredConnection();
+            if (connection)
+            {
+                return DataUsageLedger::key(DataUsageLedger::Kind::ethernet, connection->connectionUuid().toUtf8());
+            }
+        }
+        return QByteArray();
     }
 
 
@@ -220,29 +441,6 @@ public Q_SLOTS:
         }
     }
 
-    void propertiesChanged(const QVariantMap &properties)
-    {
-        if (properties.contains("TxBytes"))
-        {
-#ifdef INDICATOR_NETWORK_TRACE_MESSAGES
-            OrgFreedesktopNetworkManagerDeviceStatisticsInterface *iface = qobject_cast<OrgFreedesktopNetworkManagerDeviceStatisticsInterface*>(sender());
-            qDebug() << "TxBytes updated on" << iface->path();
-#endif
-               setTx(true);
-               m_txTimer.start();
-        }
-
-        if (properties.contains("RxBytes"))\
-        {
-#ifdef INDICATOR_NETWORK_TRACE_MESSAGES
-            OrgFreedesktopNetworkManagerDeviceStatisticsInterface *iface = qobject_cast<OrgFreedesktopNetworkManagerDeviceStatisticsInterface*>(sender());
-            qDebug() << "RxBytes updated on" << iface->path();
-#endif
-            setRx(true);
-            m_rxTimer.start();
-        }
-    }
-
     void txShot()
     {
 #ifdef INDICATOR_NETWORK_TRACE_MESSAGES
@@ -262,9 +460,13 @@ public Q_SLOTS:
 
 };
 
+constexpr uint NMDeviceStatisticsMonitor::Private::ACTIVE_REFRESH_MS;
+constexpr uint NMDeviceStatisticsMonitor::Private::IDLE_REFRESH_MS;
+constexpr int NMDeviceStatisticsMonitor::Private::IDLE_TIMEOUT_MS;
 
-NMDeviceStatisticsMonitor::NMDeviceStatisticsMonitor()
-    : d{new Private(*this)}
+
+NMDeviceStatisticsMonitor::NMDeviceStatisticsMonitor(DataUsageLedger::SPtr ledger)
+    : d{new Private(*this, ledger)}
 {
 }
 
@@ -301,12 +503,46 @@ NMDeviceStatisticsMonitor::addLink(Link::SPtr link)
         return;
     }
 
-    auto dev = make_shared<OrgFreedesktopNetworkManagerDeviceStatisticsInterface>(
+    auto stats = make_shared<Private::Statistics>();
+    stats->iface = make_shared<OrgFreedesktopNetworkManagerDeviceStatisticsInterface>(
                 NM_DBUS_SERVICE,
                 path,
                 QDBusConnection::systemBus());
+    stats->linkName = link->name();
 
-    d->m_interfaces[path] = dev;
+    stats->idleTimer.setInterval(Private::IDLE_TIMEOUT_MS);
+    stats->idleTimer.setSingleShot(true);
+    auto raw = stats.get();
+    connect(&stats->idleTimer, &QTimer::timeout, d.get(), [this, raw]()
+    {
+        raw->active = false;
+        d->updateRefreshRate(*raw);
+    });
+
+    // Follow the network this link is on, so usage is charged to it
+    stats->usageKey = Private::usageKey(link);
+    weak_ptr<Link> weakLink(link);
+    auto updateUsageKey = [this, raw, weakLink]()
+    {
+        if (auto link = weakLink.lock())
+        {
+            d->setUsageKey(*raw, Private::usageKey(link));
+        }
+    };
+    if (auto wifiLink = dynamic_pointer_cast<wifi::WifiLinkImpl>(link))
+    {
+        connect(wifiLink.get(), &wifi::WifiLink::activeAccessPointUpdated, stats->iface.get(), updateUsageKey);
+    }
+    else if (auto modem = dynamic_pointer_cast<wwan::Modem>(link))
+    {
+        connect(modem.get(), &wwan::Modem::simUpdated, stats->iface.get(), updateUsageKey);
+    }
+    else if (auto ethernetLink = dynamic_pointer_cast<ethernet::EthernetLink>(link))
+    {
+        connect(ethernetLink.get(), &ethernet::EthernetLink::preferredConnectionChanged, stats->iface.get(), updateUsageKey);
+    }
+
+    d->m_interfaces[path] = stats;
 
     d->setUpInterface(path);
 }
@@ -318,6 +554,7 @@ NMDeviceStatisticsMonitor::remove(const QString &nmPath)
     {
         d->resetInterface(nmPath);
         d->m_interfaces.remove(nmPath);
+        Q_EMIT throughputChanged();
     }
 }
 
@@ -333,6 +570,44 @@ NMDeviceStatisticsMonitor::rx() const
     return d->m_rx;
 }
 
+void
+NMDeviceStatisticsMonitor::setRefreshRateOverride(const QString &linkName, uint refreshRateMs)
+{
+    if (refreshRateMs == 0)
+    {
+        d->m_refreshRateOverrides.remove(linkName);
+    }
+    else
+    {
+        d->m_refreshRateOverrides[linkName] = refreshRateMs;
+    }
+
+    for (const auto& stats : d->m_interfaces)
+    {
+        if (stats->linkName == linkName)
+        {
+            d->updateRefreshRate(*stats);
+        }
+    }
+}
+
+quint64
+NMDeviceStatisticsMonitor::signalCount() const
+{
+    return d->m_signalCount;
+}
+
+QMap<QString, Throughput>
+NMDeviceStatisticsMonitor::throughput() const
+{
+    QMap<QString, Throughput> result;
+    for (const auto& stats : d->m_interfaces)
+    {
+        result[stats->linkName] = stats->meter.throughput();
+    }
+    return result;
+}
+
 }
 
 #include "nm-device-statistics-monitor.moc"
@@ -19,9 +19,12 @@
 
 #pragma once
 
+#include <QMap>
 #include <QObject>
 
+#include "data-usage-ledger.h"
 #include "link.h"
+#include "throughput-meter.h"
 
 #include <memory>
 
@@ -46,17 +49,35 @@ public:
     Q_PROPERTY(bool rx READ rx NOTIFY rxChanged)
     virtual bool rx() const;
 
-    NMDeviceStatisticsMonitor();
+    /**
+     * Transfer rates keyed by link name.
+     */
+    QMap<QString, Throughput> throughput() const;
+
+    /**
+     * Number of statistics updates received from NetworkManager.
+     */
+    quint64 signalCount() const;
+
+    NMDeviceStatisticsMonitor(DataUsageLedger::SPtr ledger = DataUsageLedger::SPtr());
     ~NMDeviceStatisticsMonitor();
 
     void addLink(Link::SPtr link);
 
     void remove(const QString &nmPath);
 
+    /**
+     * Poll the named link at a fixed rate instead of adapting to its
+     * traffic. A rate of 0 restores the adaptive behaviour.
+     */
+    void setRefreshRateOverride(const QString &linkName, uint refreshRateMs);
+
 Q_SIGNALS:
 
     void txChanged();
     void rxChanged();
+
+    void throughputChanged();
 };
 
 }
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/object-snapshot.h>
+#include <ObjectManagerInterface.h>
+
+#include <NetworkManager.h>
+
+#include <QDBusArgument>
+#include <QDebug>
+
+using namespace std;
+
+namespace nmofono
+{
+
+// NetworkManager exports its ObjectManager at the root of its namespace,
+// not on the main manager object
+static const char* NM_OBJECT_MANAGER_PATH = "/org/freedesktop";
+
+ObjectSnapshot::SPtr ObjectSnapshot::fetch(const QDBusConnection& systemConnection)
+{
+    OrgFreedesktopDBusObjectManagerInterface objectManager(
+            NM_DBUS_SERVICE, NM_OBJECT_MANAGER_PATH, systemConnection);
+
+    auto reply = objectManager.GetManagedObjects();
+    reply.waitForFinished();
+    if (reply.isError())
+    {
+        qDebug() << "NetworkManager object snapshot not available:" << reply.error().message();
+        return SPtr();
+    }
+
+    return make_shared<ObjectSnapshot>(reply.value());
+}
+
+ObjectSnapshot::ObjectSnapshot(const QObjectPathVariantDictMap& objects) :
+        m_objects(objects)
+{
+}
+
+bool ObjectSnapshot::contains(const QDBusObjectPath& path, const QString& interface) const
+{
+    auto it = m_objects.constFind(path);
+    return it != m_objects.constEnd() && it->contains(interface);
+}
+
+QVariantMap ObjectSnapshot::properties(const QDBusObjectPath& path, const QString& interface) const
+{
+    return m_objects.value(path).value(interface);
+}
+
+QList<QDBusObjectPath> ObjectSnapshot::paths(const QString& interface) const
+{
+    QList<QDBusObjectPath> result;
+    for (auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it)
+    {
+        if (it->contains(interface))
+        {
+            result << it.key();
+        }
+    }
+    return result;
+}
+
+QList<QDBusObjectPath> ObjectSnapshot::pathList(const QVariant& value)
+{
+    QList<QDBusObjectPath> result;
+    if (value.canConvert<QDBusArgument>())
+    {
+        qvariant_cast<QDBusArgument>(value) >> result;
+    }
+    else
+    {
+        result = qvariant_cast<QList<QDBusObjectPath>>(value);
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <dbus-types.h>
+
+#include <QDBusConnection>
+#include <QDBusObjectPath>
+#include <QList>
+#include <QVariantMap>
+
+#include <unity/util/DefinesPtrs.h>
+
+namespace nmofono
+{
+
+/**
+ * A copy of every object NetworkManager exports and its properties,
+ * fetched with a single ObjectManager.GetManagedObjects call.
+ *
+ * It is only used to build the initial state at startup. Later updates
+ * still come from the usual signals.
+ */
+class ObjectSnapshot
+{
+public:
+    UNITY_DEFINES_PTRS(ObjectSnapshot);
+
+    /**
+     * Returns null if NetworkManager does not export an ObjectManager
+     * (versions before 1.2). Callers then fall back to reading the
+     * objects one at a time.
+     */
+    static SPtr fetch(const QDBusConnection& systemConnection);
+
+    ObjectSnapshot(const QObjectPathVariantDictMap& objects);
+
+    ~ObjectSnapshot() = default;
+
+    bool contains(const QDBusObjectPath& path, const QString& interface) const;
+
+    QVariantMap properties(const QDBusObjectPath& path, const QString& interface) const;
+
+    QList<QDBusObjectPath> paths(const QString& interface) const;
+
+    static QList<QDBusObjectPath> pathList(const QVariant& value);
+
+protected:
+    QObjectPathVariantDictMap m_objects;
+};
+
+}
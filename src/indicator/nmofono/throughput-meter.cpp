@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/throughput-meter.h>
+
+#include <cmath>
+
+using namespace std;
+
+namespace nmofono
+{
+
+constexpr size_t ThroughputMeter::CAPACITY;
+constexpr qint64 ThroughputMeter::MIN_INTERVAL_MS;
+constexpr double ThroughputMeter::SMOOTHING_MS;
+
+void
+ThroughputMeter::addSample(quint64 txBytes, quint64 rxBytes, qint64 timestampMs)
+{
+    if (m_count > 0)
+    {
+        const auto& latest = sampleAt(0);
+
+        // The counters went backwards, so the device was reset
+        if (txBytes < latest.txBytes || rxBytes < latest.rxBytes
+                || timestampMs < latest.timestamp)
+        {
+            reset();
+        }
+        else if (timestampMs - latest.timestamp < MIN_INTERVAL_MS)
+        {
+            m_samples[m_head] = {txBytes, rxBytes, timestampMs};
+            smooth();
+            return;
+        }
+    }
+
+    m_head = (m_head + 1) % CAPACITY;
+    m_samples[m_head] = {txBytes, rxBytes, timestampMs};
+    if (m_count < CAPACITY)
+    {
+        ++m_count;
+    }
+
+    m_baseTxRate = m_txRate;
+    m_baseRxRate = m_rxRate;
+    smooth();
+}
+
+void
+ThroughputMeter::reset()
+{
+    m_head = 0;
+    m_count = 0;
+    m_baseTxRate = 0.0;
+    m_baseRxRate = 0.0;
+    m_txRate = 0.0;
+    m_rxRate = 0.0;
+}
+
+size_t
+ThroughputMeter::size() const
+{
+    return m_count;
+}
+
+Throughput
+ThroughputMeter::throughput() const
+{
+    Throughput result;
+    result.txRate = m_txRate;
+    result.rxRate = m_rxRate;
+
+    if (m_count >= 2)
+    {
+        const auto& newest = sampleAt(0);
+        const auto& oldest = sampleAt(m_count - 1);
+        qint64 elapsed = newest.timestamp - oldest.timestamp;
+        if (elapsed > 0)
+        {
+            result.recentTxRate = (newest.txBytes - oldest.txBytes) * 1000.0 / elapsed;
+            result.recentRxRate = (newest.rxBytes - oldest.rxBytes) * 1000.0 / elapsed;
+        }
+    }
+
+    return result;
+}
+
+const ThroughputMeter::Sample&
+ThroughputMeter::sampleAt(size_t age) const
+{
+    return m_samples[(m_head + CAPACITY - age) % CAPACITY];
+}
+
+void
+ThroughputMeter::smooth()
+{
+    if (m_count < 2)
+    {
+        return;
+    }
+
+    const auto& current = sampleAt(0);
+    const auto& previous = sampleAt(1);
+    qint64 elapsed = current.timestamp - previous.timestamp;
+    if (elapsed <= 0)
+    {
+        return;
+    }
+
+    double txRate = (current.txBytes - previous.txBytes) * 1000.0 / elapsed;
+    double rxRate = (current.rxBytes - previous.rxBytes) * 1000.0 / elapsed;
+
+    // The first interval seeds the average rather than decaying from zero
+    if (m_count == 2)
+    {
+        m_txRate = txRate;
+        m_rxRate = rxRate;
+        return;
+    }
+
+    double alpha = 1.0 - exp(-elapsed / SMOOTHING_MS);
+    m_txRate = m_baseTxRate + alpha * (txRate - m_baseTxRate);
+    m_rxRate = m_baseRxRate + alpha * (rxRate - m_baseRxRate);
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <QtGlobal>
+
+#include <array>
+#include <cstddef>
+
+namespace nmofono
+{
+
+struct Throughput
+{
+    // Exponentially smoothed bytes per second
+    double txRate{0.0};
+    double rxRate{0.0};
+
+    // Mean bytes per second across the whole sample window
+    double recentTxRate{0.0};
+    double recentRxRate{0.0};
+};
+
+/**
+ * Turns the cumulative TxBytes / RxBytes counters reported by
+ * NetworkManager into transfer rates.
+ *
+ * Samples are kept in a fixed size ring buffer, so recording one never
+ * allocates.
+ */
+class ThroughputMeter
+{
+public:
+    static constexpr std::size_t CAPACITY = 16;
+
+    // Samples arriving closer together than this are folded into the
+    // previous one. NM reports TxBytes and RxBytes in separate signals.
+    static constexpr qint64 MIN_INTERVAL_MS = 100;
+
+    static constexpr double SMOOTHING_MS = 2000.0;
+
+    void addSample(quint64 txBytes, quint64 rxBytes, qint64 timestampMs);
+
+    void reset();
+
+    std::size_t size() const;
+
+    Throughput throughput() const;
+
+private:
+    struct Sample
+    {
+        quint64 txBytes;
+        quint64 rxBytes;
+        qint64 timestamp;
+    };
+
+    const Sample& sampleAt(std::size_t age) const;
+
+    void smooth();
+
+    std::array<Sample, CAPACITY> m_samples;
+
+    std::size_t m_head{0};
+
+    std::size_t m_count{0};
+
+    // Smoothed rates before / after the newest sample was taken into account
+    double m_baseTxRate{0.0};
+    double m_baseRxRate{0.0};
+    double m_txRate{0.0};
+    double m_rxRate{0.0};
+};
+
+}
@@ -18,6 +18,7 @@
  */
 
 #include <nmofono/vpn/openvpn-connection.h>
+#include <nmofono/vpn/settings-field.h>
 
 #include <NetworkManagerSettingsConnectionInterface.h>
 
@@ -34,74 +35,43 @@ void set##uppername(type value)\
     Q_EMIT p.name##Changed(m_data.m_##name);\
 }
 
-#define DEFINE_UPDATE_PROPERTY_STRING(name, uppername, strname) \
-void update##uppername(const QStringMap& data)\
-{\
-    set##uppername(data.value(strname));\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, const QString &)
-
-#define DEFINE_UPDATE_PROPERTY_BOOL(name, uppername, strname) \
-void update##uppername(const QStringMap& data)\
-{\
-    set##uppername(data.value(strname) == "yes");\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, bool)
-
-#define DEFINE_UPDATE_PROPERTY_PAIR(name, uppername, strname, type, conversion)\
-void update##uppername(const QStringMap& data)\
-{\
-    auto it = data.constFind(strname);\
-    bool found = (it != data.constEnd());\
-    set##uppername##Set(found);\
-    if (found)\
-    {\
-        set##uppername(it->conversion);\
-    }\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, type)\
-\
-DEFINE_UPDATE_SETTER(name##Set, uppername##Set, bool)\
-
 #define DEFINE_PROPERTY_GETTER(name,type) \
 type OpenvpnConnection::name() const\
 {\
     return d->m_data.m_##name;\
 }\
 
+// Only the field is recorded, the maps are built once when the edits are written
 #define DEFINE_PROPERTY_SETTER(varname, uppername, type) \
 void OpenvpnConnection::set##uppername(type value)\
 {\
-    if (d->m_data.m_##varname == value)\
+    if (d->current().m_##varname == value)\
     {\
         return;\
     }\
-    if (!d->m_dirty)\
+    d->beginEdit();\
+    d->m_pendingData.m_##varname = value;\
+    if (!d->m_dataEdited)\
     {\
-        d->m_pendingData = d->m_data;\
+        d->m_dataEdited = true;\
+        Q_EMIT vpnDataEdited();\
     }\
-    d->m_dirty = true;\
-    d->m_pendingData.m_##varname = value;\
-    Q_EMIT updateVpnData(d->m_pendingData.buildData());\
 }
 
 #define DEFINE_SECRET_PROPERTY_SETTER(varname, uppername, type) \
 void OpenvpnConnection::set##uppername(type value)\
 {\
-    if (d->m_data.m_##varname == value)\
+    if (d->current().m_##varname == value)\
     {\
         return;\
     }\
-    if (!d->m_dirty)\
+    d->beginEdit();\
+    d->m_pendingData.m_##varname = value;\
+    if (!d->m_secretsEdited)\
     {\
-        d->m_pendingData = d->m_data;\
+        d->m_secretsEdited = true;\
+        Q_EMIT vpnSecretsEdited();\
     }\
-    d->m_dirty = true;\
-    d->m_pendingData.m_##varname = value;\
-    Q_EMIT updateVpnSecrets(d->m_pendingData.buildSecrets());\
 }
 
 namespace nmofono
@@ -501,11 +471,67 @@ public:
     {
     }
 
-    // Basic properties
+    typedef SettingsField<Data, OpenvpnConnection> Field;
+
+    // The keys that map straight onto one property, the rest are below
+
+    static constexpr Field DATA_FIELDS[] =
+    {
+        // Basic properties
+
+        Field::text("ca", &Data::m_ca, &OpenvpnConnection::caChanged),
+        Field::text("cert", &Data::m_cert, &OpenvpnConnection::certChanged),
+        Field::text("key", &Data::m_key, &OpenvpnConnection::keyChanged),
+        Field::text("local-ip", &Data::m_localIp, &OpenvpnConnection::localIpChanged),
+        Field::text("remote", &Data::m_remote, &OpenvpnConnection::remoteChanged),
+        Field::text("remote-ip", &Data::m_remoteIp, &OpenvpnConnection::remoteIpChanged),
+        Field::text("static-key", &Data::m_staticKey, &OpenvpnConnection::staticKeyChanged),
+        Field::text("username", &Data::m_username, &OpenvpnConnection::usernameChanged),
+
+        // Advanced general properties
+
+        Field::number("port", &Data::m_port, &OpenvpnConnection::portChanged,
+                      &Data::m_portSet, &OpenvpnConnection::portSetChanged),
+        Field::number("reneg-seconds", &Data::m_renegSeconds, &OpenvpnConnection::renegSecondsChanged,
+                      &Data::m_renegSecondsSet, &OpenvpnConnection::renegSecondsSetChanged),
+        Field::flag("comp-lzo", &Data::m_compLzo, &OpenvpnConnection::compLzoChanged),
+        Field::flag("proto-tcp", &Data::m_protoTcp, &OpenvpnConnection::protoTcpChanged),
+        Field::number("tunnel-mtu", &Data::m_tunnelMtu, &OpenvpnConnection::tunnelMtuChanged,
+                      &Data::m_tunnelMtuSet, &OpenvpnConnection::tunnelMtuSetChanged),
+        Field::number("fragment-size", &Data::m_fragmentSize, &OpenvpnConnection::fragmentSizeChanged,
+                      &Data::m_fragmentSizeSet, &OpenvpnConnection::fragmentSizeSetChanged),
+        Field::flag("mssfix", &Data::m_mssFix, &OpenvpnConnection::mssFixChanged),
+        Field::flag("remote-random", &Data::m_remoteRandom, &OpenvpnConnection::remoteRandomChanged),
+
+        // Advanced security properties
+
+        Field::number("keysize", &Data::m_keysize, &OpenvpnConnection::keysizeChanged,
+                      &Data::m_keysizeSet, &OpenvpnConnection::keysizeSetChanged),
+
+        // Advanced TLS auth properties
+
+        Field::text("tls-remote", &Data::m_tlsRemote, &OpenvpnConnection::tlsRemoteChanged)
+    };
+
+    static constexpr Field SECRET_FIELDS[] =
+    {
+        Field::text("cert-pass", &Data::m_certPass, &OpenvpnConnection::certPassChanged),
+        Field::text("password", &Data::m_password, &OpenvpnConnection::passwordChanged)
+    };
 
-    DEFINE_UPDATE_PROPERTY_STRING(ca, Ca, "ca")
-    DEFINE_UPDATE_PROPERTY_STRING(cert, Cert, "cert")
-    DEFINE_UPDATE_PROPERTY_STRING(certPass, CertPass, "cert-pass")
+    static const SettingsSchema<Data, OpenvpnConnection>& dataSchema()
+    {
+        static const SettingsSchema<Data, OpenvpnConnection> schema(DATA_FIELDS);
+        return schema;
+    }
+
+    static const SettingsSchema<Data, OpenvpnConnection>& secretsSchema()
+    {
+        static const SettingsSchema<Data, OpenvpnConnection> schema(SECRET_FIELDS);
+        return schema;
+    }
+
+    // Basic properties
 
     void updateConnectionType(const QStringMap& data)
     {
@@ -521,12 +547,6 @@ public:
     }
     DEFINE_UPDATE_SETTER(connectionType, ConnectionType, OpenvpnConnection::ConnectionType)
 
-    DEFINE_UPDATE_PROPERTY_STRING(key, Key, "key")
-    DEFINE_UPDATE_PROPERTY_STRING(localIp, LocalIp, "local-ip")
-    DEFINE_UPDATE_PROPERTY_STRING(password, Password, "password")
-    DEFINE_UPDATE_PROPERTY_STRING(remote, Remote, "remote")
-    DEFINE_UPDATE_PROPERTY_STRING(remoteIp, RemoteIp, "remote-ip")
-    DEFINE_UPDATE_PROPERTY_STRING(staticKey, StaticKey, "static-key")
 
     void updateStaticKeyDirection(const QStringMap& data)
     {
@@ -548,15 +568,8 @@ public:
     }
     DEFINE_UPDATE_SETTER(staticKeyDirection, StaticKeyDirection, OpenvpnConnection::KeyDir)
 
-    DEFINE_UPDATE_PROPERTY_STRING(username, Username, "username")
-
     // Advanced general properties
 
-    DEFINE_UPDATE_PROPERTY_PAIR(port, Port, "port", int, toInt())
-    DEFINE_UPDATE_PROPERTY_PAIR(renegSeconds, RenegSeconds, "reneg-seconds", int, toInt())
-    DEFINE_UPDATE_PROPERTY_BOOL(compLzo, CompLzo, "comp-lzo")
-    DEFINE_UPDATE_PROPERTY_BOOL(protoTcp, ProtoTcp, "proto-tcp")
-
     void updateDevType(const QStringMap& data)
     {
         static const QMap<QString, DevType> typeMap
@@ -578,11 +591,6 @@ public:
     DEFINE_UPDATE_SETTER(devType, DevType, OpenvpnConnection::DevType)
     DEFINE_UPDATE_SETTER(devTypeSet, DevTypeSet, bool)
 
-    DEFINE_UPDATE_PROPERTY_PAIR(tunnelMtu, TunnelMtu, "tunnel-mtu", int, toInt())
-    DEFINE_UPDATE_PROPERTY_PAIR(fragmentSize, FragmentSize, "fragment-size", int, toInt())
-    DEFINE_UPDATE_PROPERTY_BOOL(mssFix, MssFix, "mssfix")
-    DEFINE_UPDATE_PROPERTY_BOOL(remoteRandom, RemoteRandom, "remote-random")
-
     // Advanced security properties
 
     void updateCipher(const QStringMap& data)
@@ -620,7 +628,6 @@ public:
     }
     DEFINE_UPDATE_SETTER(cipher, Cipher, OpenvpnConnection::Cipher)
 
-    DEFINE_UPDATE_PROPERTY_PAIR(keysize, Keysize, "keysize", int, toInt())
 
     void updateAuth(const QStringMap& data)
     {
@@ -652,8 +659,6 @@ public:
 
     // Advanced TLS auth properties
 
-    DEFINE_UPDATE_PROPERTY_STRING(tlsRemote, TlsRemote, "tls-remote")
-
     void updateRemoteCertTls(const QStringMap& data)
     {
         static const QMap<QString, TlsType> typeMap
@@ -709,7 +714,7 @@ public:
         if (found)
         {
             setProxyType(typeMap.value(*it, ProxyType::NOT_REQUIRED));
-            updateProxyServer(data);
+            setProxyServer(data.value("proxy-server"));
             auto portIt = data.constFind("proxy-port");
             if (portIt != data.constEnd())
             {
@@ -719,7 +724,7 @@ public:
             {
                setProxyPort(0);
             }
-            updateProxyRetry(data);
+            setProxyRetry(data.value("proxy-retry") == "yes");
 
             switch (m_data.m_proxyType)
             {
@@ -739,9 +744,9 @@ public:
         }
     }
     DEFINE_UPDATE_SETTER(proxyType, ProxyType, OpenvpnConnection::ProxyType)
-    DEFINE_UPDATE_PROPERTY_STRING(proxyServer, ProxyServer, "proxy-server")
+    DEFINE_UPDATE_SETTER(proxyServer, ProxyServer, const QString &)
     DEFINE_UPDATE_SETTER(proxyPort, ProxyPort, int)
-    DEFINE_UPDATE_PROPERTY_BOOL(proxyRetry, ProxyRetry, "proxy-retry")
+    DEFINE_UPDATE_SETTER(proxyRetry, ProxyRetry, bool)
     DEFINE_UPDATE_SETTER(proxyUsername, ProxyUsername, const QString &)
     DEFINE_UPDATE_SETTER(proxyPassword, ProxyPassword, const QString &)
 
@@ -760,6 +765,21 @@ public:
         }
     }
 
+    // The values the next edit is compared against
+    const Data& current() const
+    {
+        return m_dirty ? m_pendingData : m_data;
+    }
+
+    void beginEdit()
+    {
+        if (!m_dirty)
+        {
+            m_pendingData = m_data;
+            m_dirty = true;
+        }
+    }
+
 public:
 
     OpenvpnConnection& p;
@@ -769,8 +789,17 @@ public:
     Data m_pendingData;
 
     bool m_dirty = false;
+
+    // Edited since the last time the maps were taken
+    bool m_dataEdited = false;
+
+    bool m_secretsEdited = false;
 };
 
+constexpr OpenvpnConnection::Priv::Field OpenvpnConnection::Priv::DATA_FIELDS[];
+
+constexpr OpenvpnConnection::Priv::Field OpenvpnConnection::Priv::SECRET_FIELDS[];
+
 OpenvpnConnection::OpenvpnConnection() :
         d(new Priv(*this))
 {
@@ -782,40 +811,24 @@ OpenvpnConnection::~OpenvpnConnection()
 
 void OpenvpnConnection::updateData(const QStringMap& data)
 {
+    Priv::dataSchema().apply(data, d->m_data, *this);
+
     // Basic properties
 
-    d->updateCa(data);
-    d->updateCert(data);
     d->updateConnectionType(data);
-    d->updateKey(data);
-    d->updateLocalIp(data);
-    d->updateRemote(data);
-    d->updateRemoteIp(data);
-    d->updateStaticKey(data);
     d->updateStaticKeyDirection(data);
-    d->updateUsername(data);
 
     // Advanced general properties
 
-    d->updatePort(data);
-    d->updateRenegSeconds(data);
-    d->updateCompLzo(data);
-    d->updateProtoTcp(data);
     d->updateDevType(data);
-    d->updateTunnelMtu(data);
-    d->updateFragmentSize(data);
-    d->updateMssFix(data);
-    d->updateRemoteRandom(data);
 
     // Advanced security properties
 
     d->updateCipher(data);
-    d->updateKeysize(data);
     d->updateAuth(data);
 
     // Advanced TLS auth properties
 
-    d->updateTlsRemote(data);
     d->updateRemoteCertTls(data);
     d->updateTa(data);
 
@@ -826,14 +839,29 @@ void OpenvpnConnection::updateData(const QStringMap& data)
 
 void OpenvpnConnection::updateSecrets(const QStringMap& secrets)
 {
-    d->updateCertPass(secrets);
-    d->updatePassword(secrets);
+    Priv::secretsSchema().apply(secrets, d->m_data, *this);
     d->updateProxySecrets(secrets);
 }
 
+QStringMap OpenvpnConnection::takePendingVpnData()
+{
+    d->m_dataEdited = false;
+    return d->m_pendingData.buildData();
+}
+
+QStringMap OpenvpnConnection::takePendingVpnSecrets()
+{
+    d->m_secretsEdited = false;
+    return d->m_pendingData.buildSecrets();
+}
+
 void OpenvpnConnection::markClean()
 {
-    d->m_dirty = false;
+    // Edits made while the last ones were being written are still pending
+    if (!d->m_dataEdited && !d->m_secretsEdited)
+    {
+        d->m_dirty = false;
+    }
 }
 
 // Basic properties
@@ -111,6 +111,13 @@ public:
 
     ~OpenvpnConnection();
 
+    /**
+     * Builds the settings maps from the edits made so far.
+     */
+    QMap<QString, QString> takePendingVpnData();
+
+    QMap<QString, QString> takePendingVpnSecrets();
+
     // Basic properties
 
     Q_PROPERTY(QString ca READ ca WRITE setCa NOTIFY caChanged)
@@ -354,9 +361,10 @@ public Q_SLOTS:
     void setProxyPassword(const QString &value);
 
 Q_SIGNALS:
-    void updateVpnData(const QMap<QString, QString>& vpnData);
+    // Emitted once for the first of a series of edits, until the maps are taken
+    void vpnDataEdited();
 
-    void updateVpnSecrets(const QMap<QString, QString>& vpnSecrets);
+    void vpnSecretsEdited();
 
     // Basic properties
 
@@ -18,6 +18,7 @@
  */
 
 #include <nmofono/vpn/pptp-connection.h>
+#include <nmofono/vpn/settings-field.h>
 
 #include <NetworkManagerSettingsConnectionInterface.h>
 
@@ -34,74 +35,43 @@ void set##uppername(type value)\
     Q_EMIT p.name##Changed(m_data.m_##name);\
 }
 
-#define DEFINE_UPDATE_PROPERTY_STRING(name, uppername, strname) \
-void update##uppername(const QStringMap& data)\
-{\
-    set##uppername(data.value(strname));\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, const QString &)
-
-#define DEFINE_UPDATE_PROPERTY_ANTIBOOL(name, uppername, strname) \
-void update##uppername(const QStringMap& data)\
-{\
-    set##uppername(data.value(strname) != "yes");\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, bool)
-
-#define DEFINE_UPDATE_PROPERTY_PAIR(name, uppername, strname, type, conversion)\
-void update##uppername(const QStringMap& data)\
-{\
-    auto it = data.constFind(strname);\
-    bool found = (it != data.constEnd());\
-    set##uppername##Set(found);\
-    if (found)\
-    {\
-        set##uppername(it->conversion);\
-    }\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, type)\
-\
-DEFINE_UPDATE_SETTER(name##Set, uppername##Set, bool)\
-
 #define DEFINE_PROPERTY_GETTER(name,type) \
 type PptpConnection::name() const\
 {\
     return d->m_data.m_##name;\
 }\
 
+// Only the field is recorded, the maps are built once when the edits are written
 #define DEFINE_PROPERTY_SETTER(varname, uppername, type) \
 void PptpConnection::set##uppername(type value)\
 {\
-    if (d->m_data.m_##varname == value)\
+    if (d->current().m_##varname == value)\
     {\
         return;\
     }\
-    if (!d->m_dirty)\
+    d->beginEdit();\
+    d->m_pendingData.m_##varname = value;\
+    if (!d->m_dataEdited)\
     {\
-        d->m_pendingData = d->m_data;\
+        d->m_dataEdited = true;\
+        Q_EMIT vpnDataEdited();\
     }\
-    d->m_dirty = true;\
-    d->m_pendingData.m_##varname = value;\
-    Q_EMIT updateVpnData(d->m_pendingData.buildData());\
 }
 
 #define DEFINE_SECRET_PROPERTY_SETTER(varname, uppername, type) \
 void PptpConnection::set##uppername(type value)\
 {\
-    if (d->m_data.m_##varname == value)\
+    if (d->current().m_##varname == value)\
     {\
         return;\
     }\
-    if (!d->m_dirty)\
+    d->beginEdit();\
+    d->m_pendingData.m_##varname = value;\
+    if (!d->m_secretsEdited)\
     {\
-        d->m_pendingData = d->m_data;\
+        d->m_secretsEdited = true;\
+        Q_EMIT vpnSecretsEdited();\
     }\
-    d->m_dirty = true;\
-    d->m_pendingData.m_##varname = value;\
-    Q_EMIT updateVpnSecrets(d->m_pendingData.buildSecrets());\
 }
 
 namespace nmofono
@@ -269,20 +239,49 @@ public:
     {
     }
 
-    // Basic properties
+    typedef SettingsField<Data, PptpConnection> Field;
 
-    DEFINE_UPDATE_PROPERTY_STRING(gateway, Gateway, "gateway")
-    DEFINE_UPDATE_PROPERTY_STRING(user, User, "user")
-    DEFINE_UPDATE_PROPERTY_STRING(password, Password, "password")
-    DEFINE_UPDATE_PROPERTY_STRING(domain, Domain, "domain")
+    // The keys that map straight onto one property, the rest are below
 
-    // Advanced properties
+    static constexpr Field DATA_FIELDS[] =
+    {
+        // Basic properties
+
+        Field::text("gateway", &Data::m_gateway, &PptpConnection::gatewayChanged),
+        Field::text("user", &Data::m_user, &PptpConnection::userChanged),
+        Field::text("domain", &Data::m_domain, &PptpConnection::domainChanged),
+
+        // Advanced properties
+
+        Field::refusal("refuse-pap", &Data::m_allowPap, &PptpConnection::allowPapChanged),
+        Field::refusal("refuse-chap", &Data::m_allowChap, &PptpConnection::allowChapChanged),
+        Field::refusal("refuse-mschap", &Data::m_allowMschap, &PptpConnection::allowMschapChanged),
+        Field::refusal("refuse-mschapv2", &Data::m_allowMschapv2, &PptpConnection::allowMschapv2Changed),
+        Field::refusal("refuse-eap", &Data::m_allowEap, &PptpConnection::allowEapChanged),
+        Field::flag("mppe-stateful", &Data::m_mppeStateful, &PptpConnection::mppeStatefulChanged),
+        Field::refusal("nobsdcomp", &Data::m_bsdCompression, &PptpConnection::bsdCompressionChanged),
+        Field::refusal("nodeflate", &Data::m_deflateCompression, &PptpConnection::deflateCompressionChanged),
+        Field::refusal("no-vj-comp", &Data::m_tcpHeaderCompression, &PptpConnection::tcpHeaderCompressionChanged)
+    };
+
+    static constexpr Field SECRET_FIELDS[] =
+    {
+        Field::text("password", &Data::m_password, &PptpConnection::passwordChanged)
+    };
+
+    static const SettingsSchema<Data, PptpConnection>& dataSchema()
+    {
+        static const SettingsSchema<Data, PptpConnection> schema(DATA_FIELDS);
+        return schema;
+    }
 
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(allowPap, AllowPap, "refuse-pap")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(allowChap, AllowChap, "refuse-chap")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(allowMschap, AllowMschap, "refuse-mschap")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(allowMschapv2, AllowMschapv2, "refuse-mschapv2")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(allowEap, AllowEap, "refuse-eap")
+    static const SettingsSchema<Data, PptpConnection>& secretsSchema()
+    {
+        static const SettingsSchema<Data, PptpConnection> schema(SECRET_FIELDS);
+        return schema;
+    }
+
+    // Advanced properties
 
     void updateMppe(const QStringMap& data)
     {
@@ -319,15 +318,9 @@ public:
         {
             setMppeType(mppeType);
         }
-        setMppeStateful(data.value("mppe-stateful") == "yes");
     }
     DEFINE_UPDATE_SETTER(requireMppe, RequireMppe, bool)
     DEFINE_UPDATE_SETTER(mppeType, MppeType, PptpConnection::MppeType)
-    DEFINE_UPDATE_SETTER(mppeStateful, MppeStateful, bool)
-
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(bsdCompression, BsdCompression, "nobsdcomp")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(deflateCompression, DeflateCompression, "nodeflate")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(tcpHeaderCompression, TcpHeaderCompression, "no-vj-comp")
 
     void updateSendPppEchoPackets(const QStringMap& data)
     {
@@ -335,6 +328,21 @@ public:
     }
     DEFINE_UPDATE_SETTER(sendPppEchoPackets, SendPppEchoPackets, bool)
 
+    // The values the next edit is compared against
+    const Data& current() const
+    {
+        return m_dirty ? m_pendingData : m_data;
+    }
+
+    void beginEdit()
+    {
+        if (!m_dirty)
+        {
+            m_pendingData = m_data;
+            m_dirty = true;
+        }
+    }
+
     PptpConnection& p;
 
     Data m_data;
@@ -342,8 +350,17 @@ public:
     Data m_pendingData;
 
     bool m_dirty = false;
+
+    // Edited since the last time the maps were taken
+    bool m_dataEdited = false;
+
+    bool m_secretsEdited = false;
 };
 
+constexpr PptpConnection::Priv::Field PptpConnection::Priv::DATA_FIELDS[];
+
+constexpr PptpConnection::Priv::Field PptpConnection::Priv::SECRET_FIELDS[];
+
 PptpConnection::PptpConnection() :
         d(new Priv(*this))
 {
@@ -355,35 +372,38 @@ PptpConnection::~PptpConnection()
 
 void PptpConnection::updateData(const QStringMap& data)
 {
-    // Basic properties
-
-    d->updateGateway(data);
-    d->updateUser(data);
-    d->updateDomain(data);
+    Priv::dataSchema().apply(data, d->m_data, *this);
 
     // Advanced properties
 
-    d->updateAllowPap(data);
-    d->updateAllowChap(data);
-    d->updateAllowMschap(data);
-    d->updateAllowMschapv2(data);
-    d->updateAllowEap(data);
     d->updateMppe(data);
-    d->updateBsdCompression(data);
-    d->updateDeflateCompression(data);
-    d->updateTcpHeaderCompression(data);
     d->updateSendPppEchoPackets(data);
-
 }
 
 void PptpConnection::updateSecrets(const QStringMap& secrets)
 {
-    d->updatePassword(secrets);
+    Priv::secretsSchema().apply(secrets, d->m_data, *this);
+}
+
+QStringMap PptpConnection::takePendingVpnData()
+{
+    d->m_dataEdited = false;
+    return d->m_pendingData.buildData();
+}
+
+QStringMap PptpConnection::takePendingVpnSecrets()
+{
+    d->m_secretsEdited = false;
+    return d->m_pendingData.buildSecrets();
 }
 
 void PptpConnection::markClean()
 {
-    d->m_dirty = false;
+    // Edits made while the last ones were being written are still pending
+    if (!d->m_dataEdited && !d->m_secretsEdited)
+    {
+        d->m_dirty = false;
+    }
 }
 
 // Basic properties
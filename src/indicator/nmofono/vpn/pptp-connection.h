@@ -49,6 +49,13 @@ public:
 
     ~PptpConnection();
 
+    /**
+     * Builds the settings maps from the edits made so far.
+     */
+    QMap<QString, QString> takePendingVpnData();
+
+    QMap<QString, QString> takePendingVpnSecrets();
+
     // Basic properties
 
     Q_PROPERTY(QString gateway READ gateway WRITE setGateway NOTIFY gatewayChanged)
@@ -145,9 +152,10 @@ public Q_SLOTS:
     void setSendPppEchoPackets(bool value);
 
 Q_SIGNALS:
-    void updateVpnData(const QMap<QString, QString>& vpnData);
+    // Emitted once for the first of a series of edits, until the maps are taken
+    void vpnDataEdited();
 
-    void updateVpnSecrets(const QMap<QString, QString>& vpnSecrets);
+    void vpnSecretsEdited();
 
     // Basic properties
 
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <dbus-types.h>
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+#include <vector>
+
+namespace nmofono
+{
+namespace vpn
+{
+
+/**
+ * Describes how one key of a VPN plugin's data or secrets map is stored in
+ * a connection's Data struct, and which signal announces a change to it.
+ *
+ * Fields whose value depends on other keys (enums, or keys only read when
+ * another one is present) are not described, and keep their own updaters.
+ */
+template<typename Data, typename Owner>
+struct SettingsField
+{
+    enum class Format
+    {
+        // The value as it is
+        text,
+        // True when set to "yes"
+        flag,
+        // False when set to "yes", e.g. "refuse-pap"
+        refusal,
+        // An integer, and whether the key is present at all
+        number
+    };
+
+    const char* key;
+
+    Format format;
+
+    QString Data::* textMember;
+
+    void (Owner::* textChanged)(const QString&);
+
+    bool Data::* flagMember;
+
+    void (Owner::* flagChanged)(bool);
+
+    int Data::* numberMember;
+
+    void (Owner::* numberChanged)(int);
+
+    static constexpr SettingsField text(const char* key, QString Data::* member,
+                                        void (Owner::* changed)(const QString&))
+    {
+        return {key, Format::text, member, changed, nullptr, nullptr, nullptr, nullptr};
+    }
+
+    static constexpr SettingsField flag(const char* key, bool Data::* member,
+                                        void (Owner::* changed)(bool))
+    {
+        return {key, Format::flag, nullptr, nullptr, member, changed, nullptr, nullptr};
+    }
+
+    static constexpr SettingsField refusal(const char* key, bool Data::* member,
+                                           void (Owner::* changed)(bool))
+    {
+        return {key, Format::refusal, nullptr, nullptr, member, changed, nullptr, nullptr};
+    }
+
+    /**
+     * The flag member records whether the key is present. When it is not,
+     * the number keeps its last value.
+     */
+    static constexpr SettingsField number(const char* key, int Data::* member,
+                                          void (Owner::* changed)(int),
+                                          bool Data::* setMember,
+                                          void (Owner::* setChanged)(bool))
+    {
+        return {key, Format::number, nullptr, nullptr, setMember, setChanged, member, changed};
+    }
+
+    /**
+     * Stores the value (or nullptr if the key is absent), announcing it
+     * only if it differs from what is already there.
+     */
+    void assign(const QString* value, Data& data, Owner& owner) const
+    {
+        switch (format)
+        {
+            case Format::text:
+                update(data.*textMember, value ? *value : QString(), owner, textChanged);
+                break;
+            case Format::flag:
+                update(data.*flagMember, value && *value == "yes", owner, flagChanged);
+                break;
+            case Format::refusal:
+                update(data.*flagMember, !(value && *value == "yes"), owner, flagChanged);
+                break;
+            case Format::number:
+                update(data.*flagMember, value != nullptr, owner, flagChanged);
+                if (value)
+                {
+                    update(data.*numberMember, value->toInt(), owner, numberChanged);
+                }
+                break;
+        }
+    }
+
+private:
+    template<typename T, typename Arg>
+    static void update(T& member, const T& value, Owner& owner, void (Owner::* changed)(Arg))
+    {
+        if (member == value)
+        {
+            return;
+        }
+        member = value;
+        Q_EMIT (owner.*changed)(member);
+    }
+};
+
+/**
+ * Applies an incoming map to every described field in a single pass over
+ * the map, rather than looking each field's key up in turn.
+ */
+template<typename Data, typename Owner>
+class SettingsSchema
+{
+public:
+    typedef SettingsField<Data, Owner> Field;
+
+    template<std::size_t N>
+    SettingsSchema(const Field (&fields)[N]) :
+        m_fields(fields),
+        m_count(N)
+    {
+        m_index.reserve(N);
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            m_index.insert(QString::fromLatin1(fields[i].key), i);
+        }
+    }
+
+    void apply(const QStringMap& map, Data& data, Owner& owner) const
+    {
+        std::vector<bool> seen(m_count, false);
+
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it)
+        {
+            auto index = m_index.constFind(it.key());
+            if (index == m_index.constEnd())
+            {
+                continue;
+            }
+            seen[*index] = true;
+            m_fields[*index].assign(&it.value(), data, owner);
+        }
+
+        // Keys that have gone from the map take their absent value
+        for (std::size_t i = 0; i < m_count; ++i)
+        {
+            if (!seen[i])
+            {
+                m_fields[i].assign(nullptr, data, owner);
+            }
+        }
+    }
+
+private:
+    const Field* m_fields;
+
+    std::size_t m_count;
+
+    QHash<QString, std::size_t> m_index;
+};
+
+}
+}
@@ -22,6 +22,8 @@
 #include <nmofono/vpn/vpn-connection.h>
 #include <NetworkManagerSettingsConnectionInterface.h>
 
+#include <algorithm>
+
 using namespace std;
 
 namespace nmofono
@@ -183,17 +185,55 @@ public:
 
     void setDirty()
     {
-        if (m_dirty)
+        // Writes are never overlapped, the reply starts the next one
+        if (m_dirty || m_updatePending)
         {
             return;
         }
 
         m_dirty = true;
-        m_pendingSettings = m_settings;
-
         m_dispatchPendingSettingsTimer.start();
     }
 
+    void editSetting(const QString& group, const QString& key, const QVariant& value)
+    {
+        m_pendingChanges[group][key] = value;
+        setDirty();
+    }
+
+    bool hasPendingEdits() const
+    {
+        return !m_pendingChanges.isEmpty() || m_vpnDataEdited || m_vpnSecretsEdited;
+    }
+
+    QStringMap takePendingVpnData()
+    {
+        m_vpnDataEdited = false;
+        if (m_openvpnConnection)
+        {
+            return m_openvpnConnection->takePendingVpnData();
+        }
+        if (m_pptpConnection)
+        {
+            return m_pptpConnection->takePendingVpnData();
+        }
+        return QStringMap();
+    }
+
+    QStringMap takePendingVpnSecrets()
+    {
+        m_vpnSecretsEdited = false;
+        if (m_openvpnConnection)
+        {
+            return m_openvpnConnection->takePendingVpnSecrets();
+        }
+        if (m_pptpConnection)
+        {
+            return m_pptpConnection->takePendingVpnSecrets();
+        }
+        return QStringMap();
+    }
+
 Q_SIGNALS:
     void updateData(const QStringMap& data);
     void updateSecrets(const QStringMap& secrets);
@@ -202,28 +242,119 @@ Q_SIGNALS:
 public Q_SLOTS:
     void dispatchPendingSettings()
     {
-        auto reply = m_connection->Update(m_pendingSettings);
-        reply.waitForFinished();
-        if (reply.isError())
+        m_dirty = false;
+
+        // Only the edited fields are applied, and only if they differ
+        auto settings = m_settings;
+        bool changed = false;
+        for (auto group = m_pendingChanges.cbegin(); group != m_pendingChanges.cend(); ++group)
         {
-            qWarning() << reply.error().message() << m_pendingSettings;
+            for (auto it = group->cbegin(); it != group->cend(); ++it)
+            {
+                if (settings[group.key()].value(it.key()) != it.value())
+                {
+                    settings[group.key()][it.key()] = it.value();
+                    changed = true;
+                }
+            }
         }
+        m_pendingChanges.clear();
 
-        m_dirty = false;
+        if (m_vpnDataEdited)
+        {
+            auto vpnData = takePendingVpnData();
+            if (vpnData != m_settings.value("vpn").value("data").value<QStringMap>())
+            {
+                settings["vpn"]["data"] = QVariant::fromValue(vpnData);
+                changed = true;
+            }
+        }
 
-        Q_EMIT settingsDispatched();
+        // NetworkManager doesn't hand secrets back, so they can't be compared
+        bool writeSecrets = m_vpnSecretsEdited;
+        QStringMap secrets;
+        if (writeSecrets)
+        {
+            secrets = takePendingVpnSecrets();
+            settings["vpn"]["secrets"] = QVariant::fromValue(secrets);
+            changed = true;
+        }
+
+        if (!changed)
+        {
+            Q_EMIT settingsDispatched();
+            return;
+        }
+
+        m_updatePending = true;
+        m_updatedDuringWrite = 0;
+        auto watcher(new QDBusPendingCallWatcher(m_connection->Update(settings), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [this, settings, writeSecrets, secrets](QDBusPendingCallWatcher *call)
+                {
+                    call->deleteLater();
+                    m_updatePending = false;
+                    int updated = m_updatedDuringWrite;
+                    m_updatedDuringWrite = 0;
+
+                    QDBusPendingReply<> reply = *call;
+                    if (reply.isError())
+                    {
+                        qWarning() << reply.error().message() << settings;
+                        // Nothing of ours was stored, re-read what is
+                        settingsUpdated();
+                    }
+                    else
+                    {
+                        // Apply what we wrote rather than asking for it back
+                        auto written = settings;
+                        written["vpn"].remove("secrets");
+                        applySettings(written);
+                        if (writeSecrets)
+                        {
+                            Q_EMIT updateSecrets(secrets);
+                        }
+
+                        // Exactly one Updated is the echo of our own write.
+                        // Any other count means someone else wrote too, or
+                        // the echo is still to come, so re-read to be sure.
+                        if (updated != 1)
+                        {
+                            settingsUpdated();
+                        }
+                    }
+
+                    Q_EMIT settingsDispatched();
+
+                    if (hasPendingEdits())
+                    {
+                        setDirty();
+                    }
+                });
     }
 
-    void updateVpnData(const QStringMap &vpnData)
+    void vpnDataEdited()
     {
+        m_vpnDataEdited = true;
         setDirty();
-        m_pendingSettings["vpn"]["data"] = QVariant::fromValue(vpnData);
     }
 
-    void updateVpnSecrets(const QStringMap &secrets)
+    void vpnSecretsEdited()
     {
+        m_vpnSecretsEdited = true;
         setDirty();
-        m_pendingSettings["vpn"]["secrets"] = QVariant::fromValue(secrets);
+    }
+
+    void settingsChanged()
+    {
+        // Settled when the write's reply arrives
+        if (m_updatePending)
+        {
+            ++m_updatedDuringWrite;
+            return;
+        }
+
+        settingsUpdated();
     }
 
     void secretsUpdated()
@@ -233,14 +364,37 @@ public Q_SLOTS:
             return;
         }
 
-        auto reply = m_connection->GetSecrets("vpn");
-        reply.waitForFinished();
+        if (m_secretsPending)
+        {
+            // The request in flight may predate what changed
+            m_secretsRefetch = true;
+            return;
+        }
+
+        m_secretsPending = true;
+        auto watcher(new QDBusPendingCallWatcher(m_connection->GetSecrets("vpn"), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, &Priv::secretsFetched);
+    }
+
+    void secretsFetched(QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+        m_secretsPending = false;
+
+        if (m_secretsRefetch)
+        {
+            m_secretsRefetch = false;
+            secretsUpdated();
+        }
+
+        QDBusPendingReply<QVariantDictMap> reply = *call;
         if (reply.isError())
         {
             qWarning() << reply.error().message();
             return;
         }
 
+        m_secretsKnown = true;
         QVariantDictMap vpnSecrets = reply;
 
         QStringMap secrets;
@@ -256,26 +410,42 @@ public Q_SLOTS:
 
     void settingsUpdated()
     {
-        auto reply = m_connection->GetSettings();
+        auto watcher(new QDBusPendingCallWatcher(m_connection->GetSettings(), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, &Priv::settingsFetched);
+    }
+
+    void settingsFetched(QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
 
-        reply.waitForFinished();
+        QDBusPendingReply<QVariantDictMap> reply = *call;
         if (reply.isError())
         {
             qWarning() << reply.error().message();
             return;
         }
 
-        m_settings = reply;
+        applySettings(reply.value());
+    }
+
+    void applySettings(const QVariantDictMap& settings)
+    {
+        m_settings = settings;
 
         QStringMap vpnData;
-        // Encourage Qt to decode the nested map
         auto v = m_settings.value("vpn").value("data");
-        if (v.isValid())
+        if (v.canConvert<QDBusArgument>())
         {
+            // Encourage Qt to decode the nested map
             auto dbusArgument = qvariant_cast<QDBusArgument>(v);
             dbusArgument >> vpnData;
             m_settings["vpn"]["data"] = QVariant::fromValue(vpnData);
         }
+        else
+        {
+            // Settings we wrote ourselves are already decoded
+            vpnData = v.value<QStringMap>();
+        }
 
         updateId();
         updateNeverDefault();
@@ -288,30 +458,19 @@ public Q_SLOTS:
         }
     }
 
-    void activeConnectionsUpdated(const QSet<connection::ActiveConnection::SPtr>& activeConnections)
+    void activeConnectionChanged(connection::ActiveConnection::SPtr activeConnection)
     {
-        connection::ActiveConnection::SPtr activeConnection;
-
-        QDBusObjectPath path(m_connection->path());
-
-        // Search for the active connection
-        for (const auto& con : activeConnections)
+        if (m_activeConnection)
         {
-            // Connection to all signals on all active connections
-            connect(con.get(), &connection::ActiveConnection::connectionPathChanged, this, &Priv::connectionUpdated);
-            connect(con.get(), &connection::ActiveConnection::stateChanged, this, &Priv::connectionUpdated);
-            connect(con.get(), &connection::ActiveConnection::typeChanged, this, &Priv::connectionUpdated);
-
-            if (con->connectionPath() == path)
-            {
-                activeConnection = con;
-                break;
-            }
+            m_activeConnection->disconnect(this);
         }
+        m_activeConnection = activeConnection;
 
-        if (activeConnection)
+        if (m_activeConnection)
         {
-            _connectionUpdated(*activeConnection);
+            connect(m_activeConnection.get(), &connection::ActiveConnection::stateChanged, this, &Priv::connectionUpdated);
+            connect(m_activeConnection.get(), &connection::ActiveConnection::typeChanged, this, &Priv::connectionUpdated);
+            _connectionUpdated(*m_activeConnection);
         }
         else
         {
@@ -323,8 +482,10 @@ public Q_SLOTS:
 
     void connectionUpdated()
     {
-        auto activeConnection = qobject_cast<connection::ActiveConnection*>(sender());
-        _connectionUpdated(*activeConnection);
+        if (m_activeConnection)
+        {
+            _connectionUpdated(*m_activeConnection);
+        }
     }
 
 public:
@@ -334,11 +495,25 @@ public:
 
     connection::ActiveConnectionManager::SPtr m_activeConnectionManager;
 
+    connection::ActiveConnectionWatch::SPtr m_activeConnectionWatch;
+
+    connection::ActiveConnection::SPtr m_activeConnection;
+
     QVariantDictMap m_settings;
 
     bool m_dirty = false;
 
-    QVariantDictMap m_pendingSettings;
+    // Fields edited outside of the VPN data and secrets
+    QVariantDictMap m_pendingChanges;
+
+    bool m_vpnDataEdited = false;
+
+    bool m_vpnSecretsEdited = false;
+
+    bool m_updatePending = false;
+
+    // Updated signals that arrived while our write was in flight
+    int m_updatedDuringWrite = 0;
 
     QTimer m_dispatchPendingSettingsTimer;
 
@@ -350,6 +525,13 @@ public:
 
     bool m_valid = false;
 
+    bool m_secretsKnown = false;
+
+    bool m_secretsPending = false;
+
+    // Someone asked for the secrets again while a request was in flight
+    bool m_secretsRefetch = false;
+
     Type m_type;
 
     bool m_active = false;
@@ -371,6 +553,7 @@ public:
 
 VpnConnection::VpnConnection(
         const QDBusObjectPath& path,
+        const QVariantDictMap& settings,
         connection::ActiveConnectionManager::SPtr activeConnectionManager,
         const QDBusConnection& systemConnection) :
         d(new Priv(*this))
@@ -384,17 +567,18 @@ VpnConnection::VpnConnection(
 
     d->m_activeConnectionManager = activeConnectionManager;
 
-    d->settingsUpdated();
+    d->applySettings(settings);
     d->updateUuid();
-    connect(d->m_connection.get(), &OrgFreedesktopNetworkManagerSettingsConnectionInterface::Updated, d.get(), &Priv::settingsUpdated);
+    connect(d->m_connection.get(), &OrgFreedesktopNetworkManagerSettingsConnectionInterface::Updated, d.get(), &Priv::settingsChanged);
 
     if (!isValid())
     {
         return;
     }
 
-    d->activeConnectionsUpdated(d->m_activeConnectionManager->connections());
-    connect(d->m_activeConnectionManager.get(), &connection::ActiveConnectionManager::connectionsChanged, d.get(), &Priv::activeConnectionsUpdated);
+    d->m_activeConnectionWatch = d->m_activeConnectionManager->watch(path);
+    connect(d->m_activeConnectionWatch.get(), &connection::ActiveConnectionWatch::activeConnectionChanged, d.get(), &Priv::activeConnectionChanged);
+    d->activeConnectionChanged(d->m_activeConnectionWatch->activeConnection());
 
     switch (d->m_type)
     {
@@ -404,8 +588,8 @@ VpnConnection::VpnConnection(
             connect(d.get(), &Priv::updateData, d->m_openvpnConnection.get(), &OpenvpnConnection::updateData);
             connect(d.get(), &Priv::updateSecrets, d->m_openvpnConnection.get(), &OpenvpnConnection::updateSecrets);
             connect(d.get(), &Priv::settingsDispatched, d->m_openvpnConnection.get(), &OpenvpnConnection::markClean);
-            connect(d->m_openvpnConnection.get(), &OpenvpnConnection::updateVpnData, d.get(), &Priv::updateVpnData);
-            connect(d->m_openvpnConnection.get(), &OpenvpnConnection::updateVpnSecrets, d.get(), &Priv::updateVpnSecrets);
+            connect(d->m_openvpnConnection.get(), &OpenvpnConnection::vpnDataEdited, d.get(), &Priv::vpnDataEdited);
+            connect(d->m_openvpnConnection.get(), &OpenvpnConnection::vpnSecretsEdited, d.get(), &Priv::vpnSecretsEdited);
             break;
         case Type::pptp:
             d->m_pptpConnection = make_shared<PptpConnection>();
@@ -413,8 +597,8 @@ VpnConnection::VpnConnection(
             connect(d.get(), &Priv::updateData, d->m_pptpConnection.get(), &PptpConnection::updateData);
             connect(d.get(), &Priv::updateSecrets, d->m_pptpConnection.get(), &PptpConnection::updateSecrets);
             connect(d.get(), &Priv::settingsDispatched, d->m_pptpConnection.get(), &PptpConnection::markClean);
-            connect(d->m_pptpConnection.get(), &PptpConnection::updateVpnData, d.get(), &Priv::updateVpnData);
-            connect(d->m_pptpConnection.get(), &PptpConnection::updateVpnSecrets, d.get(), &Priv::updateVpnSecrets);
+            connect(d->m_pptpConnection.get(), &PptpConnection::vpnDataEdited, d.get(), &Priv::vpnDataEdited);
+            connect(d->m_pptpConnection.get(), &PptpConnection::vpnSecretsEdited, d.get(), &Priv::vpnSecretsEdited);
             break;
         default:
             break;
@@ -463,25 +647,24 @@ void VpnConnection::setActive(bool active)
 
 void VpnConnection::setId(const QString& id)
 {
-    if (d->m_id == id)
+    // A pending edit may still need to be undone
+    if (d->m_id == id && !d->m_pendingChanges.value("connection").contains("id"))
     {
         return;
     }
 
-    d->setDirty();
-    d->m_pendingSettings["connection"]["id"] = id;
+    d->editSetting("connection", "id", id);
 }
 
 void VpnConnection::setNeverDefault(bool neverDefault)
 {
-    if (d->m_neverDefault == neverDefault)
+    if (d->m_neverDefault == neverDefault && !d->m_pendingChanges.value("ipv4").contains("never-default"))
     {
         return;
     }
 
-    d->setDirty();
-    d->m_pendingSettings["ipv4"]["never-default"] = neverDefault;
-    d->m_pendingSettings["ipv6"]["never-default"] = neverDefault;
+    d->editSetting("ipv4", "never-default", neverDefault);
+    d->editSetting("ipv6", "never-default", neverDefault);
 }
 
 void VpnConnection::setOtherConnectionIsBusy(bool otherConnectionIsBusy)
@@ -501,6 +684,16 @@ void VpnConnection::updateSecrets()
     d->secretsUpdated();
 }
 
+void VpnConnection::requestSecrets()
+{
+    if (d->m_secretsKnown)
+    {
+        return;
+    }
+
+    d->secretsUpdated();
+}
+
 void VpnConnection::remove()
 {
     d->m_connection->Delete();
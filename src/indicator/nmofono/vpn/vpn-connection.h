@@ -28,6 +28,7 @@
 #include <nmofono/connection/active-connection-manager.h>
 #include <nmofono/vpn/openvpn-connection.h>
 #include <nmofono/vpn/pptp-connection.h>
+#include <dbus-types.h>
 
 #include <unity/util/DefinesPtrs.h>
 
@@ -49,7 +50,14 @@ public:
         pptp
     };
 
-    VpnConnection(const QDBusObjectPath& path, connection::ActiveConnectionManager::SPtr activeConnectionManager, const QDBusConnection& systemConnection);
+    /**
+     * The settings are the connection's already fetched GetSettings()
+     * reply, so construction does not need to call NetworkManager.
+     */
+    VpnConnection(const QDBusObjectPath& path,
+                  const QVariantDictMap& settings,
+                  connection::ActiveConnectionManager::SPtr activeConnectionManager,
+                  const QDBusConnection& systemConnection);
 
     ~VpnConnection() = default;
 
@@ -88,6 +96,12 @@ public Q_SLOTS:
 
     void updateSecrets();
 
+    /**
+     * Fetches the secrets the first time they are needed. Does nothing
+     * if they are already known or on their way.
+     */
+    void requestSecrets();
+
     void remove();
 
 Q_SIGNALS:
@@ -20,7 +20,10 @@
 #include <nmofono/vpn/vpn-manager.h>
 #include <util/localisation.h>
 #include <NetworkManager.h>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
 #include <QMap>
+#include <QSet>
 
 #include <NetworkManagerInterface.h>
 #include <NetworkManagerSettingsInterface.h>
@@ -42,9 +45,58 @@ public:
     {
     }
 
-    void _newConnection(const QDBusObjectPath &path, bool shouldUpdateActiveAndBusy)
+    /**
+     * Fetches the settings without building a proxy object, as most saved
+     * connections are not VPNs and are dropped as soon as they arrive.
+     */
+    void classifyConnection(const QDBusObjectPath& path)
     {
-        auto connection = make_shared<VpnConnection>(path, m_activeConnectionManager, m_settingsInterface->connection());
+        if (m_connections.contains(path) || m_classifying.contains(path))
+        {
+            return;
+        }
+        m_classifying << path;
+
+        auto message = QDBusMessage::createMethodCall(NM_DBUS_SERVICE, path.path(),
+                                                      NM_DBUS_INTERFACE_SETTINGS_CONNECTION,
+                                                      "GetSettings");
+        auto watcher(new QDBusPendingCallWatcher(m_settingsInterface->connection().asyncCall(message), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [this, path](QDBusPendingCallWatcher *call)
+                {
+                    connectionClassified(path, call);
+                });
+    }
+
+    void connectionClassified(const QDBusObjectPath& path, QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        if (!m_classifying.remove(path))
+        {
+            // Removed while we were waiting for the settings
+            return;
+        }
+
+        QDBusPendingReply<QVariantDictMap> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get settings for" << path.path() << ":" << reply.error().message();
+            return;
+        }
+
+        auto settings = reply.value();
+        if (settings.value("connection").value("type").toString() != "vpn")
+        {
+            return;
+        }
+
+        _newConnection(path, settings);
+    }
+
+    void _newConnection(const QDBusObjectPath &path, const QVariantDictMap& settings)
+    {
+        auto connection = make_shared<VpnConnection>(path, settings, m_activeConnectionManager, m_settingsInterface->connection());
         if (connection->isValid())
         {
             m_connections[path] = connection;
@@ -57,10 +109,7 @@ public:
             connect(this, &Priv::busyChanged, connection.get(), &VpnConnection::setOtherConnectionIsBusy);
             connect(this, &Priv::activeConnectionPathChanged, connection.get(), &VpnConnection::setActiveConnectionPath);
             Q_EMIT p.connectionsChanged();
-            if (shouldUpdateActiveAndBusy)
-            {
-                updateActiveAndBusy();
-            }
+            updateActiveAndBusy();
         }
     }
 
@@ -97,6 +146,8 @@ Q_SIGNALS:
 public Q_SLOTS:
     void connectionRemoved(const QDBusObjectPath &path)
     {
+        m_classifying.remove(path);
+
         auto connection = m_connections.take(path);
         if (connection)
         {
@@ -107,12 +158,30 @@ public Q_SLOTS:
 
     void newConnection(const QDBusObjectPath &path)
     {
-        _newConnection(path, true);
+        classifyConnection(path);
+    }
+
+    void connectionsListed(QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        QDBusPendingReply<QList<QDBusObjectPath>> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to list connections:" << reply.error().message();
+            return;
+        }
+
+        // All the requests go out before any reply is handled
+        for (const auto& path : reply.value())
+        {
+            classifyConnection(path);
+        }
     }
 
     void activateConnection(const QDBusObjectPath& connection)
     {
-        m_activeConnectionManager->activate(connection);
+        m_activeConnectionManager->activateAsync(connection);
     }
 
     void updateActiveAndBusy()
@@ -173,6 +242,9 @@ public:
 
     QMap<QDBusObjectPath, VpnConnection::SPtr> m_connections;
 
+    // Connections whose settings are being fetched to find out if they are VPNs
+    QSet<QDBusObjectPath> m_classifying;
+
     bool m_busy = false;
 
     QDBusObjectPath m_activeConnectionPath;
@@ -187,13 +259,11 @@ VpnManager::VpnManager(connection::ActiveConnectionManager::SPtr activeConnectio
     d->m_settingsInterface = make_shared<OrgFreedesktopNetworkManagerSettingsInterface>(
                 NM_DBUS_SERVICE, NM_DBUS_PATH_SETTINGS, systemConnection);
 
-    for (const auto& path : d->m_settingsInterface->connections())
-    {
-        d->_newConnection(path, false);
-    }
-    d->updateActiveAndBusy();
     connect(d->m_settingsInterface.get(), &OrgFreedesktopNetworkManagerSettingsInterface::NewConnection, d.get(), &Priv::newConnection);
     connect(d->m_settingsInterface.get(), &OrgFreedesktopNetworkManagerSettingsInterface::ConnectionRemoved, d.get(), &Priv::connectionRemoved);
+
+    auto watcher(new QDBusPendingCallWatcher(d->m_settingsInterface->ListConnections(), d.get()));
+    connect(watcher, &QDBusPendingCallWatcher::finished, d.get(), &Priv::connectionsListed);
 }
 
 QList<VpnConnection::SPtr> VpnManager::connections() const
@@ -256,12 +326,17 @@ QString VpnManager::addConnection(VpnConnection::Type type)
         {"method", "auto"}
     };
 
-    auto reply = d->m_settingsInterface->AddConnection(connection);
-    reply.waitForFinished();
-    if (reply.isError())
-    {
-        throw domain_error(reply.error().message().toStdString());
-    }
+    auto watcher(new QDBusPendingCallWatcher(d->m_settingsInterface->AddConnection(connection), d.get()));
+    connect(watcher, &QDBusPendingCallWatcher::finished, this,
+            [this, uuid](QDBusPendingCallWatcher *call)
+            {
+                call->deleteLater();
+                if (call->isError())
+                {
+                    qWarning() << "Failed to add VPN connection:" << call->error().message();
+                    Q_EMIT addConnectionFailed(uuid, call->error().message());
+                }
+            });
 
     return uuid;
 }
@@ -45,11 +45,18 @@ public:
 
     VpnConnection::SPtr connection(const QDBusObjectPath& path) const;
 
+    /**
+     * Returns the UUID of the new connection straight away. It appears in
+     * connectionsChanged once NetworkManager has added it, otherwise
+     * addConnectionFailed is emitted.
+     */
     QString addConnection(VpnConnection::Type type);
 
 Q_SIGNALS:
     void connectionsChanged();
 
+    void addConnectionFailed(const QString& uuid, const QString& message);
+
 protected:
     class Priv;
     std::shared_ptr<Priv> d;
@@ -72,7 +72,10 @@ public:
     friend struct Key;
 
 
-    AccessPointImpl(std::shared_ptr<OrgFreedesktopNetworkManagerAccessPointInterface> ap);
+    // properties is the result of a single GetAll on the AccessPoint
+    // interface, construction does not do any D-Bus round-trips.
+    AccessPointImpl(std::shared_ptr<OrgFreedesktopNetworkManagerAccessPointInterface> ap,
+                    const QVariantMap& properties);
     double strength() const override;
     virtual ~AccessPointImpl() = default;
 
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/wifi/access-point-registry.h>
+
+using namespace std;
+
+namespace nmofono
+{
+namespace wifi
+{
+
+bool
+AccessPointRegistry::contains(const QDBusObjectPath& path) const
+{
+    return m_accessPoints.contains(path);
+}
+
+AccessPointImpl::Ptr
+AccessPointRegistry::find(const QDBusObjectPath& path) const
+{
+    return m_accessPoints.value(path);
+}
+
+shared_ptr<GroupedAccessPoint>
+AccessPointRegistry::group(const QDBusObjectPath& path) const
+{
+    auto ap = find(path);
+    if (!ap)
+    {
+        return shared_ptr<GroupedAccessPoint>();
+    }
+
+    auto it = m_groups.find(AccessPointImpl::Key(ap));
+    if (it == m_groups.end())
+    {
+        return shared_ptr<GroupedAccessPoint>();
+    }
+    return it->second;
+}
+
+shared_ptr<GroupedAccessPoint>
+AccessPointRegistry::add(AccessPointImpl::Ptr ap)
+{
+    auto path = ap->object_path();
+    if (m_accessPoints.contains(path))
+    {
+        return group(path);
+    }
+    m_accessPoints.insert(path, ap);
+
+    AccessPointImpl::Key k(ap);
+    auto it = m_groups.find(k);
+    if (it != m_groups.end())
+    {
+        it->second->add_ap(ap);
+        return it->second;
+    }
+
+    auto grouped = make_shared<GroupedAccessPoint>(ap);
+    m_groups.emplace(k, grouped);
+    return grouped;
+}
+
+AccessPointImpl::Ptr
+AccessPointRegistry::remove(const QDBusObjectPath& path)
+{
+    auto ap = m_accessPoints.take(path);
+    if (!ap)
+    {
+        return ap;
+    }
+
+    auto it = m_groups.find(AccessPointImpl::Key(ap));
+    if (it != m_groups.end())
+    {
+        it->second->remove_ap(ap);
+        if (it->second->num_aps() == 0)
+        {
+            m_groups.erase(it);
+        }
+    }
+    return ap;
+}
+
+int
+AccessPointRegistry::size() const
+{
+    return m_accessPoints.size();
+}
+
+QSet<AccessPoint::Ptr>
+AccessPointRegistry::groups() const
+{
+    QSet<AccessPoint::Ptr> result;
+    result.reserve(m_groups.size());
+    for (const auto& i : m_groups)
+    {
+        result.insert(i.second);
+    }
+    return result;
+}
+
+}
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <nmofono/wifi/access-point-impl.h>
+#include <nmofono/wifi/grouped-access-point.h>
+
+#include <QDBusObjectPath>
+#include <QHash>
+#include <QSet>
+
+#include <map>
+#include <memory>
+
+namespace nmofono
+{
+namespace wifi
+{
+
+/**
+ * The raw access points of a Wi-Fi device, indexed by object path, and the
+ * groups they are merged into for display.
+ *
+ * Adding, removing and looking up an access point does not depend on how
+ * many others the device can see.
+ */
+class AccessPointRegistry
+{
+public:
+    bool contains(const QDBusObjectPath& path) const;
+
+    AccessPointImpl::Ptr find(const QDBusObjectPath& path) const;
+
+    /**
+     * The group the access point with the given path belongs to, or null.
+     */
+    std::shared_ptr<GroupedAccessPoint> group(const QDBusObjectPath& path) const;
+
+    /**
+     * Returns the group the access point was added to. If an access point
+     * with the same path is already known, nothing changes.
+     */
+    std::shared_ptr<GroupedAccessPoint> add(AccessPointImpl::Ptr ap);
+
+    /**
+     * Returns the removed access point, or null if it was not known.
+     */
+    AccessPointImpl::Ptr remove(const QDBusObjectPath& path);
+
+    int size() const;
+
+    QSet<AccessPoint::Ptr> groups() const;
+
+private:
+    QHash<QDBusObjectPath, AccessPointImpl::Ptr> m_accessPoints;
+
+    std::map<AccessPointImpl::Key, std::shared_ptr<GroupedAccessPoint>> m_groups;
+};
+
+}
+}
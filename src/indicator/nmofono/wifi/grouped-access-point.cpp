@@ -19,9 +19,10 @@
 
 #include <nmofono/wifi/grouped-access-point.h>
 #include <nmofono/wifi/access-point-impl.h>
-#include <vector>
+#include <cmath>
+#include <map>
+#include <set>
 #include <stdexcept>
-#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -34,6 +35,15 @@ class GroupedAccessPoint::Private : public QObject
     Q_OBJECT
 
 public:
+    struct Member
+    {
+        AccessPointImpl::Ptr ap;
+        double strength;
+        quint64 order;
+        QMetaObject::Connection strengthConnection;
+        QMetaObject::Connection lastConnectedConnection;
+    };
+
     Private(GroupedAccessPoint& parent) :
             m_parent(parent), m_strength(.0)
     {
@@ -41,65 +51,102 @@ public:
 
     ~Private() = default;
     GroupedAccessPoint& m_parent;
-    vector<AccessPointImpl::Ptr> aplist;
+
+    // One entry per BSSID, i.e. per NM access point object, keyed by path
+    map<QString, Member> m_members;
+    // Member strengths, so the maximum is always at the end
+    set<pair<double, QString>> m_strengths;
+    // Members in the order they were added, the first one represents the group
+    map<quint64, QString> m_order;
+    quint64 m_nextOrder = 0;
+    AccessPointImpl::Ptr m_first;
 
     double m_strength;
     chrono::system_clock::time_point m_lastTime;
 
     void add_ap(AccessPointImpl::Ptr ap)
     {
-        if(!aplist.empty())
+        if(m_first)
         {
             // We should check for all attributes but deduplicating logic
             // is elsewhere so it is enough to just guard against simple mistakes.
-            if(aplist[0]->ssid() != ap->ssid())
+            if(m_first->ssid() != ap->ssid())
             {
                 throw runtime_error("Tried to merge two access points from different networks.");
             }
         }
-        aplist.push_back(ap);
-        if (ap->strength() > m_strength)
+
+        auto path = ap->object_path().path();
+        if (m_members.find(path) != m_members.end())
+        {
+            return;
+        }
+
+        Member member{ap, ap->strength(), m_nextOrder++, {}, {}};
+        member.strengthConnection = connect(ap.get(), &AccessPoint::strengthUpdated, this,
+                [this, path](double strength)
+                {
+                    update_strength(path, strength);
+                });
+        member.lastConnectedConnection = connect(ap.get(), &AccessPointImpl::lastConnectedUpdated, this, &Private::update_lasttime);
+
+        m_strengths.emplace(member.strength, path);
+        m_order.emplace(member.order, path);
+        m_members.emplace(path, member);
+        if (!m_first)
         {
-            setStrength(ap->strength());
+            m_first = ap;
         }
+
+        publishStrength();
         update_lasttime(ap->lastConnected());
-        connect(ap.get(), &AccessPoint::strengthUpdated, this, &Private::update_strength);
-        connect(ap.get(), &AccessPointImpl::lastConnectedUpdated, this, &Private::update_lasttime);
     }
 
     void remove_ap(AccessPointImpl::Ptr ap) {
-        vector<AccessPointImpl::Ptr> new_aps;
-        for(const auto &i: aplist) {
-            if(i->object_path() != ap->object_path()) {
-                new_aps.push_back(i);
-            }
-        }
-        if(new_aps.size() >= aplist.size()) {
+        auto it = m_members.find(ap->object_path().path());
+        if(it == m_members.end()) {
             qWarning() << "Tried to remove an AP that has not been added.";
             return;
         }
-        aplist.clear();
-        setStrength(.0);
-        // Do not reset lasttime because it does not change.
-        for(auto &i : new_aps) {
-            add_ap(i);
-        }
 
+        const auto& member = it->second;
+        disconnect(member.strengthConnection);
+        disconnect(member.lastConnectedConnection);
+        m_strengths.erase(make_pair(member.strength, it->first));
+        m_order.erase(member.order);
+        m_members.erase(it);
+
+        m_first = m_order.empty() ? AccessPointImpl::Ptr() : m_members.at(m_order.begin()->second).ap;
+        // Do not reset lasttime because it does not change.
+        publishStrength();
     }
 
     bool has_object(const QDBusObjectPath &p) const {
-        for(const auto &i : aplist) {
-            if(i->object_path() == p) {
-                return true;
-            }
+        return m_members.find(p.path()) != m_members.end();
+    }
+
+    void update_strength(const QString& path, double strength)
+    {
+        auto it = m_members.find(path);
+        if (it == m_members.end())
+        {
+            return;
         }
-        return false;
+
+        auto& member = it->second;
+        m_strengths.erase(make_pair(member.strength, path));
+        member.strength = strength;
+        m_strengths.emplace(strength, path);
+        publishStrength();
     }
 
-    void setStrength(double s)
+    void publishStrength()
     {
-        m_strength = s;
-        Q_EMIT m_parent.strengthUpdated(m_strength);
+        double strength = m_strengths.empty() ? .0 : m_strengths.rbegin()->first;
+        if(abs(strength - m_strength) > 0.01) {
+            m_strength = strength;
+            Q_EMIT m_parent.strengthUpdated(m_strength);
+        }
     }
 
     void setLastTime(chrono::system_clock::time_point newTime)
@@ -116,18 +163,6 @@ public Q_SLOTS:
             setLastTime(newTime);
         }
     }
-
-    void update_strength(double)
-    {
-        auto nselem = max_element(aplist.begin(), aplist.end(), [](
-                      const AccessPointImpl::Ptr &a,
-                      const AccessPointImpl::Ptr &b) {
-            return a->strength() < b->strength(); });
-        double newstrength = (*nselem)->strength();
-        if(abs(newstrength - m_strength) > 0.01) {
-            setStrength(newstrength);
-        }
-    }
 };
 
 GroupedAccessPoint::GroupedAccessPoint(const AccessPointImpl::Ptr &ap)
@@ -140,12 +175,12 @@ GroupedAccessPoint::~GroupedAccessPoint() {
 }
 
 QDBusObjectPath GroupedAccessPoint::object_path() const {
-    if (p->aplist.empty())
+    if (!p->m_first)
     {
         return QDBusObjectPath("/");
     }
 
-    return p->aplist.at(0)->object_path();
+    return p->m_first->object_path();
 }
 
 double GroupedAccessPoint::strength() const
@@ -160,63 +195,63 @@ chrono::system_clock::time_point GroupedAccessPoint::lastConnected() const
 
 QString GroupedAccessPoint::ssid() const
 {
-    if (p->aplist.empty())
+    if (!p->m_first)
     {
         return QString();
     }
 
-    return p->aplist.at(0)->ssid();
+    return p->m_first->ssid();
 }
 
 QString GroupedAccessPoint::bssid() const
 {
-    if (p->aplist.empty())
+    if (!p->m_first)
     {
         return QString();
     }
 
-    return p->aplist.at(0)->bssid();
+    return p->m_first->bssid();
 }
 
 
 QByteArray GroupedAccessPoint::raw_ssid() const
 {
-    if (p->aplist.empty())
+    if (!p->m_first)
     {
         return QByteArray();
     }
 
-    return p->aplist.at(0)->raw_ssid();
+    return p->m_first->raw_ssid();
 }
 
 bool GroupedAccessPoint::secured() const
 {
-    if (p->aplist.empty())
+    if (!p->m_first)
     {
         return false;
     }
 
-    return p->aplist.at(0)->secured();
+    return p->m_first->secured();
 }
 
 bool GroupedAccessPoint::enterprise() const
 {
-    if (p->aplist.empty())
+    if (!p->m_first)
     {
         return false;
     }
 
-    return p->aplist.at(0)->enterprise();
+    return p->m_first->enterprise();
 }
 
 bool GroupedAccessPoint::adhoc() const
 {
-    if (p->aplist.empty())
+    if (!p->m_first)
     {
         return false;
     }
 
-    return p->aplist.at(0)->adhoc();
+    return p->m_first->adhoc();
 }
 
 void GroupedAccessPoint::add_ap(AccessPointImpl::Ptr &ap) {
@@ -228,7 +263,7 @@ void GroupedAccessPoint::remove_ap(AccessPointImpl::Ptr &ap) {
 }
 
 int GroupedAccessPoint::num_aps() const {
-    return (int)p->aplist.size();
+    return (int)p->m_members.size();
 }
 
 bool GroupedAccessPoint::has_object(const QDBusObjectPath &path) const {
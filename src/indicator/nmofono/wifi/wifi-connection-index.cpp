@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/wifi/wifi-connection-index.h>
+
+#include <NetworkManagerSettingsConnectionInterface.h>
+
+#include <NetworkManager.h>
+
+#include <QHash>
+#include <QMap>
+#include <QMultiHash>
+#include <QSet>
+
+using namespace std;
+
+namespace nmofono
+{
+namespace wifi
+{
+
+class WifiConnectionIndex::Priv: public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Record
+    {
+        shared_ptr<OrgFreedesktopNetworkManagerSettingsConnectionInterface> proxy;
+        QByteArray ssid;
+        Entry entry;
+    };
+
+    Priv(WifiConnectionIndex& parent) :
+        p(parent)
+    {
+    }
+
+    void fetchSettings(const QDBusObjectPath& path)
+    {
+        auto it = m_records.find(path);
+        if (it == m_records.end())
+        {
+            return;
+        }
+
+        auto watcher(new QDBusPendingCallWatcher(it->proxy->GetSettings(), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [this, path](QDBusPendingCallWatcher *call)
+                {
+                    settingsFetched(path, call);
+                });
+    }
+
+    void settingsFetched(const QDBusObjectPath& path, QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        QDBusPendingReply<QVariantDictMap> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get settings for" << path.path() << ":" << reply.error().message();
+            initialFetchDone(path);
+            return;
+        }
+
+        auto it = m_records.find(path);
+        if (it == m_records.end())
+        {
+            // Removed while we were waiting for the settings
+            return;
+        }
+
+        QVariantDictMap settings = reply.value();
+        QByteArray ssid;
+        auto wirelessIt = settings.find("802-11-wireless");
+        if (wirelessIt != settings.cend())
+        {
+            ssid = wirelessIt->value("ssid").toByteArray();
+        }
+        auto connectionIt = settings.find("connection");
+        if (connectionIt != settings.cend())
+        {
+            it->entry.uuid = connectionIt->value("uuid").toString();
+            it->entry.timestamp = connectionIt->value("timestamp").toULongLong();
+        }
+
+        if (it->ssid != ssid)
+        {
+            if (!it->ssid.isEmpty())
+            {
+                m_bySsid.remove(it->ssid, path);
+            }
+            it->ssid = ssid;
+            if (!ssid.isEmpty())
+            {
+                m_bySsid.insert(ssid, path);
+            }
+        }
+
+        Q_EMIT p.connectionsChanged();
+        initialFetchDone(path);
+    }
+
+    void initialFetchDone(const QDBusObjectPath& path)
+    {
+        if (m_loaded || !m_initialFetches.remove(path) || !m_initialFetches.isEmpty())
+        {
+            return;
+        }
+
+        setLoaded();
+    }
+
+    void setLoaded()
+    {
+        m_loaded = true;
+        Q_EMIT p.loaded();
+    }
+
+public Q_SLOTS:
+    void newConnection(const QDBusObjectPath& path)
+    {
+        if (m_records.contains(path))
+        {
+            return;
+        }
+
+        Record record;
+        record.proxy = make_shared<OrgFreedesktopNetworkManagerSettingsConnectionInterface>(
+                NM_DBUS_SERVICE, path.path(), m_settings->connection());
+        record.entry.path = path;
+        connect(record.proxy.get(), &OrgFreedesktopNetworkManagerSettingsConnectionInterface::Updated, this,
+                [this, path]()
+                {
+                    fetchSettings(path);
+                });
+        m_records.insert(path, record);
+
+        fetchSettings(path);
+    }
+
+    void connectionRemoved(const QDBusObjectPath& path)
+    {
+        auto it = m_records.find(path);
+        if (it == m_records.end())
+        {
+            return;
+        }
+
+        bool indexed = !it->ssid.isEmpty();
+        if (indexed)
+        {
+            m_bySsid.remove(it->ssid, path);
+        }
+        m_records.erase(it);
+
+        if (indexed)
+        {
+            Q_EMIT p.connectionsChanged();
+        }
+
+        // Its settings will never arrive
+        initialFetchDone(path);
+    }
+
+    void connectionsListed(QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        QDBusPendingReply<QList<QDBusObjectPath>> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to list connections:" << reply.error().message();
+            // Better to risk a duplicate than to never connect
+            setLoaded();
+            return;
+        }
+
+        for (const auto& path : reply.value())
+        {
+            if (!m_records.contains(path))
+            {
+                m_initialFetches.insert(path);
+            }
+            newConnection(path);
+        }
+
+        if (m_initialFetches.isEmpty())
+        {
+            setLoaded();
+        }
+    }
+
+public:
+    WifiConnectionIndex& p;
+
+    shared_ptr<OrgFreedesktopNetworkManagerSettingsInterface> m_settings;
+
+    QMap<QDBusObjectPath, Record> m_records;
+
+    QMultiHash<QByteArray, QDBusObjectPath> m_bySsid;
+
+    // Listed connections whose settings have not arrived yet
+    QSet<QDBusObjectPath> m_initialFetches;
+
+    bool m_loaded = false;
+};
+
+WifiConnectionIndex::WifiConnectionIndex(shared_ptr<OrgFreedesktopNetworkManagerSettingsInterface> settings) :
+        d(new Priv(*this))
+{
+    d->m_settings = settings;
+
+    connect(d->m_settings.get(), &OrgFreedesktopNetworkManagerSettingsInterface::NewConnection, d.get(), &Priv::newConnection);
+    connect(d->m_settings.get(), &OrgFreedesktopNetworkManagerSettingsInterface::ConnectionRemoved, d.get(), &Priv::connectionRemoved);
+
+    auto watcher(new QDBusPendingCallWatcher(d->m_settings->ListConnections(), d.get()));
+    connect(watcher, &QDBusPendingCallWatcher::finished, d.get(), &Priv::connectionsListed);
+}
+
+WifiConnectionIndex::~WifiConnectionIndex()
+{
+}
+
+QList<WifiConnectionIndex::Entry> WifiConnectionIndex::connections(const QByteArray& ssid) const
+{
+    QList<Entry> result;
+    for (auto it = d->m_bySsid.constFind(ssid); it != d->m_bySsid.cend() && it.key() == ssid; ++it)
+    {
+        result << d->m_records.value(*it).entry;
+    }
+    return result;
+}
+
+QDBusObjectPath WifiConnectionIndex::mostRecent(const QByteArray& ssid,
+                                                const QSet<QDBusObjectPath>& candidates) const
+{
+    QDBusObjectPath result("/");
+    quint64 timestamp = 0;
+    bool found = false;
+
+    for (auto it = d->m_bySsid.constFind(ssid); it != d->m_bySsid.cend() && it.key() == ssid; ++it)
+    {
+        if (!candidates.contains(*it))
+        {
+            continue;
+        }
+
+        const auto entry = d->m_records.value(*it).entry;
+        if (!found || entry.timestamp > timestamp)
+        {
+            result = entry.path;
+            timestamp = entry.timestamp;
+            found = true;
+        }
+    }
+
+    return result;
+}
+
+bool WifiConnectionIndex::isLoaded() const
+{
+    return d->m_loaded;
+}
+
+}
+}
+
+#include "wifi-connection-index.moc"
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <NetworkManagerSettingsInterface.h>
+
+#include <QByteArray>
+#include <QDBusObjectPath>
+#include <QList>
+#include <QObject>
+#include <QSet>
+
+#include <unity/util/DefinesPtrs.h>
+
+namespace nmofono
+{
+namespace wifi
+{
+
+/**
+ * Keeps an index of the saved Wi-Fi settings connections keyed by raw SSID.
+ *
+ * The index is kept up to date from the NewConnection, ConnectionRemoved
+ * and Updated signals, so looking up the connection for an access point
+ * does not need any D-Bus round-trips.
+ */
+class WifiConnectionIndex: public QObject
+{
+    Q_OBJECT
+
+public:
+    UNITY_DEFINES_PTRS(WifiConnectionIndex);
+
+    struct Entry
+    {
+        QDBusObjectPath path;
+        QString uuid;
+        quint64 timestamp = 0;
+    };
+
+    WifiConnectionIndex(std::shared_ptr<OrgFreedesktopNetworkManagerSettingsInterface> settings);
+
+    ~WifiConnectionIndex();
+
+    /**
+     * All the saved connections for the given raw SSID.
+     */
+    QList<Entry> connections(const QByteArray& ssid) const;
+
+    /**
+     * The most recently used connection for the given raw SSID, restricted
+     * to the candidate paths (e.g. a device's available connections).
+     *
+     * Returns "/" if there is no match.
+     */
+    QDBusObjectPath mostRecent(const QByteArray& ssid,
+                               const QSet<QDBusObjectPath>& candidates) const;
+
+    /**
+     * Whether the connections that were saved when we started have all
+     * been indexed. Before then a lookup may miss one.
+     */
+    bool isLoaded() const;
+
+Q_SIGNALS:
+    void connectionsChanged();
+
+    void loaded();
+
+protected:
+    class Priv;
+    std::shared_ptr<Priv> d;
+};
+
+}
+}
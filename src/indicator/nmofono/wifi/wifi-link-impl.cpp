@@ -18,16 +18,16 @@
  */
 
 #include <nmofono/wifi/wifi-link-impl.h>
-#include <nmofono/wifi/access-point-impl.h>
-#include <nmofono/wifi/grouped-access-point.h>
+#include <nmofono/wifi/access-point-registry.h>
 #include <url-dispatcher-cpp/url-dispatcher.h>
 #include <cassert>
 
 #include <NetworkManagerDeviceWirelessInterface.h>
-#include <NetworkManagerSettingsConnectionInterface.h>
+#include <PropertiesInterface.h>
 
 #include <NetworkManager.h>
 #include <iostream>
+#include <QTimer>
 #include <QUrlQuery>
 
 using namespace std;
@@ -60,8 +60,19 @@ public:
 
     uint32_t m_characteristics = Link::Characteristics::empty;
     Link::Status m_status = Status::disabled;
-    QSet<AccessPointImpl::Ptr> m_rawAccessPoints;
+    AccessPointRegistry m_accessPoints;
+    // Access points whose properties are still being fetched
+    QSet<QDBusObjectPath> m_pendingAccessPoints;
+    // The networks subscribers have been told about
     QSet<AccessPoint::Ptr> m_groupedAccessPoints;
+    // Changes gathered during the current scan burst
+    QSet<AccessPoint::Ptr> m_pendingAdded;
+    QSet<AccessPoint::Ptr> m_pendingRemoved;
+    QTimer m_debounceTimer;
+    QTimer m_latencyTimer;
+    quint64 m_receivedUpdates = 0;
+    quint64 m_emittedUpdates = 0;
+    quint64 m_suppressedUpdates = 0;
     AccessPoint::Ptr m_activeAccessPoint;
     Signal m_signal = Signal::disconnected;
 
@@ -69,16 +80,25 @@ public:
     OrgFreedesktopNetworkManagerDeviceWirelessInterface m_wireless;
     shared_ptr<OrgFreedesktopNetworkManagerInterface> m_nm;
     connection::ActiveConnectionManager::SPtr m_activeConnectionManager;
+    WifiConnectionIndex::SPtr m_connectionIndex;
 
     WifiToggle::SPtr m_wifiToggle;
 
-    map<AccessPointImpl::Key, shared_ptr<GroupedAccessPoint>> m_grouper;
     uint32_t m_lastState = 0;
     QString m_name;
     connection::ActiveConnection::SPtr m_activeConnection;
     unique_ptr<QMetaObject::Connection> m_signalStrengthConnection;
     bool m_connecting = false;
     bool m_disconnectWifi = false;
+    // Only set while the link is being built from an ObjectSnapshot
+    unique_ptr<QDBusObjectPath> m_snapshotActiveConnection;
+    // The device's AvailableConnections, from the snapshot or one GetAll,
+    // then kept up to date by PropertiesChanged
+    unique_ptr<OrgFreedesktopDBusPropertiesInterface> m_deviceProperties;
+    QSet<QDBusObjectPath> m_availableConnections;
+    bool m_availableConnectionsKnown = false;
+    // Tapped before we could tell whether it is already saved
+    AccessPoint::Ptr m_queuedAccessPoint;
 
     void setStatus(Status status)
     {
@@ -128,7 +148,7 @@ public:
         case NM_DEVICE_STATE_IP_CHECK:
         {
             // make sure to set activeConnection before changing the status
-            QDBusObjectPath path = m_dev->activeConnection();
+            QDBusObjectPath path = activeConnectionPath();
             // for some reason the path is not always set on these
             // states. Let's not clear the active connection as obviously
             // we have one.
@@ -142,20 +162,29 @@ public:
         case NM_DEVICE_STATE_SECONDARIES:
         {
             // make sure to set activeConnection before changing the status
-            updateActiveConnection(m_activeConnectionManager->connection(m_dev->activeConnection()));
+            updateActiveConnection(m_activeConnectionManager->connection(activeConnectionPath()));
             setStatus(Status::connected);
             break;
         }
         case NM_DEVICE_STATE_ACTIVATED:
         {
             // make sure to set activeConnection before changing the status
-            updateActiveConnection(m_activeConnectionManager->connection(m_dev->activeConnection()));
+            updateActiveConnection(m_activeConnectionManager->connection(activeConnectionPath()));
             setStatus(Status::online);
             break;
         }}
 
     }
 
+    QDBusObjectPath activeConnectionPath() const
+    {
+        if (m_snapshotActiveConnection)
+        {
+            return *m_snapshotActiveConnection;
+        }
+        return m_dev->activeConnection();
+    }
+
     void disconnectSignalStengthConnection()
     {
         if (m_signalStrengthConnection)
@@ -184,6 +213,16 @@ public:
         }
 
         m_activeConnection = activeConnection;
+        updateActiveAccessPoint();
+    }
+
+    void updateActiveAccessPoint()
+    {
+        if (!m_activeConnection)
+        {
+            return;
+        }
+
         auto state = m_activeConnection->state();
         switch (state) {
         case connection::ActiveConnection::State::unknown:
@@ -192,112 +231,216 @@ public:
         case connection::ActiveConnection::State::deactivating:
         case connection::ActiveConnection::State::deactivated:
             // for Wi-Fi devices specific_object is the AccessPoint object.
-            QDBusObjectPath ap_path = m_activeConnection->specificObject();
-            for (auto &ap : m_groupedAccessPoints) {
-                auto shap =  dynamic_pointer_cast<GroupedAccessPoint>(ap);
-                if (shap->has_object(ap_path)) {
-                    m_activeAccessPoint = ap;
-                    disconnectSignalStengthConnection();
-                    m_signalStrengthConnection = make_unique<
-                            QMetaObject::Connection>(
-                            connect(m_activeAccessPoint.get(),
-                                    &AccessPoint::strengthUpdated, this,
-                                    &Private::strengthUpdated));
-                    Q_EMIT p.activeAccessPointUpdated(m_activeAccessPoint);
-                    strengthUpdated();
-                    break;
-                }
+            // It may not be known yet if its properties are still being fetched,
+            // in which case we are called again once it has been added.
+            auto ap = m_accessPoints.group(m_activeConnection->specificObject());
+            if (ap) {
+                m_activeAccessPoint = ap;
+                disconnectSignalStengthConnection();
+                m_signalStrengthConnection = make_unique<
+                        QMetaObject::Connection>(
+                        connect(m_activeAccessPoint.get(),
+                                &AccessPoint::strengthUpdated, this,
+                                &Private::strengthUpdated));
+                Q_EMIT p.activeAccessPointUpdated(m_activeAccessPoint);
+                strengthUpdated();
             }
         }
-}
+    }
 
+    void activationFinished(connection::ActiveConnection::SPtr ac, bool enterprise)
+    {
+        if (!ac)
+        {
+            qWarning() << " Failed to activate connection";
+        }
+        else if (!enterprise)
+        {
+            updateActiveConnection(ac);
+        }
+        m_connecting = false;
+    }
 
-public Q_SLOTS:
-    void ap_added(const QDBusObjectPath &path)
+    void access_point_properties_fetched(const QDBusObjectPath &path,
+            shared_ptr<OrgFreedesktopNetworkManagerAccessPointInterface> ap,
+            QDBusPendingCallWatcher *call)
     {
-        try {
-            for (auto ap : m_rawAccessPoints) {
-                if (dynamic_pointer_cast<AccessPoint>(ap)->object_path() == path) {
-                    // already in the list
-                    return;
-                }
-            }
+        call->deleteLater();
 
-            AccessPointImpl::Ptr shap;
-            try {
-                auto ap = make_shared<
-                        OrgFreedesktopNetworkManagerAccessPointInterface>(
-                        NM_DBUS_SERVICE, path.path(), m_dev->connection());
-                shap = make_shared<AccessPointImpl>(ap);
-            } catch(const exception &e) {
-                qWarning() << "Failed to create AccessPoint proxy for "<< path.path() << ": ";
-                qWarning() << "\t" << QString::fromStdString(e.what());
-                qWarning() << "\tIgnoring.";
-                return;
-            }
+        if (!m_pendingAccessPoints.remove(path))
+        {
+            // Removed while we were waiting for the properties
+            return;
+        }
 
-            m_rawAccessPoints.insert(shap);
+        QDBusPendingReply<QVariantMap> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get properties for AccessPoint" << path.path() << ":" << reply.error().message();
+            qWarning() << "\tIgnoring.";
+            return;
+        }
 
-            auto k = AccessPointImpl::Key(shap);
-            if(m_grouper.find(k) != m_grouper.end()) {
-                m_grouper[k]->add_ap(shap);
-            } else {
-                m_grouper[k] = make_shared<GroupedAccessPoint>(shap);
-            }
-            update_grouped_access_points();
-        } catch(const exception &e) {
-            /// @bug dbus-cpp internal logic exploded
-            // If this happens, indicator-network is in an unknown state with no clear way of
-            // recovering. The only reasonable way out is a graceful exit.
-            cerr << " Failed to run dbus service: " << e.what() << endl;
+        addAccessPoint(path, ap, reply.value());
+    }
+
+    void addAccessPoint(const QDBusObjectPath &path,
+            shared_ptr<OrgFreedesktopNetworkManagerAccessPointInterface> ap,
+            const QVariantMap& properties)
+    {
+        if (m_accessPoints.contains(path))
+        {
+            return;
+        }
+
+        auto group = m_accessPoints.add(make_shared<AccessPointImpl>(ap, properties));
+        if (group->num_aps() == 1)
+        {
+            // A network we couldn't see before
+            AccessPoint::Ptr network = group;
+            m_pendingAdded.insert(network);
+            queueAccessPointUpdate();
+        }
+
+        if (m_activeConnection && m_activeConnection->specificObject() == path)
+        {
+            updateActiveAccessPoint();
         }
     }
 
-    void ap_removed(const QDBusObjectPath &path)
+    void access_points_fetched(QDBusPendingCallWatcher *call)
     {
-        AccessPointImpl::Ptr shap;
+        call->deleteLater();
 
-        auto list = m_rawAccessPoints;
-        for (const auto &ap : list) {
-            if (ap->object_path() == path) {
-                shap = ap;
-                list.remove(ap);
-                break;
-            }
+        QDBusPendingReply<QList<QDBusObjectPath>> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get access points for" << m_dev->path() << ":" << reply.error().message();
+            return;
+        }
+
+        for (const auto& path : reply.value()) {
+            ap_added(path);
+        }
+    }
+
+public Q_SLOTS:
+    void ap_added(const QDBusObjectPath &path)
+    {
+        if (m_pendingAccessPoints.contains(path))
+        {
+            // already being fetched
+            return;
         }
-        if (!shap) {
+
+        if (m_accessPoints.contains(path))
+        {
+            // already in the list
+            return;
+        }
+
+        // Fetch all the properties in one asynchronous round-trip, the
+        // access point is only added to the grouper once they arrive.
+        auto ap = make_shared<OrgFreedesktopNetworkManagerAccessPointInterface>(
+                NM_DBUS_SERVICE, path.path(), m_dev->connection());
+        OrgFreedesktopDBusPropertiesInterface properties(
+                NM_DBUS_SERVICE, path.path(), m_dev->connection());
+
+        m_pendingAccessPoints.insert(path);
+        auto watcher(new QDBusPendingCallWatcher(
+                properties.GetAll(NM_DBUS_INTERFACE_ACCESS_POINT), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [this, path, ap](QDBusPendingCallWatcher *call)
+                {
+                    access_point_properties_fetched(path, ap, call);
+                });
+    }
+
+    void ap_removed(const QDBusObjectPath &path)
+    {
+        if (m_pendingAccessPoints.remove(path))
+        {
+            // Never made it to the grouper
+            return;
+        }
+
+        auto group = m_accessPoints.group(path);
+        if (!m_accessPoints.remove(path)) {
             qWarning() << "Tried to remove access point " << path.path() << " that has not been added.";
             return;
         }
-        m_rawAccessPoints = list;
 
-        AccessPointImpl::Key k(shap);
-        auto it = m_grouper.find(k);
-        if (it != m_grouper.end())
+        if (group && group->num_aps() == 0)
         {
-            it->second->remove_ap(shap);
-            if (it->second->num_aps() == 0)
+            // The last access point of this network went away
+            AccessPoint::Ptr network = group;
+            // Never published, so nobody needs to hear about it
+            if (!m_pendingAdded.remove(network))
             {
-                m_grouper.erase(it);
+                m_pendingRemoved.insert(network);
             }
+            queueAccessPointUpdate();
         }
-        update_grouped_access_points();
     }
 
-    void update_grouped_access_points()
+    void queueAccessPointUpdate()
     {
-        m_groupedAccessPoints.clear();
-        for (auto &i : m_grouper)
+        ++m_receivedUpdates;
+
+        if (m_debounceTimer.interval() <= 0)
+        {
+            flushAccessPoints();
+            return;
+        }
+
+        // The debounce window slides with the burst, the latency cap doesn't
+        m_debounceTimer.start();
+        if (!m_latencyTimer.isActive())
+        {
+            m_latencyTimer.start();
+        }
+    }
+
+    void flushAccessPoints()
+    {
+        m_debounceTimer.stop();
+        m_latencyTimer.stop();
+
+        if (m_pendingAdded.isEmpty() && m_pendingRemoved.isEmpty())
+        {
+            return;
+        }
+
+        QSet<AccessPoint::Ptr> added;
+        QSet<AccessPoint::Ptr> removed;
+        added.swap(m_pendingAdded);
+        removed.swap(m_pendingRemoved);
+
+        m_groupedAccessPoints.subtract(removed);
+        m_groupedAccessPoints.unite(added);
+
+        if (m_disconnectWifi)
         {
-            m_groupedAccessPoints.insert(i.second);
+            // Nothing is visible until Wi-Fi is reconnected
+            ++m_suppressedUpdates;
+            return;
         }
 
+        ++m_emittedUpdates;
+        Q_EMIT p.accessPointsChanged(added, removed);
+        Q_EMIT p.accessPointsUpdated(m_groupedAccessPoints);
+    }
+
+    void disconnectWifiUpdated()
+    {
         if (m_disconnectWifi)
         {
+            Q_EMIT p.accessPointsChanged({}, m_groupedAccessPoints);
             Q_EMIT p.accessPointsUpdated(QSet<AccessPoint::Ptr>());
         }
         else
         {
+            Q_EMIT p.accessPointsChanged(m_groupedAccessPoints, {});
             Q_EMIT p.accessPointsUpdated(m_groupedAccessPoints);
         }
     }
@@ -312,6 +455,66 @@ public Q_SLOTS:
         updateDeviceState(m_lastState);
     }
 
+    void setAvailableConnections(const QVariant& value)
+    {
+        m_availableConnections = ObjectSnapshot::pathList(value).toSet();
+        m_availableConnectionsKnown = true;
+        connectQueued();
+    }
+
+    void device_properties_fetched(QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        QDBusPendingReply<QVariantMap> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get properties for" << m_dev->path() << ":" << reply.error().message();
+            // Better to risk a duplicate than to never connect
+            m_availableConnectionsKnown = true;
+            connectQueued();
+            return;
+        }
+
+        setAvailableConnections(reply.value().value("AvailableConnections"));
+    }
+
+    void device_properties_changed(const QString& interface,
+                                   const QVariantMap& changed, const QStringList&)
+    {
+        if (interface != NM_DBUS_INTERFACE_DEVICE)
+        {
+            return;
+        }
+
+        auto it = changed.constFind("AvailableConnections");
+        if (it != changed.cend())
+        {
+            setAvailableConnections(*it);
+        }
+    }
+
+    /**
+     * Whether a saved connection for an access point can be found yet.
+     * Until then connecting would add a duplicate of it.
+     */
+    bool connectionsKnown() const
+    {
+        return m_availableConnectionsKnown && m_connectionIndex->isLoaded();
+    }
+
+    void connectQueued()
+    {
+        if (!m_queuedAccessPoint || !connectionsKnown())
+        {
+            return;
+        }
+
+        auto accessPoint = m_queuedAccessPoint;
+        m_queuedAccessPoint.reset();
+        p.connect_to(accessPoint);
+    }
+
     void strengthUpdated()
     {
         Signal signal = Signal::disconnected;
@@ -353,26 +556,87 @@ public Q_SLOTS:
     }
 };
 
+constexpr int WifiLinkImpl::DEFAULT_SCAN_DEBOUNCE_MS;
+constexpr int WifiLinkImpl::DEFAULT_SCAN_MAX_LATENCY_MS;
+
 WifiLinkImpl::WifiLinkImpl(shared_ptr<OrgFreedesktopNetworkManagerDeviceInterface> dev,
            shared_ptr<OrgFreedesktopNetworkManagerInterface> nm,
            WifiToggle::SPtr wifiToggle,
-           connection::ActiveConnectionManager::SPtr activeConnectionManager)
+           connection::ActiveConnectionManager::SPtr activeConnectionManager,
+           WifiConnectionIndex::SPtr connectionIndex,
+           ObjectSnapshot::SPtr snapshot)
     : d(new Private(*this, dev, nm, wifiToggle)) {
-    d->m_name = d->m_dev->interface();
     d->m_activeConnectionManager = activeConnectionManager;
+    d->m_connectionIndex = connectionIndex;
+
+    d->m_debounceTimer.setSingleShot(true);
+    d->m_latencyTimer.setSingleShot(true);
+    connect(&d->m_debounceTimer, &QTimer::timeout, d.get(), &Private::flushAccessPoints);
+    connect(&d->m_latencyTimer, &QTimer::timeout, d.get(), &Private::flushAccessPoints);
+    setScanDebounce(DEFAULT_SCAN_DEBOUNCE_MS, DEFAULT_SCAN_MAX_LATENCY_MS);
+
+    QDBusObjectPath devicePath(d->m_dev->path());
+    bool fromSnapshot = snapshot
+            && snapshot->contains(devicePath, NM_DBUS_INTERFACE_DEVICE)
+            && snapshot->contains(devicePath, NM_DBUS_INTERFACE_DEVICE_WIRELESS);
+
+    uint state;
+    if (fromSnapshot)
+    {
+        auto deviceProperties = snapshot->properties(devicePath, NM_DBUS_INTERFACE_DEVICE);
+        d->m_name = deviceProperties.value("Interface").toString();
+        state = deviceProperties.value("State").toUInt();
+        d->m_availableConnections = ObjectSnapshot::pathList(
+                deviceProperties.value("AvailableConnections")).toSet();
+        d->m_availableConnectionsKnown = true;
+        d->m_snapshotActiveConnection = make_unique<QDBusObjectPath>(
+                qvariant_cast<QDBusObjectPath>(deviceProperties.value("ActiveConnection")));
+
+        auto accessPoints = ObjectSnapshot::pathList(
+                snapshot->properties(devicePath, NM_DBUS_INTERFACE_DEVICE_WIRELESS).value("AccessPoints"));
+        for (const auto& path : accessPoints)
+        {
+            if (!snapshot->contains(path, NM_DBUS_INTERFACE_ACCESS_POINT))
+            {
+                continue;
+            }
+            auto ap = make_shared<OrgFreedesktopNetworkManagerAccessPointInterface>(
+                    NM_DBUS_SERVICE, path.path(), d->m_dev->connection());
+            d->addAccessPoint(path, ap, snapshot->properties(path, NM_DBUS_INTERFACE_ACCESS_POINT));
+        }
+    }
+    else
+    {
+        d->m_name = d->m_dev->interface();
+        state = d->m_dev->state();
+    }
 
     connect(&d->m_wireless, &OrgFreedesktopNetworkManagerDeviceWirelessInterface::AccessPointAdded, d.get(), &Private::ap_added);
     connect(&d->m_wireless, &OrgFreedesktopNetworkManagerDeviceWirelessInterface::AccessPointRemoved, d.get(), &Private::ap_removed);
-    QList<QDBusObjectPath> aps = d->m_wireless.GetAccessPoints();
-    for (const auto& path : aps) {
-        d->ap_added(path);
+    // Also done when built from a snapshot, to pick up access points that
+    // appeared before we were listening. Known ones are skipped.
+    auto watcher(new QDBusPendingCallWatcher(d->m_wireless.GetAccessPoints(), d.get()));
+    connect(watcher, &QDBusPendingCallWatcher::finished, d.get(), &Private::access_points_fetched);
+
+    d->m_deviceProperties = make_unique<OrgFreedesktopDBusPropertiesInterface>(
+            NM_DBUS_SERVICE, d->m_dev->path(), d->m_dev->connection());
+    connect(d->m_deviceProperties.get(), &OrgFreedesktopDBusPropertiesInterface::PropertiesChanged, d.get(), &Private::device_properties_changed);
+    if (!fromSnapshot)
+    {
+        auto propertiesWatcher(new QDBusPendingCallWatcher(
+                d->m_deviceProperties->GetAll(NM_DBUS_INTERFACE_DEVICE), d.get()));
+        connect(propertiesWatcher, &QDBusPendingCallWatcher::finished, d.get(), &Private::device_properties_fetched);
     }
+    connect(d->m_connectionIndex.get(), &WifiConnectionIndex::loaded, d.get(), &Private::connectQueued);
 
     connect(d->m_dev.get(), &OrgFreedesktopNetworkManagerDeviceInterface::StateChanged, d.get(), &Private::state_changed);
-    d->updateDeviceState(d->m_dev->state());
+    d->updateDeviceState(state);
+    d->m_snapshotActiveConnection.reset();
 
     connect(d->m_wifiToggle.get(), &WifiToggle::stateChanged, d.get(), &Private::wifiToggleChanged);
 
+    // Access points from the snapshot are visible as soon as we are built
+    d->flushAccessPoints();
     d->strengthUpdated();
 }
 
@@ -439,39 +703,30 @@ WifiLinkImpl::accessPoints() const {
 void
 WifiLinkImpl::connect_to(AccessPoint::Ptr accessPoint)
 {
+    if (!d->connectionsKnown())
+    {
+        // Only the last tap counts
+        qDebug() << "Waiting for saved connections before connecting to:" << accessPoint->ssid();
+        d->m_queuedAccessPoint = accessPoint;
+        return;
+    }
+
     qDebug() << "Connecting to:" << accessPoint->ssid();
 
     d->m_connecting = true;
     QByteArray ssid = accessPoint->raw_ssid();
 
-    shared_ptr<OrgFreedesktopNetworkManagerSettingsConnectionInterface> found;
-    QList<QDBusObjectPath> connections = d->m_dev->availableConnections();
-    for (auto &path : connections) {
-        auto con = make_shared<OrgFreedesktopNetworkManagerSettingsConnectionInterface>(
-                NM_DBUS_SERVICE, path.path(), d->m_dev->connection());
-        QVariantDictMap settings = con->GetSettings();
-        auto wirelessIt = settings.find("802-11-wireless");
-        if (wirelessIt != settings.cend())
-        {
-            auto ssidIt = wirelessIt->find("ssid");
-            if (ssidIt != wirelessIt->cend())
-            {
-                if (ssidIt->toByteArray() == ssid)
-                {
-                    found = con;
-                    break;
-                }
-            }
-        }
-    }
+    // Pick the most recently used saved connection for this SSID that
+    // the device can actually use.
+    QDBusObjectPath found = d->m_connectionIndex->mostRecent(
+            ssid, d->m_availableConnections);
 
-    /// @todo check the timestamps as there might be multiple ones that are suitable.
-    /// @todo oh, and check more parameters than just the ssid
+    /// @todo check more parameters than just the ssid
 
-    connection::ActiveConnection::SPtr ac;
-    if (found) {
+    connection::PendingActiveConnection::SPtr pending;
+    if (found.path() != "/") {
         qDebug() << "Connecting to known access point";
-        ac = d->m_activeConnectionManager->activate(QDBusObjectPath(found->path()),
+        pending = d->m_activeConnectionManager->activateAsync(found,
                                        QDBusObjectPath(d->m_dev->path()),
                                        accessPoint->object_path());
     } else {
@@ -488,30 +743,27 @@ WifiLinkImpl::connect_to(AccessPoint::Ptr accessPoint)
                     cerr << "URL Dispatcher failed on " << url << endl;
                 }
             });
+            d->m_connecting = false;
+            return;
         } else {
             qDebug() << "New connection to regular access point";
             QVariantDictMap conf;
 
-            /// @todo getting the ssid multiple times over dbus is stupid.
-
             QVariantMap wireless_conf;
             wireless_conf["ssid"] = ssid;
 
             conf["802-11-wireless"] = wireless_conf;
-            ac = d->m_activeConnectionManager->addAndActivate(conf, QDBusObjectPath(d->m_dev->path()), accessPoint->object_path());
+            pending = d->m_activeConnectionManager->addAndActivateAsync(conf, QDBusObjectPath(d->m_dev->path()), accessPoint->object_path());
         }
     }
-    if (!ac)
-    {
-        qWarning() << " Failed to activate connection";
-        return;
-    }
 
     // For enterprise access points, the system settings app will perform the connection
-    if (!accessPoint->enterprise()) {
-        d->updateActiveConnection(ac);
-    }
-    d->m_connecting = false;
+    bool enterprise = accessPoint->enterprise();
+    connect(pending.get(), &connection::PendingActiveConnection::finished, d.get(),
+            [this, enterprise](connection::ActiveConnection::SPtr ac)
+            {
+                d->activationFinished(ac, enterprise);
+            });
 }
 
 AccessPoint::Ptr
@@ -533,6 +785,8 @@ WifiLinkImpl::setDisconnectWifi(bool disconnect)
         return;
     }
 
+    // Settle the burst in progress under the old visibility
+    d->flushAccessPoints();
     d->m_disconnectWifi = disconnect;
 
     d->m_dev->setAutoconnect(!disconnect);
@@ -543,10 +797,40 @@ WifiLinkImpl::setDisconnectWifi(bool disconnect)
                 QDBusObjectPath(d->m_activeConnection->path()));
     }
 
-    d->update_grouped_access_points();
+    d->disconnectWifiUpdated();
     d->strengthUpdated();
 }
 
+void
+WifiLinkImpl::setScanDebounce(int windowMs, int maxLatencyMs)
+{
+    d->m_debounceTimer.setInterval(windowMs);
+    d->m_latencyTimer.setInterval(maxLatencyMs);
+
+    if (windowMs <= 0)
+    {
+        d->flushAccessPoints();
+    }
+}
+
+quint64
+WifiLinkImpl::coalescedUpdates() const
+{
+    return d->m_receivedUpdates - d->m_emittedUpdates - d->m_suppressedUpdates;
+}
+
+quint64
+WifiLinkImpl::emittedUpdates() const
+{
+    return d->m_emittedUpdates;
+}
+
+quint64
+WifiLinkImpl::suppressedUpdates() const
+{
+    return d->m_suppressedUpdates;
+}
+
 }
 }
 
@@ -20,7 +20,9 @@
 #pragma once
 
 #include <nmofono/connection/active-connection-manager.h>
+#include <nmofono/object-snapshot.h>
 #include <nmofono/urfkill-flight-mode-toggle.h>
+#include <nmofono/wifi/wifi-connection-index.h>
 #include <nmofono/wifi/wifi-link.h>
 #include <nmofono/wifi/wifi-toggle.h>
 #include <util/qhash-sharedptr.h>
@@ -39,10 +41,16 @@ class WifiLinkImpl : public WifiLink
 
 public:
 
+    static constexpr int DEFAULT_SCAN_DEBOUNCE_MS = 100;
+
+    static constexpr int DEFAULT_SCAN_MAX_LATENCY_MS = 500;
+
     WifiLinkImpl(std::shared_ptr<OrgFreedesktopNetworkManagerDeviceInterface> dev,
          std::shared_ptr<OrgFreedesktopNetworkManagerInterface> nm,
          WifiToggle::SPtr wifiToggle,
-         connection::ActiveConnectionManager::SPtr activeConnectionManager);
+         connection::ActiveConnectionManager::SPtr activeConnectionManager,
+         WifiConnectionIndex::SPtr connectionIndex,
+         ObjectSnapshot::SPtr snapshot = ObjectSnapshot::SPtr());
     ~WifiLinkImpl();
 
     // public API
@@ -65,6 +73,22 @@ public:
 
     Signal signal() const override;
 
+    /**
+     * Access point changes are gathered until none have arrived for
+     * windowMs, but are never held back for longer than maxLatencyMs.
+     * A window of 0 publishes every change straight away.
+     */
+    void setScanDebounce(int windowMs, int maxLatencyMs);
+
+    // Access point changes that were folded into another update
+    quint64 coalescedUpdates() const;
+
+    // Number of accessPointsChanged emissions
+    quint64 emittedUpdates() const;
+
+    // Flushes held back because Wi-Fi is being kept disconnected
+    quint64 suppressedUpdates() const;
+
 private:
     struct Private;
     std::unique_ptr<Private> d;
@@ -87,6 +87,11 @@ public Q_SLOTS:
 Q_SIGNALS:
     void accessPointsUpdated(const QSet<AccessPoint::Ptr>&);
 
+    // Only the access points that came and went, use accessPoints() for
+    // the initial set
+    void accessPointsChanged(const QSet<AccessPoint::Ptr>& added,
+                             const QSet<AccessPoint::Ptr>& removed);
+
     void activeAccessPointUpdated(AccessPoint::Ptr);
 
     void signalUpdated(Signal);
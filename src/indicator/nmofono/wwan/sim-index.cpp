@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/wwan/sim-index.h>
+
+#include <QDebug>
+
+using namespace std;
+
+namespace nmofono
+{
+namespace wwan
+{
+
+bool
+SimIndex::add(Sim::Ptr sim)
+{
+    if (!sim || m_byIccid.contains(sim->iccid()))
+    {
+        return false;
+    }
+
+    m_sims.append(sim);
+    m_byIccid.insert(sim->iccid(), sim);
+    connect(sim.get(), &Sim::presentChanged, this, &SimIndex::simPresentChanged);
+
+    reindex(sim);
+    return true;
+}
+
+Sim::Ptr
+SimIndex::sim(const QString& iccid) const
+{
+    return m_byIccid.value(iccid);
+}
+
+Sim::Ptr
+SimIndex::simForModem(const QString& modemPath) const
+{
+    return m_byModem.value(modemPath);
+}
+
+QString
+SimIndex::modemForSim(const QString& iccid) const
+{
+    return m_modemPaths.value(iccid);
+}
+
+QList<Sim::Ptr>
+SimIndex::sims() const
+{
+    return m_sims;
+}
+
+QStringList
+SimIndex::iccids() const
+{
+    QStringList result;
+    result.reserve(m_sims.size());
+    for (const auto& sim : m_sims)
+    {
+        result << sim->iccid();
+    }
+    return result;
+}
+
+int
+SimIndex::presentCount() const
+{
+    return m_byModem.size();
+}
+
+QList<Sim::Ptr>
+SimIndex::presentSims() const
+{
+    return m_byModem.values();
+}
+
+void
+SimIndex::simPresentChanged()
+{
+    auto sim_raw = qobject_cast<Sim*>(sender());
+    if (!sim_raw)
+    {
+        Q_ASSERT(0);
+        return;
+    }
+
+    auto sim = m_byIccid.value(sim_raw->iccid());
+    if (sim.get() != sim_raw)
+    {
+        return;
+    }
+    reindex(sim);
+}
+
+void
+SimIndex::reindex(Sim::Ptr sim)
+{
+    auto oldPath = m_modemPaths.value(sim->iccid());
+    auto newPath = sim->ofonoPath();
+    if (oldPath == newPath)
+    {
+        return;
+    }
+
+    QStringList changed;
+
+    // Taking a SIM out only empties the modem if nothing was put in since
+    if (!oldPath.isEmpty() && m_byModem.value(oldPath) == sim)
+    {
+        m_byModem.remove(oldPath);
+        changed << oldPath;
+    }
+
+    if (newPath.isEmpty())
+    {
+        m_modemPaths.remove(sim->iccid());
+    }
+    else
+    {
+        // A card swapped out of this modem that has not reported it yet
+        auto displaced = m_byModem.value(newPath);
+        if (displaced)
+        {
+            qDebug() << "SIM" << sim->iccid() << "replaces" << displaced->iccid() << "in" << newPath;
+            m_modemPaths.remove(displaced->iccid());
+        }
+
+        m_modemPaths.insert(sim->iccid(), newPath);
+        m_byModem.insert(newPath, sim);
+        changed << newPath;
+    }
+
+    for (const auto& path : changed)
+    {
+        Q_EMIT simForModemChanged(path);
+    }
+}
+
+}
+}
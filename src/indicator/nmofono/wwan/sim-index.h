@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <nmofono/wwan/sim.h>
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+namespace nmofono
+{
+namespace wwan
+{
+
+/**
+ * Every known SIM by ICCID, and the present ones by the path of the modem
+ * they are in.
+ *
+ * The modem paths follow each SIM's presentChanged signal, so looking up
+ * the SIM in a modem, or the modem a SIM is in, does not depend on how many
+ * SIMs or modems there are.
+ */
+class SimIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::shared_ptr<SimIndex> Ptr;
+
+    SimIndex() = default;
+
+    ~SimIndex() = default;
+
+    /**
+     * Returns false if a SIM with the same ICCID is already known.
+     */
+    bool add(Sim::Ptr sim);
+
+    Sim::Ptr sim(const QString& iccid) const;
+
+    Sim::Ptr simForModem(const QString& modemPath) const;
+
+    /**
+     * The path of the modem the SIM is in, or empty if it is not present.
+     */
+    QString modemForSim(const QString& iccid) const;
+
+    /**
+     * In the order they were added.
+     */
+    QList<Sim::Ptr> sims() const;
+
+    QStringList iccids() const;
+
+    int presentCount() const;
+
+    QList<Sim::Ptr> presentSims() const;
+
+Q_SIGNALS:
+    /**
+     * A SIM was inserted into, or taken out of, the modem.
+     */
+    void simForModemChanged(const QString& modemPath);
+
+protected Q_SLOTS:
+    void simPresentChanged();
+
+protected:
+    void reindex(Sim::Ptr sim);
+
+    QList<Sim::Ptr> m_sims;
+
+    QHash<QString, Sim::Ptr> m_byIccid;
+
+    QHash<QString, Sim::Ptr> m_byModem;
+
+    // Modem path each SIM is currently indexed under
+    QHash<QString, QString> m_modemPaths;
+};
+
+}
+}
@@ -47,7 +47,7 @@ public:
 
     SimManager& p;
 
-    QMap<QString, Sim::Ptr> m_knownSims;
+    SimIndex::Ptr m_index = make_shared<SimIndex>();
 
     shared_ptr<QOfonoManager> m_ofono;
     QMap<QString, shared_ptr<QOfonoModem>> m_ofonoModems;
@@ -81,15 +81,9 @@ public Q_SLOTS:
                 continue;
             }
             auto modem = m_ofonoModems.take(path);
-            if (m_wrappers.contains(path))
+            if (m_wrappers.remove(path))
             {
-                auto wrapper = m_wrappers[path];
-                if (m_knownSims.contains(wrapper->iccid()))
-                {
-                    auto sim = m_knownSims[wrapper->iccid()];
-                    sim->setOfonoSimManager(std::shared_ptr<QOfonoSimManager>());
-                }
-                m_wrappers.remove(path);
+                detachSim(path);
             }
         }
 
@@ -135,15 +129,9 @@ public Q_SLOTS:
             }
 
         } else {
-            if (m_wrappers.contains(modem->modemPath()))
+            if (m_wrappers.remove(modem->modemPath()))
             {
-                auto wrapper = m_wrappers[modem->modemPath()];
-                if (m_knownSims.contains(wrapper->iccid()))
-                {
-                    auto sim = m_knownSims[wrapper->iccid()];
-                    sim->setOfonoSimManager(std::shared_ptr<QOfonoSimManager>());
-                }
-                m_wrappers.remove(modem->modemPath());
+                detachSim(modem->modemPath());
             }
         }
     }
@@ -159,11 +147,7 @@ public Q_SLOTS:
 
         if (!present)
         {
-            if (m_knownSims.contains(wrapper->iccid()))
-            {
-                auto sim = m_knownSims[wrapper->iccid()];
-                sim->setOfonoSimManager(std::shared_ptr<QOfonoSimManager>());
-            }
+            detachSim(wrapper->ofonoSimManager()->modemPath());
         }
     }
 
@@ -182,23 +166,18 @@ public Q_SLOTS:
             return;
         }
 
-        bool found = false;
-        for (auto i : m_knownSims.values())
+        auto sim = m_index->sim(wrapper->iccid());
+        if (sim)
         {
-            if (wrapper->iccid() == i->iccid())
-            {
-                found = true;
-                i->setOfonoSimManager(wrapper->ofonoSimManager());
-                break;
-            }
+            sim->setOfonoSimManager(wrapper->ofonoSimManager());
         }
-        if (!found)
+        else
         {
-            auto sim = Sim::fromQOfonoSimWrapper(wrapper);
+            sim = Sim::fromQOfonoSimWrapper(wrapper);
             connect(sim.get(), &Sim::dataRoamingEnabledChanged, this, &Private::simDataRoamingEnabledChanged);
             m_settings->saveSimToSettings(sim);
-            m_knownSims[sim->iccid()] = sim;
-            m_settings->setKnownSims(m_knownSims.keys());
+            m_index->add(sim);
+            m_settings->setKnownSims(m_index->iccids());
             Q_EMIT p.simAdded(sim);
         }
     }
@@ -213,12 +192,26 @@ public Q_SLOTS:
             Q_ASSERT(0);
             return;
         }
-        if (!m_knownSims.contains(sim_raw->iccid()))
+        auto sim = m_index->sim(sim_raw->iccid());
+        if (!sim)
         {
             Q_ASSERT(0);
             return;
         }
-        m_settings->saveSimToSettings(m_knownSims[sim_raw->iccid()]);
+        m_settings->saveSimToSettings(sim);
+    }
+
+    /**
+     * Whichever SIM is in the modem, which is not necessarily the one the
+     * modem's wrapper last reported after a card has been swapped.
+     */
+    void detachSim(const QString& modemPath)
+    {
+        auto sim = m_index->simForModem(modemPath);
+        if (sim)
+        {
+            sim->setOfonoSimManager(std::shared_ptr<QOfonoSimManager>());
+        }
     }
 
 };
@@ -234,12 +227,12 @@ SimManager::SimManager(shared_ptr<QOfonoManager> ofono, ConnectivityServiceSetti
     QStringList iccids = d->m_settings->knownSims();
     for(auto iccid : iccids) {
         auto sim = d->m_settings->createSimFromSettings(iccid);
-        connect(sim.get(), &Sim::dataRoamingEnabledChanged, d.get(), &Private::simDataRoamingEnabledChanged);
         if (!sim)
         {
             continue;
         }
-        d->m_knownSims[sim->iccid()] = sim;
+        connect(sim.get(), &Sim::dataRoamingEnabledChanged, d.get(), &Private::simDataRoamingEnabledChanged);
+        d->m_index->add(sim);
     }
 
     connect(d->m_ofono.get(), &QOfonoManager::modemsChanged, d.get(), &Private::modemsChanged);
@@ -252,7 +245,13 @@ SimManager::~SimManager()
 QList<Sim::Ptr>
 SimManager::knownSims() const
 {
-    return d->m_knownSims.values();
+    return d->m_index->sims();
+}
+
+SimIndex::Ptr
+SimManager::index() const
+{
+    return d->m_index;
 }
 
 }
@@ -25,6 +25,7 @@
 #include <memory>
 
 #include "sim.h"
+#include <nmofono/wwan/sim-index.h>
 #include <nmofono/connectivity-service-settings.h>
 
 class QOfonoManager;
@@ -51,6 +52,11 @@ public:
 
     QList<Sim::Ptr> knownSims() const;
 
+    /**
+     * Shared with the manager, so both look SIMs up the same way.
+     */
+    SimIndex::Ptr index() const;
+
 Q_SIGNALS:
     void simAdded(Sim::Ptr sim);
 };
@@ -27,15 +27,71 @@
 
 #include <functional>
 #include <QDebug>
+#include <QTimer>
 
 using namespace std;
 using namespace nmofono;
 
+namespace
+{
+
+/**
+ * A contiguous run of the indicator icons together with their serialized
+ * GIcons, which come from the interned IconCache.
+ */
+class IconSlot
+{
+public:
+    /// returns true if the names changed
+    bool set(const QStringList& names)
+    {
+        if (names == m_names)
+        {
+            return false;
+        }
+
+        m_names = names;
+        m_icons.clear();
+        for (const auto& name : names)
+        {
+            // null for invalid names, which are skipped when building the state
+            m_icons.push_back(IconCache::get(name).icon);
+        }
+        return true;
+    }
+
+    const vector<Variant>& icons() const
+    {
+        return m_icons;
+    }
+
+private:
+    QStringList m_names;
+
+    vector<Variant> m_icons;
+};
+
+}
+
 class RootState::Private : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * Inputs to the root state. Signals only mark their inputs as dirty,
+     * the state itself is recomputed once per event loop iteration.
+     */
+    enum Input
+    {
+        FLIGHT_MODE = 1 << 0,
+        MODEMS = 1 << 1,
+        LINKS = 1 << 2,
+        TRANSFER = 1 << 3,
+        HOTSPOT = 1 << 4,
+        ALL = FLIGHT_MODE | MODEMS | LINKS | TRANSFER | HOTSPOT
+    };
+
     RootState& p;
 
     Manager::Ptr m_manager;
@@ -43,55 +99,110 @@ public:
 
     string m_label;
 
-    QStringList m_networkingIcons;
+    unsigned int m_dirty = 0;
+    QSet<int> m_dirtyModems;
+    QTimer m_recomputeTimer;
 
+    QMap<int, wwan::Modem::Ptr> m_modems;
     QMap<int, QString> m_cellularIcons;
     QMap<int, QString> m_modemTechIcons;
+    QMap<int, bool> m_modemDataEnabled;
 
-    int m_activeModem = -1;
+    QStringList m_linkIcons;
+    QStringList m_transferIcons;
+
+    IconSlot m_flightModeSlot;
+    IconSlot m_cellularSlot;
+    IconSlot m_networkingSlot;
 
     Private(RootState& parent, nmofono::Manager::Ptr manager);
 
-    Variant createIcon(const string& name);
+    void markDirty(unsigned int inputs);
 
     void updateModems();
 
     void updateModem(const wwan::Modem& modem);
 
-public Q_SLOTS:
-    void updateNetworkingIcon();
+    int activeModem() const;
+
+    void updateLinkIcons();
+
+    void updateTransferIcons();
+
+    QStringList networkingIcons() const;
+
+    QStringList cellularIcons() const;
 
     void updateRootState();
+
+public Q_SLOTS:
+    void recompute();
+
+    void linkUpdated();
+
+    void modemUpdated();
 };
 
 RootState::Private::Private(RootState& parent, nmofono::Manager::Ptr manager)
     : p{parent},
       m_manager{manager}
 {
-    connect(m_manager.get(), &nmofono::Manager::flightModeUpdated, this, &Private::updateRootState);
+    m_recomputeTimer.setSingleShot(true);
+    m_recomputeTimer.setInterval(0);
+    connect(&m_recomputeTimer, &QTimer::timeout, this, &Private::recompute);
+
+    connect(m_manager.get(), &nmofono::Manager::flightModeUpdated, this, [this]{ markDirty(FLIGHT_MODE); });
+
+    connect(m_manager.get(), &nmofono::Manager::hotspotEnabledChanged, this, [this]{ markDirty(HOTSPOT); });
+    connect(m_manager.get(), &Manager::statusUpdated, this, [this]{ markDirty(LINKS); });
+    connect(m_manager.get(), &Manager::linksUpdated, this, [this]{ markDirty(LINKS | MODEMS); });
 
-    connect(m_manager.get(), &nmofono::Manager::hotspotEnabledChanged, this, &Private::updateNetworkingIcon);
-    connect(m_manager.get(), &Manager::statusUpdated, this, &Private::updateNetworkingIcon);
-    connect(m_manager.get(), &Manager::linksUpdated, this, &Private::updateNetworkingIcon);
+    connect(m_manager.get(), &nmofono::Manager::txChanged, this, [this]{ markDirty(TRANSFER); });
+    connect(m_manager.get(), &nmofono::Manager::rxChanged, this, [this]{ markDirty(TRANSFER); });
+
+    // the initial state is needed straight away
+    m_dirty = ALL;
+    recompute();
+}
+
+void
+RootState::Private::markDirty(unsigned int inputs)
+{
+    m_dirty |= inputs;
+    if (!m_recomputeTimer.isActive())
+    {
+        m_recomputeTimer.start();
+    }
+}
 
-    connect(m_manager.get(), &nmofono::Manager::txChanged, this, &Private::updateNetworkingIcon);
-    connect(m_manager.get(), &nmofono::Manager::rxChanged, this, &Private::updateNetworkingIcon);
+void
+RootState::Private::linkUpdated()
+{
+    markDirty(LINKS);
+}
 
-    // will also call updateRootState()
-    updateNetworkingIcon();
+void
+RootState::Private::modemUpdated()
+{
+    auto modem = qobject_cast<wwan::Modem*>(sender());
+    if (modem)
+    {
+        m_dirtyModems.insert(modem->index());
+        markDirty(0);
+    }
 }
 
 void
 RootState::Private::updateModems()
 {
-    QMap<int, wwan::Modem::Ptr> modems;
+    m_modems.clear();
     for (auto modem : m_manager->modemLinks())
     {
-        modems[modem->index()] = modem;
+        m_modems[modem->index()] = modem;
     }
 
     QSet<int> current = m_cellularIcons.keys().toSet();
-    QSet<int> updated = modems.keys().toSet();
+    QSet<int> updated = m_modems.keys().toSet();
 
     QSet<int> removed(current);
     removed.subtract(updated);
@@ -102,15 +213,16 @@ RootState::Private::updateModems()
     for (auto index : removed)
     {
         m_cellularIcons.remove(index);
+        m_modemTechIcons.remove(index);
+        m_modemDataEnabled.remove(index);
     }
 
     for (auto index : added) {
         // modem properties and signals already synced with GMainLoop
-        connect(modems[index].get(), &wwan::Modem::updated, this, &Private::updateNetworkingIcon);
+        connect(m_modems[index].get(), &wwan::Modem::updated, this, &Private::modemUpdated, Qt::UniqueConnection);
     }
 
-    m_activeModem = -1;
-    for (auto modem : modems)
+    for (auto modem : m_modems)
     {
         updateModem(*modem);
     }
@@ -129,14 +241,14 @@ RootState::Private::updateModem(const wwan::Modem& modem)
         switch(modem.simStatus())
         {
         case wwan::Modem::SimStatus::missing:
-            newCellularIcon = "no-simcard";
+            newCellularIcon = QStringLiteral("no-simcard");
             break;
         case wwan::Modem::SimStatus::error:
-            newCellularIcon = "simcard-error";
+            newCellularIcon = QStringLiteral("simcard-error");
             break;
         case wwan::Modem::SimStatus::locked:
         case wwan::Modem::SimStatus::permanentlyLocked:
-            newCellularIcon = "simcard-locked";
+            newCellularIcon = QStringLiteral("simcard-locked");
             break;
         case wwan::Modem::SimStatus::ready:
         {
@@ -145,156 +257,158 @@ RootState::Private::updateModem(const wwan::Modem& modem)
             case wwan::Modem::ModemStatus::unregistered:
             case wwan::Modem::ModemStatus::unknown:
             case wwan::Modem::ModemStatus::searching:
-                newCellularIcon = "gsm-3g-disabled";
+                newCellularIcon = QStringLiteral("gsm-3g-disabled");
                 break;
             case wwan::Modem::ModemStatus::denied:
                 /// @todo we might need network-error for this
-                newCellularIcon = "gsm-3g-disabled";
+                newCellularIcon = QStringLiteral("gsm-3g-disabled");
                 break;
             case wwan::Modem::ModemStatus::registered:
             case wwan::Modem::ModemStatus::roaming:
                 if (modem.strength() != 0) {
-                    newCellularIcon = Icons::strengthIcon(modem.strength());
-                    newModemTechIcon = Icons::bearerIcon(modem.bearer());
+                    newCellularIcon = Icons::strengthIcon(modem.strength()).name;
+                    newModemTechIcon = Icons::bearerIcon(modem.bearer()).name;
                 } else {
-                    newCellularIcon = "gsm-3g-no-service";
+                    newCellularIcon = QStringLiteral("gsm-3g-no-service");
                 }
                 break;
             }
             break;
         }
         case wwan::Modem::SimStatus::not_available:
-            newCellularIcon = "no-simcard";
+            newCellularIcon = QStringLiteral("no-simcard");
             break;
         }
     }
 
     m_cellularIcons[index] = newCellularIcon;
     m_modemTechIcons[index] = newModemTechIcon;
+    m_modemDataEnabled[index] = modem.dataEnabled();
+}
 
-    if (modem.dataEnabled())
+int
+RootState::Private::activeModem() const
+{
+    // the last modem with mobile data enabled
+    int active = -1;
+    QMapIterator<int, bool> it(m_modemDataEnabled);
+    while (it.hasNext())
     {
-        m_activeModem = index;
+        it.next();
+        if (it.value())
+        {
+            active = it.key();
+        }
     }
+    return active;
 }
 
 void
-RootState::Private::updateNetworkingIcon()
+RootState::Private::updateLinkIcons()
 {
-    m_networkingIcons.clear();
+    m_linkIcons.clear();
 
-    updateModems();
+    multimap<Link::Id, ethernet::EthernetLink::SPtr> sortedEthernetLinks;
+    for (auto ethernetLink : m_manager->ethernetLinks())
+    {
+        sortedEthernetLinks.insert(make_pair(ethernetLink->id(), ethernetLink));
+    }
+    for (auto pair : sortedEthernetLinks)
+    {
+        auto ethernetLink = pair.second;
 
-    switch (m_manager->status()) {
-    case Manager::NetworkingStatus::offline:
-        m_networkingIcons << "nm-no-connection";
-        //a11ydesc = _("Network (none)");
-        break;
-    case Manager::NetworkingStatus::connecting:
-        m_networkingIcons << "nm-no-connection";
-        // some sort of connection animation
-        break;
-    case Manager::NetworkingStatus::online:
-        multimap<Link::Id, ethernet::EthernetLink::SPtr> sortedEthernetLinks;
-        for (auto ethernetLink : m_manager->ethernetLinks())
-        {
-            sortedEthernetLinks.insert(make_pair(ethernetLink->id(), ethernetLink));
-        }
-        for (auto pair : sortedEthernetLinks)
-        {
-            auto ethernetLink = pair.second;
+        connect(ethernetLink.get(), &ethernet::EthernetLink::statusUpdated, this,
+                &Private::linkUpdated, Qt::UniqueConnection);
 
-            connect(ethernetLink.get(), &ethernet::EthernetLink::statusUpdated, this,
-                    &Private::updateNetworkingIcon, Qt::UniqueConnection);
+        auto status = ethernetLink->status();
+        m_linkIcons << Icons::ethernetIcon(status).name;
+    }
 
-            auto status = ethernetLink->status();
-            m_networkingIcons << Icons::ethernetIcon(status);
+    for (auto wifiLink : m_manager->wifiLinks())
+    {
+        connect(wifiLink.get(), &wifi::WifiLink::statusUpdated, this,
+                &Private::linkUpdated, Qt::UniqueConnection);
+        connect(wifiLink.get(), &wifi::WifiLink::signalUpdated, this,
+                &Private::linkUpdated, Qt::UniqueConnection);
+
+        if (wifiLink->status() != Link::Status::online
+                && wifiLink->status() != Link::Status::connected)
+        {
+            continue;
         }
 
-        for (auto wifiLink : m_manager->wifiLinks())
+        auto signal = wifiLink->signal();
+        if (signal != wifi::WifiLink::Signal::disconnected)
         {
-            connect(wifiLink.get(), &wifi::WifiLink::statusUpdated, this,
-                    &Private::updateNetworkingIcon, Qt::UniqueConnection);
-            connect(wifiLink.get(), &wifi::WifiLink::signalUpdated, this,
-                    &Private::updateNetworkingIcon, Qt::UniqueConnection);
+            m_linkIcons << Icons::wifiIcon(signal).name;
+        }
+    }
+}
 
-            if (wifiLink->status() != Link::Status::online
-                    && wifiLink->status() != Link::Status::connected)
-            {
-                continue;
-            }
+void
+RootState::Private::updateTransferIcons()
+{
+    m_transferIcons.clear();
 
-            auto signal = wifiLink->signal();
-            if (signal != wifi::WifiLink::Signal::disconnected)
-            {
-                m_networkingIcons << Icons::wifiIcon(signal);
-            }
+    if (m_manager->rx() && m_manager->tx())
+    {
+        m_transferIcons << QStringLiteral("transfer-progress");
+    }
+    else
+    {
+        if (m_manager->rx()){
+            m_transferIcons << QStringLiteral("transfer-progress-download");
         }
 
-        if (m_manager->rx() && m_manager->tx())
-        {
-            m_networkingIcons << "transfer-progress";
+        if (m_manager->tx()){
+            m_transferIcons << QStringLiteral("transfer-progress-upload");
         }
-        else
-        {
-            if (m_manager->rx()){
-                m_networkingIcons << "transfer-progress-download";
-            }
+    }
+}
 
-            if (m_manager->tx()){
-                m_networkingIcons << "transfer-progress-upload";
-            }
-        }
+QStringList
+RootState::Private::networkingIcons() const
+{
+    QStringList icons;
+
+    switch (m_manager->status()) {
+    case Manager::NetworkingStatus::offline:
+        icons << QStringLiteral("nm-no-connection");
+        //a11ydesc = _("Network (none)");
+        break;
+    case Manager::NetworkingStatus::connecting:
+        icons << QStringLiteral("nm-no-connection");
+        // some sort of connection animation
+        break;
+    case Manager::NetworkingStatus::online:
+        icons << m_linkIcons << m_transferIcons;
 
         // Splat WiFi icons if we are using the hotspot
-        if (m_networkingIcons.isEmpty() || m_manager->hotspotEnabled())
+        if (icons.isEmpty() || m_manager->hotspotEnabled())
         {
-            m_networkingIcons.clear();
+            icons.clear();
 
-            if (m_activeModem != -1) {
-                auto it = m_modemTechIcons.find(m_activeModem);
-                if (it != m_modemTechIcons.end())
-                {
-                    m_networkingIcons << it.value();
-                }
+            auto it = m_modemTechIcons.find(activeModem());
+            if (it != m_modemTechIcons.end() && !it.value().isEmpty())
+            {
+                icons << it.value();
             }
         }
 
         if (m_manager->hotspotEnabled())
         {
-            m_networkingIcons << "hotspot-active";
+            icons << QStringLiteral("hotspot-active");
         }
         break;
     }
 
-    updateRootState();
+    return icons;
 }
 
-Variant
-RootState::Private::createIcon(const string& name)
+QStringList
+RootState::Private::cellularIcons() const
 {
-    GError *error = nullptr;
-    auto gicon = shared_ptr<GIcon>(g_icon_new_for_string(name.c_str(), &error), GObjectDeleter());
-    if (error) {
-        string message(error->message);
-        g_error_free(error);
-        throw runtime_error("Could not create GIcon: " + message);
-    }
-
-    Variant ret = Variant::fromGVariant(g_icon_serialize(gicon.get()));
-    return ret;
-}
-
-void
-RootState::Private::updateRootState()
-{
-    vector<string> icons;
-    map<string, Variant> state;
-
-    if(m_manager->flightMode())
-    {
-        icons.push_back("airplane-mode");
-    }
+    QStringList icons;
 
     multimap<int, QString, wwan::WwanLink::Compare> sorted;
     QMapIterator<int, QString> iconIt(m_cellularIcons);
@@ -307,30 +421,97 @@ RootState::Private::updateRootState()
     {
         if (!pair.second.isEmpty())
         {
-            icons.push_back(pair.second.toStdString());
+            icons << pair.second;
         }
     }
 
     if (m_manager->roaming())
     {
-        icons.push_back("network-cellular-roaming");
+        icons << QStringLiteral("network-cellular-roaming");
     }
 
-    if (!m_networkingIcons.isEmpty()) {
-        /* We're doing icon always right now so we have a fallback before everyone
-           supports multi-icon.  We shouldn't set both in the future. */
-        try {
-            state["icon"] = createIcon(m_networkingIcons.first().toStdString());
-        } catch (exception &e) {
-            qWarning() << e.what();
+    return icons;
+}
+
+void
+RootState::Private::recompute()
+{
+    auto dirty = m_dirty;
+    m_dirty = 0;
+    auto dirtyModems = m_dirtyModems;
+    m_dirtyModems.clear();
+
+    bool modemsChanged = (dirty & MODEMS) || !dirtyModems.isEmpty();
+    if (dirty & MODEMS)
+    {
+        updateModems();
+    }
+    else
+    {
+        for (auto index : dirtyModems)
+        {
+            auto modem = m_modems.find(index);
+            if (modem != m_modems.end())
+            {
+                updateModem(*modem.value());
+            }
         }
+    }
+
+    if (dirty & LINKS)
+    {
+        updateLinkIcons();
+    }
+    if (dirty & TRANSFER)
+    {
+        updateTransferIcons();
+    }
 
-        for (const auto& icon: m_networkingIcons)
+    bool changed = false;
+    if (dirty & FLIGHT_MODE)
+    {
+        changed |= m_flightModeSlot.set(m_manager->flightMode() ? QStringList{QStringLiteral("airplane-mode")} : QStringList());
+    }
+    if (modemsChanged)
+    {
+        changed |= m_cellularSlot.set(cellularIcons());
+    }
+    if (modemsChanged || (dirty & (LINKS | TRANSFER | HOTSPOT)))
+    {
+        changed |= m_networkingSlot.set(networkingIcons());
+    }
+
+    if (changed || !m_state)
+    {
+        updateRootState();
+    }
+}
+
+void
+RootState::Private::updateRootState()
+{
+    map<string, Variant> state;
+
+    vector<Variant> icons;
+    for (auto slot : {&m_flightModeSlot, &m_cellularSlot, &m_networkingSlot})
+    {
+        for (const auto& icon : slot->icons())
         {
-            icons.push_back(icon.toStdString());
+            if (icon)
+            {
+                icons.push_back(icon);
+            }
         }
     }
 
+    /* We're doing icon always right now so we have a fallback before everyone
+       supports multi-icon.  We shouldn't set both in the future. */
+    const auto& networkingIcons = m_networkingSlot.icons();
+    if (!networkingIcons.empty() && networkingIcons.front())
+    {
+        state["icon"] = networkingIcons.front();
+    }
+
     if (!m_label.empty())
     {
         state["label"] = TypedVariant<string>(m_label);
@@ -342,17 +523,8 @@ RootState::Private::updateRootState()
     /// @todo state["accessibility-desc"] = TypedVariant<string>(a11ydesc);
     state["visible"] = TypedVariant<bool>(true); /// @todo is this really necessary/useful?
 
-
     if (!icons.empty()) {
-        vector<Variant> iconVariants;
-        for (auto name : icons) {
-            try {
-                iconVariants.push_back(createIcon(name));
-            } catch (exception &e) {
-                cerr << e.what();
-            }
-        }
-        state["icons"] = TypedVariant<vector<Variant>>(iconVariants);
+        state["icons"] = TypedVariant<vector<Variant>>(icons);
     }
 
     TypedVariant<map<string, Variant>> new_state(state);
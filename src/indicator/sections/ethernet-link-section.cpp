@@ -102,6 +102,9 @@ public Q_SLOTS:
             connect(connection.get(), &AvailableConnection::connectionIdChanged, this, &Private::updateConnections, Qt::UniqueConnection);
         }
 
+        // publish the rebuild below as a single change
+        ScopedTransaction<Menu> transaction(*m_connectionsMenu);
+
         m_connectionsMenu->clear();
 
         if (!m_isSettingsMenu && connections.size() <= 1)
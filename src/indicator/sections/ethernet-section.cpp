@@ -75,6 +75,9 @@ public Q_SLOTS:
             return;
         }
 
+        // publish the rebuild below as a single change
+        ScopedTransaction<MenuMerger> transaction(*m_menuMerger);
+
         m_links->clear();
 
         for (auto connection : removed)
@@ -80,6 +80,10 @@ public Q_SLOTS:
             m_actionGroupMerger->add(item->actionGroup());
         }
 
+        // publish the rebuild below as a single change
+        ScopedTransaction<MenuMerger> mergerTransaction(*m_menuMerger);
+        ScopedTransaction<Menu> connectionsTransaction(*m_connectionsMenu);
+
         // for now just throw everything away and rebuild
         /// @todo add MenuMerger::insert() and ::find()
         m_connectionsMenu->clear();
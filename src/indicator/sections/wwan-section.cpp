@@ -120,6 +120,9 @@ WwanSection::Private::modemsChanged()
         m_actionGroupMerger->add(item->actionGroup());
     }
 
+    // publish the rebuild below as a single change
+    ScopedTransaction<MenuMerger> transaction(*m_menuMerger);
+
     // for now just throw everything away and rebuild
     /// @todo add MenuMerger::insert() and ::find()
     m_linkMenuMerger->clear();
@@ -19,11 +19,10 @@
 
 #include "action-group-exporter.h"
 
-#include <unity/util/ResourcePtr.h>
 #include <QDebug>
+#include <QTimer>
 
 using namespace std;
-namespace util = unity::util;
 
 ActionGroupExporter::ActionGroupExporter(SessionBus::Ptr sessionBus,
                                          ActionGroup::Ptr actionGroup,
@@ -31,7 +30,9 @@ ActionGroupExporter::ActionGroupExporter(SessionBus::Ptr sessionBus,
     : m_path(path),
       m_sessionBus(sessionBus),
       m_exportId {0},
-      m_actionGroup {actionGroup}
+      m_actionGroup {actionGroup},
+      m_changedSubscription {0},
+      m_exported {false}
 {
     m_gSimpleActionGroup = make_gsimpleactiongroup_ptr();
 
@@ -47,6 +48,7 @@ ActionGroupExporter::ActionGroupExporter(SessionBus::Ptr sessionBus,
         }
         g_error_free(error);
         /// @todo throw something
+        m_exported = true;
         return;
     }
 
@@ -56,11 +58,14 @@ ActionGroupExporter::ActionGroupExporter(SessionBus::Ptr sessionBus,
     connect(actionGroup.get(), &ActionGroup::actionAdded, this, &ActionGroupExporter::actionAdded);
     connect(actionGroup.get(), &ActionGroup::actionRemoved, this, &ActionGroupExporter::actionRemoved);
 
-    waitForFirstSignalEmission();
+    watchFirstSignalEmission();
 }
 
 ActionGroupExporter::~ActionGroupExporter()
 {
+    if (m_changedSubscription)
+        g_dbus_connection_signal_unsubscribe(m_sessionBus->bus().get(), m_changedSubscription);
+
     if (!m_exportId)
         return;
     g_dbus_connection_unexport_action_group(m_sessionBus->bus().get(), m_exportId);
@@ -84,46 +89,48 @@ void ActionGroupExporter::actionRemoved(Action::Ptr action)
                                        action->name().toUtf8().constData());
 }
 
-void ActionGroupExporter::waitForFirstSignalEmission()
+bool ActionGroupExporter::isExported() const
 {
-    shared_ptr<GMainLoop> loop(g_main_loop_new(nullptr, FALSE), &g_main_loop_unref);
+    return m_exported;
+}
+
+void ActionGroupExporter::setExported()
+{
+    if (m_exported)
+        return;
 
+    if (m_changedSubscription)
+    {
+        g_dbus_connection_signal_unsubscribe(m_sessionBus->bus().get(), m_changedSubscription);
+        m_changedSubscription = 0;
+    }
+
+    m_exported = true;
+    Q_EMIT exported();
+}
+
+void ActionGroupExporter::watchFirstSignalEmission()
+{
     /* Our two exit criteria */
-    util::ResourcePtr<gulong,
-        function<void(guint)>> signal(
-            g_dbus_connection_signal_subscribe(m_sessionBus->bus().get(),
-                g_dbus_connection_get_unique_name(m_sessionBus->bus().get()),
-                "org.gtk.Actions",
-                "Changed",
-                m_path.c_str(),
-                nullptr,
-                G_DBUS_SIGNAL_FLAGS_NONE,
-                [](GDBusConnection *,
-                        const gchar *,
-                        const gchar *,
-                        const gchar *,
-                        const gchar *,
-                        GVariant *,
-                        gpointer user_data)
-                {
-                    g_main_loop_quit((GMainLoop*) user_data);
-                },
-                loop.get(),
-                nullptr),
-        [this](guint s)
-        {
-            g_dbus_connection_signal_unsubscribe (m_sessionBus->bus().get(), s);
-        });
-
-    util::ResourcePtr<guint, function<void(guint)>> timer(g_timeout_add(200,
-            [](gpointer user_data) -> gboolean
+    m_changedSubscription = g_dbus_connection_signal_subscribe(m_sessionBus->bus().get(),
+            g_dbus_connection_get_unique_name(m_sessionBus->bus().get()),
+            "org.gtk.Actions",
+            "Changed",
+            m_path.c_str(),
+            nullptr,
+            G_DBUS_SIGNAL_FLAGS_NONE,
+            [](GDBusConnection *,
+                    const gchar *,
+                    const gchar *,
+                    const gchar *,
+                    const gchar *,
+                    GVariant *,
+                    gpointer user_data)
             {
-                g_main_loop_quit((GMainLoop *)user_data);
-                return G_SOURCE_CONTINUE;
+                static_cast<ActionGroupExporter*>(user_data)->setExported();
             },
-            loop.get()),
-            &g_source_remove);
+            this,
+            nullptr);
 
-    /* Wait for sync */
-    g_main_loop_run(loop.get());
+    QTimer::singleShot(200, this, &ActionGroupExporter::setExported);
 }
@@ -38,6 +38,8 @@ class ActionGroupExporter: public QObject
     GSimpleActionGroupPtr m_gSimpleActionGroup;
     gint m_exportId;
     ActionGroup::Ptr m_actionGroup;
+    guint m_changedSubscription;
+    bool m_exported;
 
 public:
     typedef std::shared_ptr<ActionGroupExporter> Ptr;
@@ -47,11 +49,22 @@ public:
 
     ~ActionGroupExporter();
 
+    /**
+     * True once the action group has emitted its first Changed signal
+     * on the bus, or a short timeout has passed.
+     */
+    bool isExported() const;
+
+Q_SIGNALS:
+    void exported();
+
 private:
-    void waitForFirstSignalEmission();
+    void watchFirstSignalEmission();
 
 private Q_SLOTS:
     void actionAdded(Action::Ptr);
 
     void actionRemoved(Action::Ptr);
+
+    void setExported();
 };
@@ -99,12 +99,19 @@ Action::setEnabled(bool enabled)
 void
 Action::setState(const Variant &value)
 {
-    if (value == state())
+    auto current = state();
+    if (static_cast<GVariant*>(current) != static_cast<GVariant*>(m_state))
+    {
+        m_state = current;
+    }
+
+    if (value == m_state)
     {
         return;
     }
 
     g_simple_action_set_state(G_SIMPLE_ACTION(m_gaction.get()), value);
+    m_state = value;
 
     Q_EMIT stateUpdated(state());
 }
@@ -40,6 +40,9 @@ class Action: public QObject
     gulong m_activateHandlerId;
     gulong m_changeStateHandlerId;
 
+    // the last state we set, which keeps its structural hash cached
+    Variant m_state;
+
     static void activate_cb(GSimpleAction *,
                             GVariant      *parameter,
                             gpointer       user_data);
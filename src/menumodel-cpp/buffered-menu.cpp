@@ -0,0 +1,71 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#include "buffered-menu.h"
+
+#include <cassert>
+
+using namespace std;
+
+BufferedMenu::BufferedMenu()
+{
+    m_gmenu = make_gmenu_ptr();
+    m_model.reset(buffered_menu_model_new(G_MENU_MODEL(m_gmenu.get())), GObjectDeleter());
+}
+
+BufferedMenu::~BufferedMenu()
+{
+}
+
+void BufferedMenu::beginTransaction()
+{
+    if (m_transactionDepth++ == 0)
+    {
+        buffered_menu_model_freeze(m_model.get());
+    }
+}
+
+void BufferedMenu::commitTransaction()
+{
+    assert(m_transactionDepth > 0);
+    if (--m_transactionDepth > 0)
+    {
+        return;
+    }
+
+    // an item edited several times is only re-inserted once
+    set<MenuItem*> changed;
+    changed.swap(m_changedItems);
+    for (auto item : changed)
+    {
+        refreshItem(item);
+    }
+
+    buffered_menu_model_thaw(m_model.get());
+}
+
+void BufferedMenu::itemChanged()
+{
+    auto item = qobject_cast<MenuItem*>(sender());
+
+    // even outside a transaction the remove + insert is published as one change
+    beginTransaction();
+    m_changedItems.insert(item);
+    commitTransaction();
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <memory>
+#include <set>
+
+#include <gio/gio.h>
+
+#include "gio-helpers/buffered-menu-model.h"
+#include "gio-helpers/util.h"
+#include "menu-model.h"
+#include "menu-item.h"
+
+/**
+ * A GMenu behind a BufferedMenuModel, with the transaction handling that
+ * Menu and SortedMenu share.
+ *
+ * Transactions nest; every item edit and structural change made in between
+ * is published as one items-changed range when the outermost transaction
+ * commits. Subclasses connect their items' changed signal to itemChanged()
+ * and re-insert an edited item in refreshItem().
+ */
+class BufferedMenu : public MenuModel
+{
+    Q_OBJECT
+
+    unsigned int m_transactionDepth = 0;
+    std::set<MenuItem*> m_changedItems;
+
+protected:
+    GMenuPtr m_gmenu;
+    std::shared_ptr<BufferedMenuModel> m_model;
+
+    BufferedMenu();
+
+    /// replaces the item's GMenu entry with its current state
+    virtual void refreshItem(MenuItem* item) = 0;
+
+public:
+    virtual ~BufferedMenu();
+
+    void beginTransaction() override;
+
+    void commitTransaction() override;
+
+    operator GMenuModel*() override { return G_MENU_MODEL(m_model.get()); }
+
+protected Q_SLOTS:
+    void itemChanged();
+};
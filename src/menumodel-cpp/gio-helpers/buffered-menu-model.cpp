@@ -0,0 +1,174 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#include "buffered-menu-model.h"
+
+struct _BufferedMenuModel
+{
+    GMenuModel parent_instance;
+
+    GMenuModel* backing;
+    gulong handler;
+
+    guint freeze_count;
+
+    // pending change, in the same terms as items-changed:
+    // items [position, position + added) of the backing model replace
+    // items [position, position + removed) of what was last emitted.
+    gboolean pending;
+    gint position;
+    gint removed;
+    gint added;
+};
+
+struct _BufferedMenuModelClass
+{
+    GMenuModelClass parent_class;
+};
+
+G_DEFINE_TYPE(BufferedMenuModel, buffered_menu_model, G_TYPE_MENU_MODEL)
+
+static void
+buffered_menu_model_backing_changed(GMenuModel*, gint position, gint removed, gint added, gpointer user_data)
+{
+    BufferedMenuModel* self = BUFFERED_MENU_MODEL(user_data);
+
+    if (self->freeze_count == 0)
+    {
+        g_menu_model_items_changed(G_MENU_MODEL(self), position, removed, added);
+        return;
+    }
+
+    if (!self->pending)
+    {
+        self->pending = TRUE;
+        self->position = position;
+        self->removed = removed;
+        self->added = added;
+        return;
+    }
+
+    // Grow the pending range so it covers the new edit. Everything
+    // before lo and after hi is untouched by either change.
+    gint lo = MIN(self->position, position);
+    gint hi = MAX(self->position + self->added, position + removed);
+
+    self->removed = hi - lo - (self->added - self->removed);
+    self->added = hi - lo + (added - removed);
+    self->position = lo;
+}
+
+static gboolean
+buffered_menu_model_is_mutable(GMenuModel*)
+{
+    return TRUE;
+}
+
+static gint
+buffered_menu_model_get_n_items(GMenuModel* model)
+{
+    return g_menu_model_get_n_items(BUFFERED_MENU_MODEL(model)->backing);
+}
+
+static void
+buffered_menu_model_get_item_attributes(GMenuModel* model, gint position, GHashTable** table)
+{
+    GMenuModel* backing = BUFFERED_MENU_MODEL(model)->backing;
+    G_MENU_MODEL_GET_CLASS(backing)->get_item_attributes(backing, position, table);
+}
+
+static void
+buffered_menu_model_get_item_links(GMenuModel* model, gint position, GHashTable** table)
+{
+    GMenuModel* backing = BUFFERED_MENU_MODEL(model)->backing;
+    G_MENU_MODEL_GET_CLASS(backing)->get_item_links(backing, position, table);
+}
+
+static void
+buffered_menu_model_finalize(GObject* object)
+{
+    BufferedMenuModel* self = BUFFERED_MENU_MODEL(object);
+
+    g_signal_handler_disconnect(self->backing, self->handler);
+    g_object_unref(self->backing);
+
+    G_OBJECT_CLASS(buffered_menu_model_parent_class)->finalize(object);
+}
+
+static void
+buffered_menu_model_init(BufferedMenuModel* self)
+{
+    self->backing = nullptr;
+    self->handler = 0;
+    self->freeze_count = 0;
+    self->pending = FALSE;
+}
+
+static void
+buffered_menu_model_class_init(BufferedMenuModelClass* klass)
+{
+    GObjectClass* object_class = G_OBJECT_CLASS(klass);
+    GMenuModelClass* model_class = G_MENU_MODEL_CLASS(klass);
+
+    object_class->finalize = buffered_menu_model_finalize;
+
+    model_class->is_mutable = buffered_menu_model_is_mutable;
+    model_class->get_n_items = buffered_menu_model_get_n_items;
+    model_class->get_item_attributes = buffered_menu_model_get_item_attributes;
+    model_class->get_item_links = buffered_menu_model_get_item_links;
+}
+
+BufferedMenuModel*
+buffered_menu_model_new(GMenuModel* backing)
+{
+    BufferedMenuModel* self = BUFFERED_MENU_MODEL(g_object_new(BUFFERED_TYPE_MENU_MODEL, nullptr));
+
+    self->backing = G_MENU_MODEL(g_object_ref(backing));
+    self->handler = g_signal_connect(backing, "items-changed",
+                                     G_CALLBACK(buffered_menu_model_backing_changed), self);
+
+    return self;
+}
+
+void
+buffered_menu_model_freeze(BufferedMenuModel* self)
+{
+    ++self->freeze_count;
+}
+
+void
+buffered_menu_model_thaw(BufferedMenuModel* self)
+{
+    g_return_if_fail(self->freeze_count > 0);
+
+    if (--self->freeze_count > 0 || !self->pending)
+    {
+        return;
+    }
+
+    self->pending = FALSE;
+
+    // e.g. an item inserted and removed again within the same transaction
+    if (self->removed == 0 && self->added == 0)
+    {
+        return;
+    }
+
+    g_menu_model_items_changed(G_MENU_MODEL(self), self->position, self->removed, self->added);
+}
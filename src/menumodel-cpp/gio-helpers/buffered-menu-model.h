@@ -0,0 +1,48 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+/*
+ * A read-only GMenuModel that mirrors a backing model.
+ *
+ * While the model is frozen, items-changed emissions from the backing model
+ * are folded into a single range covering every edit; thawing emits that
+ * range once. Consumers must not read the model between freeze and thaw,
+ * so a freeze should never outlive the current main loop iteration.
+ */
+typedef struct _BufferedMenuModel BufferedMenuModel;
+typedef struct _BufferedMenuModelClass BufferedMenuModelClass;
+
+#define BUFFERED_TYPE_MENU_MODEL (buffered_menu_model_get_type())
+#define BUFFERED_MENU_MODEL(inst) (G_TYPE_CHECK_INSTANCE_CAST((inst), BUFFERED_TYPE_MENU_MODEL, BufferedMenuModel))
+
+GType buffered_menu_model_get_type(void);
+
+BufferedMenuModel* buffered_menu_model_new(GMenuModel* backing);
+
+void buffered_menu_model_freeze(BufferedMenuModel* self);
+
+void buffered_menu_model_thaw(BufferedMenuModel* self);
+
+G_END_DECLS
@@ -0,0 +1,113 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#include "variant.h"
+
+namespace
+{
+
+/*
+ * Arrays of basic types are serialized canonically, so they can be hashed
+ * and compared as raw bytes instead of one child at a time.
+ */
+bool
+isBasicArray(GVariant *variant)
+{
+    const GVariantType *type = g_variant_get_type(variant);
+    return g_variant_type_is_array(type)
+            && g_variant_type_is_basic(g_variant_type_element(type));
+}
+
+guint
+combine(guint hash, guint value)
+{
+    return hash * 31 + value;
+}
+
+}
+
+guint
+Variant::structuralHash(GVariant *variant)
+{
+    guint hash = g_variant_classify(variant);
+
+    if (!g_variant_is_container(variant))
+    {
+        return combine(hash, g_variant_hash(variant));
+    }
+
+    if (isBasicArray(variant))
+    {
+        auto data = static_cast<const guchar*>(g_variant_get_data(variant));
+        gsize size = g_variant_get_size(variant);
+        for (gsize i = 0; i < size; ++i)
+        {
+            hash = combine(hash, data[i]);
+        }
+        return hash;
+    }
+
+    gsize n = g_variant_n_children(variant);
+    for (gsize i = 0; i < n; ++i)
+    {
+        GVariant *child = g_variant_get_child_value(variant, i);
+        hash = combine(hash, structuralHash(child));
+        g_variant_unref(child);
+    }
+    return hash;
+}
+
+bool
+Variant::structuralEqual(GVariant *a, GVariant *b)
+{
+    if (a == b)
+    {
+        return true;
+    }
+
+    if (!g_variant_type_equal(g_variant_get_type(a), g_variant_get_type(b)))
+    {
+        return false;
+    }
+
+    if (!g_variant_is_container(a) || isBasicArray(a))
+    {
+        return g_variant_equal(a, b);
+    }
+
+    gsize n = g_variant_n_children(a);
+    if (n != g_variant_n_children(b))
+    {
+        return false;
+    }
+
+    for (gsize i = 0; i < n; ++i)
+    {
+        GVariant *childA = g_variant_get_child_value(a, i);
+        GVariant *childB = g_variant_get_child_value(b, i);
+        bool equal = structuralEqual(childA, childB);
+        g_variant_unref(childA);
+        g_variant_unref(childB);
+        if (!equal)
+        {
+            return false;
+        }
+    }
+    return true;
+}
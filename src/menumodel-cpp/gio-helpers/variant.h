@@ -63,16 +63,22 @@ public:
     inline Variant& operator=(Variant&& rhs)
     {
         m_variant = std::move(rhs.m_variant);
+        m_hash = rhs.m_hash;
+        m_hashed = rhs.m_hashed;
         return *this;
     }
 
     inline Variant(Variant&& rhs)
-        : m_variant(std::move(rhs.m_variant))
+        : m_variant(std::move(rhs.m_variant)),
+          m_hash(rhs.m_hash),
+          m_hashed(rhs.m_hashed)
     {}
 
     inline Variant& operator=(const Variant& rhs)
     {
         m_variant = rhs.m_variant;
+        m_hash = rhs.m_hash;
+        m_hashed = rhs.m_hashed;
         return *this;
     }
 
@@ -86,30 +92,39 @@ public:
         return value;
     }
 
-    bool operator==(const Variant &rhs) const
+    /**
+     * Structural hash of the value. GVariants are immutable, so it is
+     * computed on first use and carried along by later copies.
+     */
+    guint hash() const
     {
-        if (!m_variant && !rhs.m_variant)
+        if (!m_hashed)
         {
-            return true;
+            m_hash = m_variant ? structuralHash(m_variant.get()) : 0;
+            m_hashed = true;
         }
+        return m_hash;
+    }
 
-        if (!m_variant && rhs.m_variant)
+    bool operator==(const Variant &rhs) const
+    {
+        // also covers both being null
+        if (m_variant == rhs.m_variant)
         {
-            return false;
+            return true;
         }
 
-        if (m_variant && !rhs.m_variant)
+        if (!m_variant || !rhs.m_variant)
         {
             return false;
         }
 
-        if (g_variant_is_container(m_variant.get()) || g_variant_is_container(rhs.m_variant.get()))
+        if (hash() != rhs.hash())
         {
-            // Compare by string
-            return to_string(true) == rhs.to_string(true);
+            return false;
         }
 
-        return g_variant_compare(m_variant.get(), rhs.m_variant.get()) == 0;
+        return structuralEqual(m_variant.get(), rhs.m_variant.get());
     }
 
     bool operator!=(const Variant &rhs) const
@@ -137,7 +152,14 @@ protected:
         m_variant = make_gvariant_ptr(variant);
     }
 
+    static guint structuralHash(GVariant *variant);
+
+    static bool structuralEqual(GVariant *a, GVariant *b);
+
     GVariantPtr m_variant;
+
+    mutable guint m_hash = 0;
+    mutable bool m_hashed = false;
 };
 
 template<typename T>
@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#include "icon-cache.h"
+
+#include <map>
+
+#include <QDebug>
+
+using namespace std;
+
+const IconCache::Entry&
+IconCache::get(const QString& name)
+{
+    // std::map never moves its nodes, so references handed out stay valid
+    static map<QString, Entry> entries;
+
+    auto iter = entries.find(name);
+    if (iter != entries.end())
+    {
+        return iter->second;
+    }
+
+    Entry entry;
+    entry.name = name;
+
+    if (!name.isEmpty())
+    {
+        GError *error = nullptr;
+        auto gicon = shared_ptr<GIcon>(g_icon_new_for_string(name.toUtf8().constData(), &error), GObjectDeleter());
+        if (error)
+        {
+            qWarning() << "Could not create GIcon:" << error->message;
+            g_error_free(error);
+        }
+        else
+        {
+            entry.icon = Variant::fromGVariant(g_icon_serialize(gicon.get()));
+        }
+    }
+
+    return entries.emplace(name, entry).first->second;
+}
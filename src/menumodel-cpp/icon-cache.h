@@ -0,0 +1,52 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include "gio-helpers/variant.h"
+
+#include <QString>
+
+/**
+ * Process-wide interned table of serialized GIcons, keyed by icon name.
+ *
+ * The indicator only ever shows a small, fixed vocabulary of icons, so
+ * entries are created on first use and never evicted. Looking up an
+ * existing entry does not allocate when the name is a QStringLiteral.
+ * Like the rest of menumodel-cpp, this must only be used from the main
+ * thread.
+ */
+class IconCache
+{
+public:
+    struct Entry
+    {
+        QString name;
+
+        // the serialized GIcon, null if name is empty or not a valid icon
+        Variant icon;
+    };
+
+    IconCache() = delete;
+
+    ~IconCache() = delete;
+
+    /// entries are never removed, so the reference stays valid
+    static const Entry& get(const QString& name);
+};
@@ -18,6 +18,7 @@
  */
 
 #include "menu-item.h"
+#include "icon-cache.h"
 #include <QDebug>
 
 using namespace std;
@@ -68,7 +69,7 @@ void MenuItem::setLabel(const QString &value)
         return;
     m_label = value;
     g_menu_item_set_label(m_gmenuitem.get(), m_label.toUtf8().constData());
-    Q_EMIT changed();
+    notifyChanged();
 }
 
 void MenuItem::setIcon(const QString &icon)
@@ -79,17 +80,15 @@ void MenuItem::setIcon(const QString &icon)
     }
     m_icon = icon;
 
-    GError *error = nullptr;
-    auto gicon = shared_ptr<GIcon>(g_icon_new_for_string(m_icon.toUtf8().constData(), &error), GObjectDeleter());
-    if (error)
+    // the same attribute g_menu_item_set_icon() would set, without the GIcon round trip
+    const auto& entry = IconCache::get(m_icon);
+    if (!entry.icon)
     {
-        qWarning() << error->message;
-        g_error_free(error);
         return;
     }
 
-    g_menu_item_set_icon(m_gmenuitem.get(), gicon.get());
-    Q_EMIT changed();
+    g_menu_item_set_attribute_value(m_gmenuitem.get(), G_MENU_ATTRIBUTE_ICON, entry.icon);
+    notifyChanged();
 }
 
 void MenuItem::setAction(const QString &value)
@@ -99,7 +98,7 @@ void MenuItem::setAction(const QString &value)
         return;
     m_action = value;
     g_menu_item_set_detailed_action(m_gmenuitem.get(), m_action.toUtf8().constData());
-    Q_EMIT changed();
+    notifyChanged();
 }
 
 void MenuItem::setActionAndTargetValue(const QString &action, const Variant& target)
@@ -111,7 +110,7 @@ void MenuItem::setActionAndTargetValue(const QString &action, const Variant& tar
 
     m_action = action;
     g_menu_item_set_action_and_target_value(m_gmenuitem.get(), m_action.toUtf8().constData(), target);
-    Q_EMIT changed();
+    notifyChanged();
 }
 
 void MenuItem::setAttribute(const QString &attribute,
@@ -130,7 +129,7 @@ void MenuItem::setAttribute(const QString &attribute,
         m_attributes[attribute] = value;
     }
     g_menu_item_set_attribute_value(m_gmenuitem.get(), attribute.toUtf8().constData(), value);
-    Q_EMIT changed();
+    notifyChanged();
 }
 
 void MenuItem::clearAttribute(const QString &attribute)
@@ -138,6 +137,29 @@ void MenuItem::clearAttribute(const QString &attribute)
     assert(!attribute.isEmpty());
     m_attributes.erase(attribute);
     g_menu_item_set_attribute(m_gmenuitem.get(), attribute.toUtf8().constData(), nullptr);
+    notifyChanged();
+}
+
+void MenuItem::beginTransaction()
+{
+    ++m_transactionDepth;
+}
+
+void MenuItem::commitTransaction()
+{
+    assert(m_transactionDepth > 0);
+    if (--m_transactionDepth > 0 || !m_changedInTransaction)
+        return;
+    m_changedInTransaction = false;
+    Q_EMIT changed();
+}
+
+void MenuItem::notifyChanged()
+{
+    if (m_transactionDepth > 0) {
+        m_changedInTransaction = true;
+        return;
+    }
     Q_EMIT changed();
 }
 
@@ -43,6 +43,11 @@ class MenuItem: public QObject
 
     std::map<QString, Variant> m_attributes;
 
+    unsigned int m_transactionDepth = 0;
+    bool m_changedInTransaction = false;
+
+    void notifyChanged();
+
 public:
     typedef std::shared_ptr<MenuItem> Ptr;
 
@@ -67,6 +72,14 @@ public:
 
     const QString& action () const;
 
+    /**
+     * Collapse every edit made until the matching commitTransaction() into
+     * a single changed() emission. Transactions nest.
+     */
+    void beginTransaction();
+
+    void commitTransaction();
+
 public Q_SLOTS:
     void setLabel(const QString &value);
 
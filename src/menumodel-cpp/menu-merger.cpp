@@ -0,0 +1,340 @@
+/*
+ * Copyright © 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Antti Kaijanmäki <antti.kaijanmaki@canonical.com>
+ */
+
+#include "menu-merger.h"
+
+#include <cassert>
+
+namespace
+{
+
+struct MergedMenuModel
+{
+    GMenuModel parent_instance;
+
+    // cleared when the owning MenuMerger is destroyed
+    MenuMerger* merger;
+};
+
+struct MergedMenuModelClass
+{
+    GMenuModelClass parent_class;
+};
+
+GType merged_menu_model_get_type();
+
+G_DEFINE_TYPE(MergedMenuModel, merged_menu_model, G_TYPE_MENU_MODEL)
+
+#define MERGED_MENU_MODEL(inst) (G_TYPE_CHECK_INSTANCE_CAST((inst), merged_menu_model_get_type(), MergedMenuModel))
+
+gboolean
+merged_menu_model_is_mutable(GMenuModel*)
+{
+    return TRUE;
+}
+
+gint
+merged_menu_model_get_n_items(GMenuModel* model)
+{
+    auto merger = MERGED_MENU_MODEL(model)->merger;
+    return merger ? merger->size() : 0;
+}
+
+void
+merged_menu_model_get_item_attributes(GMenuModel* model, gint position, GHashTable** table)
+{
+    auto merger = MERGED_MENU_MODEL(model)->merger;
+    GMenuModel* owner;
+    int index;
+    if (!merger || !merger->locate(position, owner, index))
+    {
+        *table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+        return;
+    }
+    G_MENU_MODEL_GET_CLASS(owner)->get_item_attributes(owner, index, table);
+}
+
+void
+merged_menu_model_get_item_links(GMenuModel* model, gint position, GHashTable** table)
+{
+    auto merger = MERGED_MENU_MODEL(model)->merger;
+    GMenuModel* owner;
+    int index;
+    if (!merger || !merger->locate(position, owner, index))
+    {
+        *table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+        return;
+    }
+    G_MENU_MODEL_GET_CLASS(owner)->get_item_links(owner, index, table);
+}
+
+void
+merged_menu_model_init(MergedMenuModel* self)
+{
+    self->merger = nullptr;
+}
+
+void
+merged_menu_model_class_init(MergedMenuModelClass* klass)
+{
+    GMenuModelClass* model_class = G_MENU_MODEL_CLASS(klass);
+
+    model_class->is_mutable = merged_menu_model_is_mutable;
+    model_class->get_n_items = merged_menu_model_get_n_items;
+    model_class->get_item_attributes = merged_menu_model_get_item_attributes;
+    model_class->get_item_links = merged_menu_model_get_item_links;
+}
+
+inline std::size_t
+lowBit(std::size_t i)
+{
+    return i & (~i + 1);
+}
+
+}
+
+MenuMerger::MenuMerger()
+    : m_offsets(1, 0)
+{
+    auto merged = MERGED_MENU_MODEL(g_object_new(merged_menu_model_get_type(), nullptr));
+    merged->merger = this;
+    m_merged.reset(G_MENU_MODEL(merged), GObjectDeleter());
+    m_model.reset(buffered_menu_model_new(m_merged.get()), GObjectDeleter());
+}
+
+MenuMerger::~MenuMerger()
+{
+    clear();
+    // the merged model may be referenced by an exporter for a while longer
+    MERGED_MENU_MODEL(m_merged.get())->merger = nullptr;
+}
+
+void
+MenuMerger::items_changed_cb(GMenuModel *model,
+                             gint        position,
+                             gint        removed,
+                             gint        added,
+                             gpointer    user_data)
+{
+    MenuMerger *that = static_cast<MenuMerger*>(user_data);
+    that->itemsChanged(model, position, removed, added);
+}
+
+void
+MenuMerger::itemsChanged(GMenuModel *model,
+                         gint        position,
+                         gint        removed,
+                         gint        added)
+{
+    auto iter = m_childIndex.find(model);
+    if (iter == m_childIndex.end())
+    {
+        return;
+    }
+    auto child = iter->second;
+
+    int offset = startPosition(child) + position;
+    int delta = added - removed;
+    m_children[child].size += delta;
+    addToSize(child, delta);
+    m_size += delta;
+
+    g_menu_model_items_changed(m_merged.get(), offset, removed, added);
+}
+
+int
+MenuMerger::startPosition(std::size_t child) const
+{
+    int position = 0;
+    for (auto i = child; i > 0; i -= lowBit(i))
+    {
+        position += m_offsets[i];
+    }
+    return position;
+}
+
+void
+MenuMerger::addToSize(std::size_t child, int delta)
+{
+    for (auto i = child + 1; i < m_offsets.size(); i += lowBit(i))
+    {
+        m_offsets[i] += delta;
+    }
+}
+
+std::size_t
+MenuMerger::findChild(int position, int& index) const
+{
+    // descend the tree, skipping every subtree that ends at or before position
+    std::size_t n = m_children.size();
+    std::size_t step = 1;
+    while (step * 2 <= n)
+    {
+        step *= 2;
+    }
+
+    std::size_t child = 0;
+    for (; step > 0; step /= 2)
+    {
+        if (child + step <= n && m_offsets[child + step] <= position)
+        {
+            child += step;
+            position -= m_offsets[child];
+        }
+    }
+
+    index = position;
+    return child;
+}
+
+void
+MenuMerger::rebuildIndex()
+{
+    m_offsets.assign(m_children.size() + 1, 0);
+    m_childIndex.clear();
+    for (std::size_t i = 1; i < m_offsets.size(); ++i)
+    {
+        m_childIndex[m_children[i - 1].model] = i - 1;
+        m_offsets[i] += m_children[i - 1].size;
+        auto parent = i + lowBit(i);
+        if (parent < m_offsets.size())
+        {
+            m_offsets[parent] += m_offsets[i];
+        }
+    }
+}
+
+void
+MenuMerger::append(MenuModel::Ptr menu)
+{
+    GMenuModel* model = *menu;
+    /// @todo support adding the same menu more than once
+    assert(m_childIndex.find(model) == m_childIndex.end());
+
+    Child child;
+    child.menu = menu;
+    child.model = model;
+    child.merger = dynamic_cast<MenuMerger*>(menu.get());
+    child.size = g_menu_model_get_n_items(model);
+    child.handler = g_signal_connect(model,
+                                     "items-changed",
+                                     G_CALLBACK(MenuMerger::items_changed_cb),
+                                     this);
+
+    m_childIndex[model] = m_children.size();
+    m_children.push_back(child);
+
+    // a node covers the range (i - lowBit(i), i], made up of this child
+    // plus the nodes directly below it
+    auto i = m_children.size();
+    int size = child.size;
+    for (std::size_t j = 1; j < lowBit(i); j *= 2)
+    {
+        size += m_offsets[i - j];
+    }
+    m_offsets.push_back(size);
+
+    int start = m_size;
+    m_size += child.size;
+    if (child.size > 0)
+    {
+        g_menu_model_items_changed(m_merged.get(), start, 0, child.size);
+    }
+}
+
+void
+MenuMerger::remove(MenuModel::Ptr menu)
+{
+    auto iter = m_childIndex.find(*menu);
+    assert(iter != m_childIndex.end());
+    auto index = iter->second;
+
+    auto& child = m_children[index];
+    g_signal_handler_disconnect(child.model, child.handler);
+
+    int start = startPosition(index);
+    int size = child.size;
+
+    // removing children is rare compared to item changes, so just rebuild
+    m_children.erase(m_children.begin() + index);
+    rebuildIndex();
+    m_size -= size;
+
+    if (size > 0)
+    {
+        g_menu_model_items_changed(m_merged.get(), start, size, 0);
+    }
+}
+
+void
+MenuMerger::clear()
+{
+    for (auto& child : m_children)
+    {
+        g_signal_handler_disconnect(child.model, child.handler);
+    }
+
+    int size = m_size;
+    m_children.clear();
+    rebuildIndex();
+    m_size = 0;
+
+    if (size > 0)
+    {
+        g_menu_model_items_changed(m_merged.get(), 0, size, 0);
+    }
+}
+
+int
+MenuMerger::size() const
+{
+    return m_size;
+}
+
+bool
+MenuMerger::locate(int position, GMenuModel*& model, int& index) const
+{
+    if (position < 0 || position >= m_size)
+    {
+        return false;
+    }
+
+    int local;
+    auto& child = m_children[findChild(position, local)];
+    if (child.merger)
+    {
+        return child.merger->locate(local, model, index);
+    }
+
+    model = child.model;
+    index = local;
+    return true;
+}
+
+void
+MenuMerger::beginTransaction()
+{
+    buffered_menu_model_freeze(m_model.get());
+}
+
+void
+MenuMerger::commitTransaction()
+{
+    buffered_menu_model_thaw(m_model.get());
+}
@@ -19,126 +19,97 @@
 
 #pragma once
 
-#include <algorithm>
 #include <memory>
+#include <unordered_map>
 #include <vector>
-#include <map>
 
 #include <gio/gio.h>
 
+#include "gio-helpers/buffered-menu-model.h"
 #include "gio-helpers/util.h"
 #include "menu-model.h"
 #include "menu.h"
 
+/**
+ * Concatenates the items of several menu models.
+ *
+ * Items are not copied; the merged model resolves every position to the
+ * child that owns it using a Fenwick tree over the child sizes, so both
+ * forwarding a change and looking up an item are O(log n) in the number of
+ * children. Nested mergers are flattened on lookup: a position is resolved
+ * straight down to the leaf model instead of through each intermediate
+ * GMenuModel.
+ */
 class MenuMerger : public MenuModel
 {
-    GMenuPtr m_gmenu;
-    std::vector<MenuModel::Ptr> m_menus;
+    struct Child
+    {
+        MenuModel::Ptr menu;
+        GMenuModel* model;
+        // non-null when the child is itself a merger
+        MenuMerger* merger;
+        gulong handler;
+        int size;
+    };
+
+    std::vector<Child> m_children;
+
+    // 1-based Fenwick tree over the child sizes, m_offsets[0] is unused
+    std::vector<int> m_offsets;
+
+    std::unordered_map<GMenuModel*, std::size_t> m_childIndex;
 
-    std::map<GMenuModel*, MenuModel::Ptr> m_gmodelToMenu;
-    std::map<GMenuModel*, int> m_startPositions;
-    std::map<GMenuModel*, gulong> m_handlerId;
+    int m_size = 0;
+
+    std::shared_ptr<GMenuModel> m_merged;
+
+    std::shared_ptr<BufferedMenuModel> m_model;
 
     static void items_changed_cb(GMenuModel *model,
                                  gint        position,
                                  gint        removed,
                                  gint        added,
-                                 gpointer    user_data)
-    {
-        MenuMerger *that = static_cast<MenuMerger*>(user_data);
-        that->itemsChanged(model, position, removed, added);
-    }
+                                 gpointer    user_data);
 
     void itemsChanged(GMenuModel *model,
                       gint        position,
                       gint        removed,
-                      gint        added)
-    {
-        int offset = m_startPositions[model] + position;
-
-        for (int i = 0; i < removed; ++i) {
-            g_menu_remove(m_gmenu.get(), offset);
-        }
-        for (int i = added-1; i >= 0; --i) {
-            auto item = g_menu_item_new_from_model(model, position + i);
-            g_menu_insert_item(m_gmenu.get(), offset, item);
-            g_object_unref(item);
-        }
-
-        int delta = added - removed;
-        bool update = false;
-        for (auto iter : m_menus) {
-            if (update) {
-                m_startPositions[*iter] += delta;
-                continue;
-            }
-            if (m_gmodelToMenu[model] == iter) {
-                // the remaining positions need updating
-                update = true;
-                continue;
-            }
-        }
-    }
+                      gint        added);
+
+    int startPosition(std::size_t child) const;
+
+    void addToSize(std::size_t child, int delta);
+
+    std::size_t findChild(int position, int& index) const;
+
+    void rebuildIndex();
 
 public:
     typedef std::shared_ptr<MenuMerger> Ptr;
 
-    MenuMerger()
-    {
-        m_gmenu = make_gmenu_ptr();
-    }
+    MenuMerger();
 
-    ~MenuMerger()
-    {
-        clear();
-//        GMainLoopSync([]{});
-    }
+    ~MenuMerger();
 
-    void append(MenuModel::Ptr menu)
-    {
-        // calculate the start position for the items for the new menu
-        int start_position;
-        if (m_menus.empty()) {
-            start_position = 0;
-        } else {
-            start_position = m_startPositions[*m_menus.back()];
-            start_position += g_menu_model_get_n_items(*m_menus.back());
-        }
-
-        m_menus.push_back(menu);
-        m_gmodelToMenu[*menu] = menu;
-        m_startPositions[*menu] = start_position;
-
-        // add all items
-        itemsChanged(*menu, 0, 0, g_menu_model_get_n_items(*menu));
-        m_handlerId[*menu] = g_signal_connect(menu->operator GMenuModel *(),
-                                              "items-changed",
-                                              G_CALLBACK(MenuMerger::items_changed_cb),
-                                              this);
-    }
-
-    void remove(MenuModel::Ptr menu)
-    {
-        /// @todo menu might have been added multiple times
-        assert(std::find(m_menus.begin(), m_menus.end(), menu) != m_menus.end());
+    void append(MenuModel::Ptr menu);
 
-        g_signal_handler_disconnect(menu->operator GMenuModel *(), m_handlerId[*menu]);
-        m_handlerId.erase(*menu);
+    void remove(MenuModel::Ptr menu);
 
-        // remove all items
-        itemsChanged(*menu, 0, g_menu_model_get_n_items(*menu), 0);
+    void clear();
 
-        m_startPositions.erase(*menu);
-        m_gmodelToMenu.erase(*menu);
-        m_menus.erase(std::remove(m_menus.begin(), m_menus.end(), menu), m_menus.end());
-    }
+    // number of items in the merged model
+    int size() const;
 
-    void clear()
-    {
-        std::vector<MenuModel::Ptr> tmp = m_menus;
-        for (auto menu : tmp)
-            remove(menu);
-    }
+    /**
+     * Find the leaf (non-merger) model and index holding the item at
+     * position. Returns false if position is out of range.
+     */
+    bool locate(int position, GMenuModel*& model, int& index) const;
+
+    // merges every change made until commitTransaction() into one items-changed
+    void beginTransaction() override;
+
+    void commitTransaction() override;
 
-    operator GMenuModel*() { return G_MENU_MODEL(m_gmenu.get()); }
+    operator GMenuModel*() { return G_MENU_MODEL(m_model.get()); }
 };
@@ -29,4 +29,32 @@ public:
 
     virtual operator GMenuModel*() = 0;
     virtual ~MenuModel() {}
+
+    virtual void beginTransaction() = 0;
+    virtual void commitTransaction() = 0;
+};
+
+/**
+ * Holds a transaction open on a Menu, MenuMerger or MenuItem for the
+ * lifetime of the guard, so early returns cannot leave it uncommitted.
+ */
+template<typename T>
+class ScopedTransaction
+{
+    T& m_target;
+
+public:
+    explicit ScopedTransaction(T& target)
+        : m_target(target)
+    {
+        m_target.beginTransaction();
+    }
+
+    ~ScopedTransaction()
+    {
+        m_target.commitTransaction();
+    }
+
+    ScopedTransaction(const ScopedTransaction&) = delete;
+    ScopedTransaction& operator=(const ScopedTransaction&) = delete;
 };
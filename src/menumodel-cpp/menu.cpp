@@ -21,7 +21,6 @@
 
 Menu::Menu()
 {
-    m_gmenu = make_gmenu_ptr();
 }
 
 Menu::~Menu()
@@ -51,6 +50,9 @@ void Menu::insert(MenuItem::Ptr item, iterator position)
 
     g_menu_insert_item(m_gmenu.get(), index, item->gmenuitem());
     m_items.insert(position, item);
+    if (std::count(m_items.begin(), m_items.end(), item) == 1) {
+        connect(item.get(), &MenuItem::changed, this, &Menu::itemChanged);
+    }
 }
 
 /* Binary function that accepts two elements in the range as arguments,
@@ -160,10 +162,8 @@ void Menu::clear()
     m_items.clear();
 }
 
-void Menu::itemChanged()
+void Menu::refreshItem(MenuItem* item)
 {
-    auto item = qobject_cast<MenuItem*>(sender());
-
     int index = 0;
     for (auto iter = m_items.begin(); iter != m_items.end(); ++iter) {
         if (iter->get() == item) {
@@ -23,21 +23,22 @@
 #include <list>
 #include <vector>
 #include <map>
+#include <set>
 #include <algorithm>
 
 #include <gio/gio.h>
 
-#include "gio-helpers/util.h"
-#include "menu-model.h"
-#include "menu-item.h"
+#include "buffered-menu.h"
 
-class Menu : public MenuModel
+class Menu : public BufferedMenu
 {
     Q_OBJECT
 
-    GMenuPtr m_gmenu;
     std::list<MenuItem::Ptr> m_items;
 
+protected:
+    void refreshItem(MenuItem* item) override;
+
 public:
     typedef std::shared_ptr<Menu> Ptr;
     typedef std::list<MenuItem::Ptr>::iterator iterator;
@@ -83,9 +84,4 @@ public:
 
     // clear the whole menu
     void clear();
-
-    operator GMenuModel*() { return G_MENU_MODEL(m_gmenu.get()); }
-
-private Q_SLOTS:
-    void itemChanged();
 };
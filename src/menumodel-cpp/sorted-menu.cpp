@@ -0,0 +1,143 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#include "sorted-menu.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace
+{
+
+struct EntryKeyLess
+{
+    template<typename A, typename B>
+    bool operator()(const A& a, const B& b) const
+    {
+        return key(a) < key(b);
+    }
+
+    static const QString& key(const QString& key)
+    {
+        return key;
+    }
+
+    template<typename T>
+    static const QString& key(const T& entry)
+    {
+        return entry.key;
+    }
+};
+
+}
+
+SortedMenu::SortedMenu()
+{
+}
+
+SortedMenu::~SortedMenu()
+{
+    clear();
+}
+
+int SortedMenu::indexOf(MenuItem* item) const
+{
+    auto key = m_keys.find(item);
+    if (key == m_keys.end())
+    {
+        return -1;
+    }
+
+    // only the items sharing the key need to be compared
+    auto range = equal_range(m_entries.begin(), m_entries.end(), key->second, EntryKeyLess());
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (iter->item.get() == item)
+        {
+            return iter - m_entries.begin();
+        }
+    }
+
+    assert(false);
+    return -1;
+}
+
+void SortedMenu::insert(MenuItem::Ptr item, const QString& key)
+{
+    if (!m_keys.emplace(item.get(), key).second)
+    {
+        return;
+    }
+
+    auto position = upper_bound(m_entries.begin(), m_entries.end(), key, EntryKeyLess());
+    int index = position - m_entries.begin();
+    m_entries.insert(position, Entry{key, item});
+    g_menu_insert_item(m_gmenu.get(), index, item->gmenuitem());
+
+    connect(item.get(), &MenuItem::changed, this, &SortedMenu::itemChanged);
+}
+
+void SortedMenu::remove(MenuItem::Ptr item)
+{
+    int index = indexOf(item.get());
+    if (index < 0)
+    {
+        return;
+    }
+
+    disconnect(item.get(), &MenuItem::changed, this, &SortedMenu::itemChanged);
+    m_keys.erase(item.get());
+    m_entries.erase(m_entries.begin() + index);
+    g_menu_remove(m_gmenu.get(), index);
+}
+
+bool SortedMenu::contains(MenuItem::Ptr item) const
+{
+    return m_keys.find(item.get()) != m_keys.end();
+}
+
+size_t SortedMenu::size() const
+{
+    return m_entries.size();
+}
+
+void SortedMenu::clear()
+{
+    for (const auto& entry : m_entries)
+    {
+        disconnect(entry.item.get(), &MenuItem::changed, this, &SortedMenu::itemChanged);
+    }
+    m_entries.clear();
+    m_keys.clear();
+    g_menu_remove_all(m_gmenu.get());
+}
+
+void SortedMenu::refreshItem(MenuItem* item)
+{
+    int index = indexOf(item);
+    if (index < 0)
+    {
+        return;
+    }
+
+    g_menu_remove(m_gmenu.get(), index);
+    g_menu_insert_item(m_gmenu.get(), index, item->gmenuitem());
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <gio/gio.h>
+
+#include "buffered-menu.h"
+
+/**
+ * A menu that keeps its items ordered by a sort key supplied on insertion.
+ *
+ * Keys are computed once by the caller and cached, and the items are held
+ * in an array that matches the GMenu positions one to one, so insertion,
+ * removal and change notification are a binary search away from the
+ * GMenu index.
+ */
+class SortedMenu : public BufferedMenu
+{
+    Q_OBJECT
+
+    struct Entry
+    {
+        QString key;
+        MenuItem::Ptr item;
+    };
+
+    std::vector<Entry> m_entries;
+    std::unordered_map<MenuItem*, QString> m_keys;
+
+    int indexOf(MenuItem* item) const;
+
+protected:
+    void refreshItem(MenuItem* item) override;
+
+public:
+    typedef std::shared_ptr<SortedMenu> Ptr;
+
+    SortedMenu();
+
+    virtual ~SortedMenu();
+
+    /// inserts item after any items with an equal key, items already present are ignored
+    void insert(MenuItem::Ptr item, const QString& key);
+
+    void remove(MenuItem::Ptr item);
+
+    bool contains(MenuItem::Ptr item) const;
+
+    std::size_t size() const;
+
+    void clear();
+};
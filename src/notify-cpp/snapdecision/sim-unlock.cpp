@@ -64,8 +64,31 @@ public:
     std::function<void()> m_pendingErrorClosed;
     std::function<void()> m_pendingPopupClosed;
 
+    bool m_showWhenExported = false;
+
 public Q_SLOTS:
 
+    void showNotification()
+    {
+        // The snap decision refers to our actions, so it has to wait
+        // until they are on the bus
+        if (!m_actionGroupExporter->isExported())
+        {
+            m_showWhenExported = true;
+            return;
+        }
+        m_notification->show();
+    }
+
+    void actionGroupExported()
+    {
+        if (m_showWhenExported)
+        {
+            m_showWhenExported = false;
+            m_notification->show();
+        }
+    }
+
     void resetActionStates()
     {
         m_popupAction->setState(TypedVariant<std::string>(""));
@@ -217,6 +240,7 @@ public:
 
         m_menuExporter = std::make_shared<MenuExporter>(m_sessionBus, menuPath, m_menu);
         m_actionGroupExporter = std::make_shared<ActionGroupExporter>(m_sessionBus, m_actionGroup, actionPath);
+        connect(m_actionGroupExporter.get(), &ActionGroupExporter::exported, this, &Private::actionGroupExported);
 
         resetNotification();
 
@@ -257,18 +281,19 @@ SimUnlock::pinMinMax()
 void
 SimUnlock::update()
 {
-    d->m_notification->show();
+    d->showNotification();
 }
 
 void
 SimUnlock::show()
 {
-    d->m_notification->show();
+    d->showNotification();
 }
 
 void
 SimUnlock::close()
 {
+    d->m_showWhenExported = false;
     d->resetActionStates();
     d->m_notification->close();
 }
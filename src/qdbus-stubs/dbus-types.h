@@ -19,6 +19,7 @@
 #pragma once
 
 #include <QDBusMetaType>
+#include <QDBusObjectPath>
 #include <QtCore>
 #include <QString>
 #include <QVariantMap>
@@ -29,15 +30,20 @@ Q_DECLARE_METATYPE(QVariantDictMap)
 typedef QMap<QString, QString> QStringMap;
 Q_DECLARE_METATYPE(QStringMap)
 
+typedef QMap<QDBusObjectPath, QVariantDictMap> QObjectPathVariantDictMap;
+Q_DECLARE_METATYPE(QObjectPathVariantDictMap)
+
 namespace DBusTypes
 {
     inline void registerMetaTypes()
     {
         qRegisterMetaType<QVariantDictMap>("QVariantDictMap");
         qRegisterMetaType<QStringMap>("QStringMap");
+        qRegisterMetaType<QObjectPathVariantDictMap>("QObjectPathVariantDictMap");
 
         qDBusRegisterMetaType<QVariantDictMap>();
         qDBusRegisterMetaType<QStringMap>();
+        qDBusRegisterMetaType<QObjectPathVariantDictMap>();
     }
 
     inline QString vpnConnectionPath()
@@ -21,11 +21,26 @@
 
 #include <PropertiesInterface.h>
 
+#include <QDBusConnectionInterface>
+#include <QDBusPendingCallWatcher>
+#include <QDebug>
+#include <QSet>
+#include <QTimer>
+
 using namespace std;
 
 namespace util
 {
 
+namespace
+{
+
+// Backoff between attempts at the initial GetAll
+static const int FETCH_RETRY_MIN_MS = 1000;
+static const int FETCH_RETRY_MAX_MS = 30000;
+
+}
+
 class DBusPropertyCache::Priv: public QObject
 {
     Q_OBJECT
@@ -34,6 +49,8 @@ public:
     Priv(DBusPropertyCache& parent, const QDBusConnection& connection) :
         p(parent), m_connection(connection)
     {
+        m_retryTimer.setSingleShot(true);
+        connect(&m_retryTimer, &QTimer::timeout, this, &Priv::fetchAll);
     }
 
     DBusPropertyCache& p;
@@ -52,23 +69,159 @@ public:
 
     QVariantMap m_propertyCache;
 
-    void refreshProperties(const QStringList& names)
+    bool m_initialized = false;
+
+    bool m_fetchInFlight = false;
+
+    QTimer m_retryTimer;
+
+    int m_retryMs = FETCH_RETRY_MIN_MS;
+
+    // Bumped on every owner change so replies for a previous owner are dropped
+    quint64 m_generation = 0;
+
+    QSet<QString> m_invalidated;
+
+    QSet<QString> m_refreshing;
+
+    bool m_refreshInFlight = false;
+
+    void fetchServiceOwner()
     {
-        for(const QString& name: names)
+        auto generation = m_generation;
+        QDBusPendingCall call = m_connection.interface()->asyncCall(
+                QStringLiteral("GetNameOwner"), m_service);
+        auto watcher(new QDBusPendingCallWatcher(call, this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [this, generation](QDBusPendingCallWatcher* call)
         {
-            QDBusVariant v = m_propertiesInterface->Get(m_interface, name);
-            QVariant variant = v.variant();
-            m_propertyCache[name] = variant;
-            Q_EMIT p.propertyChanged(name, variant);
+            call->deleteLater();
+            QDBusPendingReply<QString> reply = *call;
+            // Not being registered yet is expected; the service watcher
+            // will tell us when it appears.
+            if (reply.isError() || generation != m_generation)
+            {
+                return;
+            }
+            serviceOwnerChanged(m_service, "", reply.value());
+        });
+    }
+
+    void fetchAll()
+    {
+        if (!m_propertiesInterface || m_fetchInFlight)
+        {
+            return;
         }
+
+        m_retryTimer.stop();
+        m_fetchInFlight = true;
+
+        auto generation = m_generation;
+        auto watcher(new QDBusPendingCallWatcher(m_propertiesInterface->GetAll(m_interface), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [this, generation](QDBusPendingCallWatcher* call)
+        {
+            call->deleteLater();
+            if (generation == m_generation)
+            {
+                m_fetchInFlight = false;
+                propertiesFetched(*call);
+            }
+        });
+    }
+
+    void propertiesFetched(const QDBusPendingReply<QVariantMap>& reply)
+    {
+        if (reply.isError())
+        {
+            qWarning() << __PRETTY_FUNCTION__ << m_service << m_path
+                    << reply.error().message();
+            // Changes are dropped until we have a baseline, so keep trying
+            m_retryTimer.start(m_retryMs);
+            m_retryMs = min(m_retryMs * 2, FETCH_RETRY_MAX_MS);
+            return;
+        }
+
+        m_retryMs = FETCH_RETRY_MIN_MS;
+        m_propertyCache = reply;
+        QMapIterator<QString, QVariant> it(m_propertyCache);
+        while (it.hasNext())
+        {
+            it.next();
+            Q_EMIT p.propertyChanged(it.key(), it.value());
+        }
+
+        m_initialized = true;
+        Q_EMIT p.initialized();
+    }
+
+    void refreshProperties()
+    {
+        if (m_refreshInFlight || m_invalidated.isEmpty())
+        {
+            return;
+        }
+
+        m_refreshing = m_invalidated;
+        m_invalidated.clear();
+        m_refreshInFlight = true;
+
+        auto generation = m_generation;
+        auto watcher(new QDBusPendingCallWatcher(m_propertiesInterface->GetAll(m_interface), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                [this, generation](QDBusPendingCallWatcher* call)
+        {
+            call->deleteLater();
+            if (generation == m_generation)
+            {
+                propertiesRefreshed(*call);
+            }
+        });
+    }
+
+    void propertiesRefreshed(const QDBusPendingReply<QVariantMap>& reply)
+    {
+        m_refreshInFlight = false;
+
+        if (reply.isError())
+        {
+            qWarning() << __PRETTY_FUNCTION__ << m_service << m_path
+                    << reply.error().message();
+        }
+        else
+        {
+            QVariantMap properties = reply;
+            for (const auto& name: m_refreshing)
+            {
+                auto value = properties.value(name);
+                if (!m_propertyCache.contains(name) || m_propertyCache[name] != value)
+                {
+                    m_propertyCache[name] = value;
+                    Q_EMIT p.propertyChanged(name, value);
+                }
+            }
+        }
+        m_refreshing.clear();
+
+        // Anything invalidated while the call was in flight
+        refreshProperties();
     }
 
 public Q_SLOTS:
     void serviceOwnerChanged(const QString &, const QString &,
                         const QString & newOwner)
     {
+        ++m_generation;
         m_propertiesInterface.reset();
         m_propertyCache.clear();
+        m_initialized = false;
+        m_fetchInFlight = false;
+        m_retryTimer.stop();
+        m_retryMs = FETCH_RETRY_MIN_MS;
+        m_invalidated.clear();
+        m_refreshing.clear();
+        m_refreshInFlight = false;
 
         if (newOwner.isEmpty())
         {
@@ -83,25 +236,27 @@ public Q_SLOTS:
                 &OrgFreedesktopDBusPropertiesInterface::PropertiesChanged, this,
                 &Priv::propertiesChanged);
 
-        m_propertyCache = m_propertiesInterface->GetAll(m_interface);
-        QMapIterator<QString, QVariant> it(m_propertyCache);
-        while (it.hasNext())
-        {
-            it.next();
-            Q_EMIT p.propertyChanged(it.key(), it.value());
-        }
-
-        Q_EMIT p.initialized();
+        fetchAll();
     }
 
     void propertiesChanged(const QString &,
                       const QVariantMap &changedProperties,
                       const QStringList &invalidatedProperties)
     {
+        // The GetAll reply is ordered after this signal, so it already
+        // carries these values. If that GetAll failed, the service is
+        // evidently back, so don't wait for the retry.
+        if (!m_initialized)
+        {
+            fetchAll();
+            return;
+        }
+
         QMapIterator<QString, QVariant> it(changedProperties);
         while (it.hasNext())
         {
             it.next();
+            m_invalidated.remove(it.key());
             if (m_propertyCache[it.key()] != it.value())
             {
                 m_propertyCache[it.key()] = it.value();
@@ -109,7 +264,8 @@ public Q_SLOTS:
             }
         }
 
-        refreshProperties(invalidatedProperties);
+        m_invalidated.unite(invalidatedProperties.toSet());
+        refreshProperties();
     }
 
     void dbusCallFinished(QDBusPendingCallWatcher *call)
@@ -140,11 +296,7 @@ DBusPropertyCache::DBusPropertyCache(const QString &service,
             d.get(), &Priv::serviceOwnerChanged);
 
     // If the service is already registered
-    QString serviceOwner = connection.interface()->serviceOwner(service);
-    if (!serviceOwner.isEmpty())
-    {
-        d->serviceOwnerChanged(service, "", serviceOwner);
-    }
+    d->fetchServiceOwner();
 }
 
 DBusPropertyCache::~DBusPropertyCache()
@@ -153,6 +305,12 @@ DBusPropertyCache::~DBusPropertyCache()
 
 void DBusPropertyCache::set(const QString& name, const QVariant& value)
 {
+    if (!d->m_propertiesInterface)
+    {
+        qWarning() << __PRETTY_FUNCTION__ << d->m_service << "is not available";
+        return;
+    }
+
     if (d->m_propertyCache.value(name) != value)
     {
         auto reply = d->m_propertiesInterface->Set(d->m_interface, name, QDBusVariant(value));
@@ -168,7 +326,24 @@ QVariant DBusPropertyCache::get(const QString& name) const
 
 bool DBusPropertyCache::isInitialized() const
 {
-    return !d->m_propertyCache.empty();
+    return d->m_initialized;
+}
+
+void DBusPropertyCache::whenInitialized(QObject* context, function<void()> callback)
+{
+    if (d->m_initialized)
+    {
+        callback();
+        return;
+    }
+
+    auto connection = make_shared<QMetaObject::Connection>();
+    *connection = connect(this, &DBusPropertyCache::initialized, context,
+            [connection, callback]()
+    {
+        QObject::disconnect(*connection);
+        callback();
+    });
 }
 
 QDBusConnection DBusPropertyCache::connection() const
@@ -22,6 +22,7 @@
 #include <QDBusConnection>
 #include <QObject>
 #include <QString>
+#include <functional>
 #include <memory>
 
 #include <unity/util/DefinesPtrs.h>
@@ -47,6 +48,13 @@ public:
 
     bool isInitialized() const;
 
+    /**
+     * Invokes the callback once the initial property values have arrived.
+     * Runs it immediately if the cache is already initialized. The callback
+     * is dropped if the context object is destroyed first.
+     */
+    void whenInitialized(QObject* context, std::function<void()> callback);
+
     QDBusConnection connection() const;
 
 Q_SIGNALS:
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <indicator-network-test-base-desktop.h>
+
+#include <QElapsedTimer>
+#include <iostream>
+
+using namespace std;
+using namespace testing;
+
+namespace
+{
+
+struct StartupParameters
+{
+    int devices;
+    int accessPointsPerDevice;
+    bool objectManager;
+};
+
+inline void PrintTo(const StartupParameters& parameters, ostream* os)
+{
+    *os << parameters.devices << " devices, "
+        << parameters.accessPointsPerDevice << " APs each, "
+        << (parameters.objectManager ? "ObjectManager" : "no ObjectManager");
+}
+
+class BenchmarkStartup: public IndicatorNetworkTestBaseDesktop,
+        public WithParamInterface<StartupParameters>
+{
+};
+
+TEST_P(BenchmarkStartup, TimeToReady)
+{
+    auto parameters = GetParam();
+
+    if (!parameters.objectManager)
+    {
+        // Behave like NetworkManager before 1.2
+        auto reply = networkManagerMockInterface().RemoveObject("/org/freedesktop");
+        reply.waitForFinished();
+        ASSERT_FALSE(reply.isError()) << reply.error().message().toStdString();
+    }
+
+    setGlobalConnectedState(NM_STATE_CONNECTED_GLOBAL);
+    for (int i = 0; i < parameters.devices; ++i)
+    {
+        auto device = createWiFiDevice(NM_DEVICE_STATE_DISCONNECTED, QString::number(i));
+        for (int j = 0; j < parameters.accessPointsPerDevice; ++j)
+        {
+            auto id = QString::number(i * parameters.accessPointsPerDevice + j);
+            createAccessPoint(id, "ssid" + id, device, j % 100);
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ASSERT_NO_THROW(startIndicator());
+    auto serviceReady = timer.elapsed();
+
+    auto connectivity(newConnectivity());
+    ASSERT_TRUE(connectivity->isInitialized());
+    auto clientReady = timer.elapsed();
+
+    RecordProperty("service_ready_ms", serviceReady);
+    RecordProperty("client_ready_ms", clientReady);
+    cout << "[ BENCHMARK] service ready: " << serviceReady << " ms, client ready: "
+         << clientReady << " ms" << endl;
+}
+
+INSTANTIATE_TEST_CASE_P(
+        Startup,
+        BenchmarkStartup,
+        Values(
+            StartupParameters{1, 10, true},
+            StartupParameters{1, 10, false},
+            StartupParameters{1, 200, true},
+            StartupParameters{1, 200, false},
+            StartupParameters{4, 100, true},
+            StartupParameters{4, 100, false}
+        ));
+
+}
@@ -38,6 +38,8 @@ CSETTINGS_IFACE = 'org.freedesktop.NetworkManager.Settings.Connection'
 ACTIVE_CONNECTION_IFACE = 'org.freedesktop.NetworkManager.Connection.Active'
 AGENT_MANAGER_OBJ = '/org/freedesktop/NetworkManager/AgentManager'
 AGENT_MANAGER_IFACE = 'org.freedesktop.NetworkManager.AgentManager'
+OBJECT_MANAGER_OBJ = '/org/freedesktop'
+OBJECT_MANAGER_IFACE = 'org.freedesktop.DBus.ObjectManager'
 SYSTEM_BUS = True
 
 
@@ -249,6 +251,15 @@ def load(mock, parameters):
                    {},
                    agent_manager_methods)
 
+    # Like NetworkManager 1.2+, export every object through an ObjectManager
+    # at the root of the namespace
+    mock.AddObject(OBJECT_MANAGER_OBJ,
+                   OBJECT_MANAGER_IFACE,
+                   {},
+                   [('GetManagedObjects', '', 'a{oa{sa{sv}}}',
+                     'ret = dbus.Dictionary({dbus.ObjectPath(p): o.props for p, o in objects.items() '
+                     'if p.startswith("%s")}, signature="oa{sa{sv}}")' % MAIN_OBJ)])
+
 
 @dbus.service.method(MOCK_IFACE,
                      in_signature='sssv', out_signature='')
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <indicator-network-test-base-phone.h>
+#include <dbus-types.h>
+#include <nmofono/data-usage-ledger.h>
+
+#include <QDate>
+#include <QDBusMessage>
+#include <QDBusReply>
+#include <QTest>
+
+#include <functional>
+
+using namespace std;
+using namespace testing;
+using namespace nmofono;
+
+namespace
+{
+
+class TestConnectivityApiDataUsage: public IndicatorNetworkTestBasePhone
+{
+protected:
+    QVariantDictMap dataUsage(uint days = 0)
+    {
+        auto message = QDBusMessage::createMethodCall(DBusTypes::DBUS_NAME,
+                                                      DBusTypes::PRIVATE_PATH,
+                                                      DBusTypes::PRIVATE_INTERFACE,
+                                                      "GetDataUsage");
+        message << days;
+        QDBusReply<QVariantDictMap> reply = dbusTestRunner.sessionConnection().call(message);
+        EXPECT_TRUE(reply.isValid()) << reply.error().message().toStdString();
+        return reply.value();
+    }
+
+    quint64 txBytes(const QString& network)
+    {
+        return dataUsage().value(network).value("TxBytes").toULongLong();
+    }
+
+    quint64 rxBytes(const QString& network)
+    {
+        return dataUsage().value(network).value("RxBytes").toULongLong();
+    }
+
+    void connectTo(const QString& id, const QString& ssid)
+    {
+        if (!m_activeConnection.isEmpty())
+        {
+            removeActiveConnection(m_device, m_activeConnection);
+        }
+
+        auto ap = createAccessPoint(id, ssid, m_device);
+        auto connection = createAccessPointConnection(id, ssid, m_device);
+        m_activeConnection = createActiveConnection(id, m_device, connection, ap);
+    }
+
+    void startOnWifi(const QString& ssid)
+    {
+        setGlobalConnectedState(NM_STATE_CONNECTED_GLOBAL);
+        m_device = createWiFiDevice(NM_DEVICE_STATE_ACTIVATED);
+        connectTo("0", ssid);
+
+        ASSERT_NO_THROW(startIndicator());
+        ASSERT_TRUE(waitFor([this]() { return getStatisticsRefreshRateMs(m_device) != 0; }));
+    }
+
+    // Moves the device counters on, as NM does on each refresh
+    void transfer(quint64 tx, quint64 rx)
+    {
+        m_tx += tx;
+        m_rx += rx;
+        setDeviceStatistics(m_device, m_tx, m_rx);
+    }
+
+    // Keeps traffic flowing until some of it is charged to the network
+    bool chargedTo(const QString& network)
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            transfer(1, 1);
+            QTest::qWait(100);
+            if (dataUsage().contains(network))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool waitFor(function<bool()> condition)
+    {
+        for (int i = 0; i < 50 && !condition(); ++i)
+        {
+            QTest::qWait(100);
+        }
+        return condition();
+    }
+
+    QString m_device;
+
+    QString m_activeConnection;
+
+    quint64 m_tx = 0;
+
+    quint64 m_rx = 0;
+};
+
+TEST_F(TestConnectivityApiDataUsage, ChargesWifiTrafficToTheSsid)
+{
+    startOnWifi("Home");
+    ASSERT_TRUE(chargedTo("wifi:Home"));
+    auto tx = txBytes("wifi:Home");
+    auto rx = rxBytes("wifi:Home");
+
+    // What the counters moved by is charged, not the counters themselves
+    transfer(50, 500);
+    ASSERT_TRUE(waitFor([&]() { return txBytes("wifi:Home") == tx + 50; }));
+    EXPECT_EQ(rx + 500, rxBytes("wifi:Home"));
+
+    // The counters start from zero again when the device is reset
+    m_tx = 0;
+    m_rx = 0;
+    transfer(10, 20);
+    ASSERT_TRUE(waitFor([&]() { return txBytes("wifi:Home") == tx + 60; }));
+    EXPECT_EQ(rx + 520, rxBytes("wifi:Home"));
+
+    EXPECT_EQ(QStringList{"wifi:Home"}, dataUsage().keys());
+}
+
+TEST_F(TestConnectivityApiDataUsage, FollowsTheAccessPoint)
+{
+    startOnWifi("Home");
+    ASSERT_TRUE(chargedTo("wifi:Home"));
+
+    connectTo("1", "Cafe");
+    ASSERT_TRUE(chargedTo("wifi:Cafe"));
+    auto home = txBytes("wifi:Home");
+    auto cafe = txBytes("wifi:Cafe");
+
+    transfer(70, 700);
+    ASSERT_TRUE(waitFor([&]() { return txBytes("wifi:Cafe") == cafe + 70; }));
+    EXPECT_EQ(home, txBytes("wifi:Home"));
+
+    // Go home while the screen is off, and the counters aren't followed
+    setDisplayPowerState(DisplayPowerState::Off);
+    ASSERT_TRUE(waitFor([this]() { return getStatisticsRefreshRateMs(m_device) == 0; }));
+    transfer(5000, 50000);
+    connectTo("2", "Home");
+    // Let the service see the new access point
+    QTest::qWait(500);
+
+    setDisplayPowerState(DisplayPowerState::On);
+    ASSERT_TRUE(waitFor([this]() { return getStatisticsRefreshRateMs(m_device) != 0; }));
+
+    // The traffic while the screen was off could have gone over either
+    // network, so neither is charged for it
+    transfer(3, 30);
+    transfer(40, 400);
+    ASSERT_TRUE(waitFor([&]() { return txBytes("wifi:Home") == home + 40; }));
+    EXPECT_EQ(cafe + 70, txBytes("wifi:Cafe"));
+}
+
+TEST_F(TestConnectivityApiDataUsage, GetDataUsageCountsBackFromToday)
+{
+    auto today = QDate::currentDate().toJulianDay();
+    {
+        DataUsageLedger ledger;
+        ledger.add(DataUsageLedger::key(DataUsageLedger::Kind::wifi, "Old"), 10, 100, today - 10);
+        ledger.add(DataUsageLedger::key(DataUsageLedger::Kind::sim, "8944110068256270054"), 20, 200, today - 2);
+    }
+
+    ASSERT_NO_THROW(startIndicator());
+
+    auto all = dataUsage(0);
+    ASSERT_EQ(2, all.size());
+    EXPECT_EQ(10u, all["wifi:Old"]["TxBytes"].toULongLong());
+    EXPECT_EQ(100u, all["wifi:Old"]["RxBytes"].toULongLong());
+    EXPECT_EQ(20u, all["sim:8944110068256270054"]["TxBytes"].toULongLong());
+    EXPECT_EQ(200u, all["sim:8944110068256270054"]["RxBytes"].toULongLong());
+
+    EXPECT_EQ(all.keys(), dataUsage(11).keys());
+    EXPECT_EQ(QStringList{"sim:8944110068256270054"}, dataUsage(10).keys());
+    EXPECT_EQ(QStringList{"sim:8944110068256270054"}, dataUsage(3).keys());
+    EXPECT_TRUE(dataUsage(2).isEmpty());
+}
+
+}
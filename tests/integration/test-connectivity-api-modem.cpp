@@ -135,6 +135,24 @@ protected:
         }
         return modemStates;
     }
+
+    static QString simIccid(QAbstractItemModel& model, int i)
+    {
+        auto sim = qvariant_cast<Sim*>(model.data(model.index(i, 0), ModemsListModel::Roles::RoleSim));
+        return sim ? sim->iccid() : QString();
+    }
+
+    void ejectSim(const QString& modem)
+    {
+        setSimManagerProperty(modem, "Present", false);
+        setSimManagerProperty(modem, "CardIdentifier", "");
+    }
+
+    void insertSim(const QString& modem, const QString& iccid)
+    {
+        setSimManagerProperty(modem, "Present", true);
+        setSimManagerProperty(modem, "CardIdentifier", iccid);
+    }
 };
 
 TEST_F(TestConnectivityApiModem, SingleModemAtStartup)
@@ -319,4 +337,70 @@ TEST_F(TestConnectivityApiModem, ModemProperties)
     EXPECT_TRUE(modem->sim());
 }
 
+TEST_F(TestConnectivityApiModem, SimHotSwap)
+{
+    static const QString FIRST_ICCID = "893581234000000000000";
+    static const QString SECOND_ICCID = "893581234000000000001";
+
+    auto secondModem = createModem("ril_1");
+
+    // Add a physical device to use for the connection
+    setGlobalConnectedState(NM_STATE_CONNECTED_GLOBAL);
+    createWiFiDevice(NM_DEVICE_STATE_ACTIVATED);
+
+    // Start the indicator
+    ASSERT_NO_THROW(startIndicator());
+
+    // Connect the the service
+    auto connectivity(newConnectivity());
+
+    // Get the modems model
+    auto modems = getSortedModems(*connectivity);
+
+    DEFINE_MODEL_LISTENERS
+
+    WAIT_FOR_ROW_COUNT(rowsInsertedSpy, modems, 2)
+    while (simIccid(*modems, 0) != FIRST_ICCID || simIccid(*modems, 1) != SECOND_ICCID)
+    {
+        ASSERT_TRUE(dataChangedSpy.wait());
+    }
+
+    // Swap the cards between the slots back and forth
+    for (int round = 0; round < 6; ++round)
+    {
+        bool swapped = (round % 2 == 0);
+        auto firstSlot = swapped ? SECOND_ICCID : FIRST_ICCID;
+        auto secondSlot = swapped ? FIRST_ICCID : SECOND_ICCID;
+
+        ejectSim(firstModem());
+        ejectSim(secondModem);
+        insertSim(firstModem(), firstSlot);
+        insertSim(secondModem, secondSlot);
+
+        while (simIccid(*modems, 0) != firstSlot || simIccid(*modems, 1) != secondSlot)
+        {
+            ASSERT_TRUE(dataChangedSpy.wait()) << "round " << round;
+        }
+    }
+
+    // Taking one card out leaves the other slot alone
+    ejectSim(secondModem);
+    while (!simIccid(*modems, 1).isEmpty())
+    {
+        ASSERT_TRUE(dataChangedSpy.wait());
+    }
+    EXPECT_EQ(FIRST_ICCID, simIccid(*modems, 0));
+
+    insertSim(secondModem, SECOND_ICCID);
+    while (simIccid(*modems, 1) != SECOND_ICCID)
+    {
+        ASSERT_TRUE(dataChangedSpy.wait());
+    }
+    EXPECT_EQ(FIRST_ICCID, simIccid(*modems, 0));
+
+    // The cards were recognised, not added again
+    EXPECT_EQ(2, connectivity->sims()->rowCount());
+    EXPECT_TRUE(rowsRemovedSpy.isEmpty());
+}
+
 }
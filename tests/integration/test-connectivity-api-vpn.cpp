@@ -458,11 +458,39 @@ TEST_F(TestConnectivityApiVpn, ReadsOpenvpnProperties)
     QSignalSpy certPassChangedSpy(connection, SIGNAL(certPassChanged(const QString&)));
     QSignalSpy passwordChangedSpy(connection, SIGNAL(passwordChanged(const QString&)));
 
+    // The secrets are fetched once a client reads one, which may already have happened
+    if (connection->certPass().isEmpty())
+    {
+        WAIT_FOR_SIGNALS(certPassChangedSpy, 1);
+    }
+    if (connection->password().isEmpty())
+    {
+        WAIT_FOR_SIGNALS(passwordChangedSpy, 1);
+    }
+    EXPECT_EQ("certificate password", connection->certPass());
+    EXPECT_EQ("the password", connection->password());
+
+    // Known secrets are only fetched again when asked to
+    settings = appleInterface.GetSettings();
+    settings["vpn"]["secrets"] = QVariant::fromValue(QStringMap(
+    {
+        {"cert-pass", "certificate password 2"},
+        {"password", "the password 2"}
+    }));
+    reply = appleInterface.Update(settings);
+    reply.waitForFinished();
+    if (reply.isError())
+    {
+        EXPECT_FALSE(reply.isError()) << reply.error().message().toStdString();
+    }
+
+    certPassChangedSpy.clear();
+    passwordChangedSpy.clear();
     connection->updateSecrets();
     WAIT_FOR_SIGNALS(certPassChangedSpy, 1);
     WAIT_FOR_SIGNALS(passwordChangedSpy, 1);
-    EXPECT_EQ("certificate password", connection->certPass());
-    EXPECT_EQ("the password", connection->password());
+    EXPECT_EQ("certificate password 2", connection->certPass());
+    EXPECT_EQ("the password 2", connection->password());
 }
 
 TEST_F(TestConnectivityApiVpn, WritesOpenvpnProperties)
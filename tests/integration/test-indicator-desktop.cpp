@@ -80,6 +80,11 @@ TEST_F(TestIndicatorDesktop, WifiToggleTalksToNetworkManager)
     ASSERT_NO_THROW(startIndicator());
 
     util::DBusPropertyCache networkManager(NM_DBUS_SERVICE, NM_DBUS_INTERFACE, NM_DBUS_PATH, dbusTestRunner.systemConnection());
+    if (!networkManager.isInitialized())
+    {
+        QSignalSpy initSpy(&networkManager, SIGNAL(initialized()));
+        ASSERT_TRUE(initSpy.wait());
+    }
     QSignalSpy networkManagerSpy(&networkManager, SIGNAL(propertyChanged(const QString&, const QVariant&)));
 
     EXPECT_TRUE(networkManager.get("WirelessEnabled").toBool());
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+
+#pragma once
+
+#include <nmofono/wifi/access-point-impl.h>
+
+#include <NetworkManager.h>
+#include <NetworkManagerAccessPointInterface.h>
+#include <NetworkManagerInterface.h>
+
+#include <QDBusConnection>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+
+/**
+ * Builds nmofono objects on a D-Bus connection that is never opened.
+ *
+ * Calls fail straight away, and tests drive the objects by emitting
+ * signals on the proxies directly, so building thousands of them stays
+ * cheap.
+ */
+class NetworkManagerTestBase : public ::testing::Test
+{
+protected:
+    static QString accessPointPath(int i)
+    {
+        return "/org/freedesktop/NetworkManager/AccessPoint/" + QString::number(i);
+    }
+
+    nmofono::wifi::AccessPointImpl::Ptr accessPoint(int i, const QByteArray& ssid, uchar strength = 50)
+    {
+        auto iface = std::make_shared<OrgFreedesktopNetworkManagerAccessPointInterface>(
+                NM_DBUS_SERVICE, accessPointPath(i), m_connection);
+        m_accessPointInterfaces[i] = iface;
+        return std::make_shared<nmofono::wifi::AccessPointImpl>(iface, QVariantMap{
+            {"Ssid", ssid},
+            {"Mode", uint(NM_802_11_MODE_INFRA)},
+            {"Strength", uint(strength)},
+            {"HwAddress", QString("00:00:00:00:00:%1").arg(i % 256, 2, 16, QChar('0'))}
+        });
+    }
+
+    void setStrength(int i, uchar strength)
+    {
+        Q_EMIT m_accessPointInterfaces.at(i)->PropertiesChanged(
+                QVariantMap{{"Strength", QVariant::fromValue(strength)}});
+    }
+
+    QDBusConnection m_connection{"disconnected"};
+
+    std::shared_ptr<OrgFreedesktopNetworkManagerInterface> m_nm = std::make_shared<OrgFreedesktopNetworkManagerInterface>(
+            NM_DBUS_SERVICE, NM_DBUS_PATH, m_connection);
+
+    // Kept so that tests can emit signals on them
+    std::map<int, std::shared_ptr<OrgFreedesktopNetworkManagerAccessPointInterface>> m_accessPointInterfaces;
+};
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include "network-manager-test-base.h"
+
+#include <nmofono/wifi/access-point-registry.h>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace testing;
+using namespace nmofono::wifi;
+
+namespace
+{
+
+class TestAccessPointRegistry : public NetworkManagerTestBase
+{
+protected:
+    static QString path(int i)
+    {
+        return accessPointPath(i);
+    }
+
+    AccessPointRegistry m_registry;
+};
+
+TEST_F(TestAccessPointRegistry, GroupsBySsid)
+{
+    m_registry.add(accessPoint(0, "home", 20));
+    m_registry.add(accessPoint(1, "home", 80));
+    m_registry.add(accessPoint(2, "cafe"));
+
+    EXPECT_EQ(3, m_registry.size());
+    EXPECT_EQ(2, m_registry.groups().size());
+
+    auto home = m_registry.group(QDBusObjectPath(path(0)));
+    ASSERT_TRUE(bool(home));
+    EXPECT_EQ(home, m_registry.group(QDBusObjectPath(path(1))));
+    EXPECT_EQ(2, home->num_aps());
+    EXPECT_DOUBLE_EQ(80.0, home->strength());
+}
+
+TEST_F(TestAccessPointRegistry, IgnoresDuplicatePaths)
+{
+    m_registry.add(accessPoint(0, "home"));
+    m_registry.add(accessPoint(0, "home"));
+
+    EXPECT_EQ(1, m_registry.size());
+    EXPECT_EQ(1, m_registry.group(QDBusObjectPath(path(0)))->num_aps());
+}
+
+TEST_F(TestAccessPointRegistry, RemovesEmptyGroups)
+{
+    m_registry.add(accessPoint(0, "home"));
+    m_registry.add(accessPoint(1, "home"));
+
+    EXPECT_TRUE(bool(m_registry.remove(QDBusObjectPath(path(0)))));
+    EXPECT_FALSE(m_registry.contains(QDBusObjectPath(path(0))));
+    EXPECT_EQ(1, m_registry.groups().size());
+
+    EXPECT_TRUE(bool(m_registry.remove(QDBusObjectPath(path(1)))));
+    EXPECT_TRUE(m_registry.groups().isEmpty());
+
+    EXPECT_FALSE(bool(m_registry.remove(QDBusObjectPath(path(1)))));
+}
+
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include "network-manager-test-base.h"
+
+#include <nmofono/connection/active-connection-manager.h>
+#include <nmofono/vpn/vpn-connection.h>
+
+#include <QSignalSpy>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace testing;
+using namespace nmofono;
+using namespace nmofono::connection;
+using namespace nmofono::vpn;
+
+namespace
+{
+
+class TestActiveConnectionManager : public NetworkManagerTestBase
+{
+protected:
+    static QDBusObjectPath settingsPath(int i)
+    {
+        return QDBusObjectPath("/org/freedesktop/NetworkManager/Settings/" + QString::number(i));
+    }
+
+    static QDBusObjectPath activePath(int i)
+    {
+        return QDBusObjectPath("/org/freedesktop/NetworkManager/ActiveConnection/" + QString::number(i));
+    }
+
+    // Starts with the VPNs in active already activated
+    ActiveConnectionManager::SPtr manager(const QList<int>& active)
+    {
+        QObjectPathVariantDictMap objects;
+        QList<QDBusObjectPath> paths;
+        for (int i : active)
+        {
+            paths << activePath(i);
+            objects[activePath(i)][NM_DBUS_INTERFACE_ACTIVE_CONNECTION] = QVariantMap{
+                {"Id", "vpn" + QString::number(i)},
+                {"Uuid", "uuid" + QString::number(i)},
+                {"Type", "vpn"},
+                {"State", uint(NM_ACTIVE_CONNECTION_STATE_ACTIVATED)},
+                {"Connection", QVariant::fromValue(settingsPath(i))},
+                {"SpecificObject", QVariant::fromValue(QDBusObjectPath("/"))}
+            };
+        }
+        objects[QDBusObjectPath(NM_DBUS_PATH)][NM_DBUS_INTERFACE] = QVariantMap{
+            {"ActiveConnections", QVariant::fromValue(paths)}
+        };
+
+        return make_shared<ActiveConnectionManager>(m_nm, make_shared<ObjectSnapshot>(objects));
+    }
+
+    VpnConnection::SPtr vpn(int i, ActiveConnectionManager::SPtr activeConnectionManager)
+    {
+        QVariantDictMap settings;
+        settings["connection"] = QVariantMap{
+            {"type", "vpn"},
+            {"id", "vpn" + QString::number(i)},
+            {"uuid", "uuid" + QString::number(i)}
+        };
+        settings["vpn"] = QVariantMap{
+            {"service-type", "org.freedesktop.NetworkManager.openvpn"}
+        };
+        return make_shared<VpnConnection>(settingsPath(i), settings, activeConnectionManager, m_connection);
+    }
+
+    void setActiveConnections(const QList<int>& active)
+    {
+        QList<QDBusObjectPath> paths;
+        for (int i : active)
+        {
+            paths << activePath(i);
+        }
+        Q_EMIT m_nm->PropertiesChanged(QVariantMap{{"ActiveConnections", QVariant::fromValue(paths)}});
+    }
+};
+
+TEST_F(TestActiveConnectionManager, IndexesBySettingsPath)
+{
+    auto activeConnectionManager = manager({1, 2});
+
+    ASSERT_TRUE(bool(activeConnectionManager->connectionForSettings(settingsPath(1))));
+    EXPECT_EQ(activePath(1), activeConnectionManager->connectionForSettings(settingsPath(1))->path());
+    EXPECT_FALSE(bool(activeConnectionManager->connectionForSettings(settingsPath(3))));
+
+    auto one = activeConnectionManager->watch(settingsPath(1));
+    auto two = activeConnectionManager->watch(settingsPath(2));
+    EXPECT_TRUE(bool(one->activeConnection()));
+    EXPECT_TRUE(bool(two->activeConnection()));
+
+    QSignalSpy oneSpy(one.get(), &ActiveConnectionWatch::activeConnectionChanged);
+    QSignalSpy twoSpy(two.get(), &ActiveConnectionWatch::activeConnectionChanged);
+
+    setActiveConnections({2});
+    EXPECT_EQ(1, oneSpy.size());
+    EXPECT_EQ(0, twoSpy.size());
+    EXPECT_FALSE(bool(one->activeConnection()));
+    EXPECT_FALSE(bool(activeConnectionManager->connectionForSettings(settingsPath(1))));
+
+    // Dropped watches are no longer updated
+    two.reset();
+    setActiveConnections({});
+    EXPECT_FALSE(bool(activeConnectionManager->connectionForSettings(settingsPath(2))));
+}
+
+TEST_F(TestActiveConnectionManager, ActivationChangeWithManyVpns)
+{
+    static const int COUNT = 200;
+    static const int ACTIVE = 57;
+
+    auto activeConnectionManager = manager({ACTIVE});
+
+    vector<VpnConnection::SPtr> vpns;
+    vector<shared_ptr<QSignalSpy>> spies;
+    for (int i = 0; i < COUNT; ++i)
+    {
+        auto connection = vpn(i, activeConnectionManager);
+        ASSERT_TRUE(connection->isValid());
+        spies.emplace_back(make_shared<QSignalSpy>(connection.get(), SIGNAL(activeChanged(bool))));
+        vpns.emplace_back(connection);
+    }
+    ASSERT_TRUE(vpns[ACTIVE]->isActive());
+
+    setActiveConnections({});
+
+    EXPECT_FALSE(vpns[ACTIVE]->isActive());
+    for (int i = 0; i < COUNT; ++i)
+    {
+        EXPECT_EQ(i == ACTIVE ? 1 : 0, spies[i]->size()) << "VPN " << i;
+    }
+}
+
+}
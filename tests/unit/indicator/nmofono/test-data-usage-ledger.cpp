@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/data-usage-ledger.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace testing;
+using namespace nmofono;
+
+namespace
+{
+
+class TestDataUsageLedger : public Test
+{
+protected:
+    QString path() const
+    {
+        return m_dir.path() + "/ledger";
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(TestDataUsageLedger, AccumulatesPerNetwork)
+{
+    DataUsageLedger ledger(path());
+    auto sim = DataUsageLedger::key(DataUsageLedger::Kind::sim, "8944110068256270054");
+    auto wifi = DataUsageLedger::key(DataUsageLedger::Kind::wifi, "Home");
+
+    ledger.add(sim, 100, 1000, 10);
+    ledger.add(sim, 50, 500, 10);
+    ledger.add(wifi, 1, 2, 10);
+
+    auto totals = ledger.totals();
+    ASSERT_EQ(2, totals.size());
+    EXPECT_EQ(150u, totals["sim:8944110068256270054"].txBytes);
+    EXPECT_EQ(1500u, totals["sim:8944110068256270054"].rxBytes);
+    EXPECT_EQ(1u, totals["wifi:Home"].txBytes);
+    EXPECT_EQ(2u, totals["wifi:Home"].rxBytes);
+}
+
+TEST_F(TestDataUsageLedger, RollsUpDaily)
+{
+    DataUsageLedger ledger(path());
+    auto ethernet = DataUsageLedger::key(DataUsageLedger::Kind::ethernet, "0b2d7d84-0b0c-4c6a-8f7e-2d9ae4b1d3a1");
+
+    ledger.add(ethernet, 10, 10, 10);
+    ledger.add(ethernet, 20, 20, 11);
+    ledger.add(ethernet, 30, 30, 12);
+
+    EXPECT_EQ(60u, ledger.totals()["ethernet:0b2d7d84-0b0c-4c6a-8f7e-2d9ae4b1d3a1"].txBytes);
+    EXPECT_EQ(50u, ledger.totals(11)["ethernet:0b2d7d84-0b0c-4c6a-8f7e-2d9ae4b1d3a1"].txBytes);
+    EXPECT_EQ(30u, ledger.totals(12)["ethernet:0b2d7d84-0b0c-4c6a-8f7e-2d9ae4b1d3a1"].rxBytes);
+    EXPECT_TRUE(ledger.totals(13).isEmpty());
+}
+
+TEST_F(TestDataUsageLedger, PersistsAcrossInstances)
+{
+    auto wifi = DataUsageLedger::key(DataUsageLedger::Kind::wifi, "Cafe");
+    {
+        DataUsageLedger ledger(path());
+        ledger.add(wifi, 5, 7, 20);
+    }
+
+    DataUsageLedger ledger(path());
+    ledger.add(wifi, 5, 7, 20);
+
+    auto totals = ledger.totals();
+    ASSERT_EQ(1, totals.size());
+    EXPECT_EQ(10u, totals["wifi:Cafe"].txBytes);
+    EXPECT_EQ(14u, totals["wifi:Cafe"].rxBytes);
+}
+
+TEST_F(TestDataUsageLedger, GrowsPastOnePage)
+{
+    DataUsageLedger ledger(path());
+    for (int i = 0; i < 200; ++i)
+    {
+        ledger.add(DataUsageLedger::key(DataUsageLedger::Kind::wifi, QByteArray::number(i)), 1, 1, 30);
+    }
+
+    auto totals = ledger.totals();
+    EXPECT_EQ(200, totals.size());
+    EXPECT_EQ(1u, totals["wifi:199"].rxBytes);
+}
+
+TEST_F(TestDataUsageLedger, DiscardsUnreadableFile)
+{
+    {
+        QFile file(path());
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write("not a ledger");
+    }
+
+    DataUsageLedger ledger(path());
+    EXPECT_TRUE(ledger.totals().isEmpty());
+
+    ledger.add(DataUsageLedger::key(DataUsageLedger::Kind::sim, "1234"), 1, 2, 40);
+    EXPECT_EQ(2u, ledger.totals()["sim:1234"].rxBytes);
+}
+
+}
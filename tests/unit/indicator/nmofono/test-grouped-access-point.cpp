@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include "network-manager-test-base.h"
+
+#include <nmofono/wifi/grouped-access-point.h>
+
+#include <QSignalSpy>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace testing;
+using namespace nmofono::wifi;
+
+namespace
+{
+
+class TestGroupedAccessPoint : public NetworkManagerTestBase
+{
+protected:
+    AccessPointImpl::Ptr accessPoint(int i, uchar strength)
+    {
+        return NetworkManagerTestBase::accessPoint(i, "enterprise", strength);
+    }
+};
+
+TEST_F(TestGroupedAccessPoint, TracksStrongestMember)
+{
+    vector<AccessPointImpl::Ptr> aps;
+    for (int i = 0; i < 30; ++i)
+    {
+        aps.emplace_back(accessPoint(i, 10 + i));
+    }
+
+    GroupedAccessPoint group(aps.front());
+    QSignalSpy spy(&group, SIGNAL(strengthUpdated(double)));
+    for (size_t i = 1; i < aps.size(); ++i)
+    {
+        group.add_ap(aps[i]);
+    }
+    EXPECT_EQ(30, group.num_aps());
+    EXPECT_DOUBLE_EQ(39.0, group.strength());
+    EXPECT_EQ(29, spy.size());
+    spy.clear();
+
+    // Changes below the maximum are invisible
+    setStrength(0, 20);
+    setStrength(5, 30);
+    EXPECT_EQ(0, spy.size());
+
+    setStrength(3, 60);
+    EXPECT_EQ(1, spy.size());
+    EXPECT_DOUBLE_EQ(60.0, group.strength());
+    spy.clear();
+
+    // Removing a weak member changes nothing
+    group.remove_ap(aps[10]);
+    EXPECT_EQ(0, spy.size());
+    EXPECT_FALSE(group.has_object(aps[10]->object_path()));
+
+    // Removing the strongest falls back to the next one
+    group.remove_ap(aps[3]);
+    EXPECT_EQ(1, spy.size());
+    EXPECT_DOUBLE_EQ(39.0, group.strength());
+    spy.clear();
+
+    // Removed members no longer count
+    setStrength(3, 90);
+    EXPECT_EQ(0, spy.size());
+    EXPECT_DOUBLE_EQ(39.0, group.strength());
+}
+
+TEST_F(TestGroupedAccessPoint, FirstMemberRepresentsGroup)
+{
+    auto first = accessPoint(0, 10);
+    auto second = accessPoint(1, 90);
+
+    GroupedAccessPoint group(first);
+    group.add_ap(second);
+    EXPECT_EQ(first->object_path(), group.object_path());
+    EXPECT_EQ(first->bssid(), group.bssid());
+
+    group.remove_ap(first);
+    EXPECT_EQ(second->object_path(), group.object_path());
+
+    group.remove_ap(second);
+    EXPECT_EQ(QDBusObjectPath("/"), group.object_path());
+    EXPECT_DOUBLE_EQ(0.0, group.strength());
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/throughput-meter.h>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace testing;
+using namespace nmofono;
+
+namespace
+{
+
+TEST(TestThroughputMeter, NoRateFromSingleSample)
+{
+    ThroughputMeter meter;
+    meter.addSample(1000, 2000, 0);
+
+    auto throughput = meter.throughput();
+    EXPECT_DOUBLE_EQ(0.0, throughput.txRate);
+    EXPECT_DOUBLE_EQ(0.0, throughput.rxRate);
+    EXPECT_DOUBLE_EQ(0.0, throughput.recentTxRate);
+    EXPECT_DOUBLE_EQ(0.0, throughput.recentRxRate);
+}
+
+TEST(TestThroughputMeter, SteadyRate)
+{
+    ThroughputMeter meter;
+    for (quint64 i = 0; i < 40; ++i)
+    {
+        meter.addSample(i * 500, i * 1000, i * 500);
+    }
+
+    EXPECT_EQ(ThroughputMeter::CAPACITY, meter.size());
+
+    auto throughput = meter.throughput();
+    EXPECT_DOUBLE_EQ(1000.0, throughput.txRate);
+    EXPECT_DOUBLE_EQ(2000.0, throughput.rxRate);
+    EXPECT_DOUBLE_EQ(1000.0, throughput.recentTxRate);
+    EXPECT_DOUBLE_EQ(2000.0, throughput.recentRxRate);
+}
+
+TEST(TestThroughputMeter, SmoothsBursts)
+{
+    ThroughputMeter meter;
+    meter.addSample(0, 0, 0);
+    meter.addSample(0, 0, 500);
+    meter.addSample(0, 10000, 1000);
+
+    auto throughput = meter.throughput();
+    EXPECT_GT(throughput.rxRate, 0.0);
+    EXPECT_LT(throughput.rxRate, 20000.0);
+    EXPECT_DOUBLE_EQ(10000.0, throughput.recentRxRate);
+}
+
+TEST(TestThroughputMeter, FoldsCloseSamples)
+{
+    ThroughputMeter meter;
+    meter.addSample(0, 0, 0);
+    meter.addSample(1000, 0, 500);
+    meter.addSample(1000, 2000, 510);
+
+    EXPECT_EQ(2u, meter.size());
+
+    auto throughput = meter.throughput();
+    EXPECT_NEAR(1960.8, throughput.txRate, 0.1);
+    EXPECT_NEAR(3921.6, throughput.rxRate, 0.1);
+}
+
+TEST(TestThroughputMeter, ResetsWhenCountersGoBackwards)
+{
+    ThroughputMeter meter;
+    meter.addSample(5000, 5000, 0);
+    meter.addSample(6000, 6000, 500);
+    meter.addSample(10, 10, 1000);
+
+    EXPECT_EQ(1u, meter.size());
+    EXPECT_DOUBLE_EQ(0.0, meter.throughput().txRate);
+}
+
+}
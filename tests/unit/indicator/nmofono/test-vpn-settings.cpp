@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/vpn/openvpn-connection.h>
+#include <nmofono/vpn/pptp-connection.h>
+
+#include <QSignalSpy>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace testing;
+using namespace nmofono::vpn;
+
+namespace
+{
+
+TEST(TestVpnSettings, OpenvpnFields)
+{
+    OpenvpnConnection connection;
+    QSignalSpy caSpy(&connection, &OpenvpnConnection::caChanged);
+    QSignalSpy portSpy(&connection, &OpenvpnConnection::portChanged);
+    QSignalSpy portSetSpy(&connection, &OpenvpnConnection::portSetChanged);
+
+    connection.updateData({
+        {"connection-type", "password"},
+        {"ca", "/ca.crt"},
+        {"remote", "vpn.example.com"},
+        {"port", "443"},
+        {"comp-lzo", "yes"},
+        {"proxy-type", "http"},
+        {"proxy-server", "proxy.example.com"},
+        {"unknown-key", "ignored"}
+    });
+    EXPECT_EQ(OpenvpnConnection::ConnectionType::PASSWORD, connection.connectionType());
+    EXPECT_EQ("/ca.crt", connection.ca());
+    EXPECT_EQ("vpn.example.com", connection.remote());
+    EXPECT_TRUE(connection.portSet());
+    EXPECT_EQ(443, connection.port());
+    EXPECT_TRUE(connection.compLzo());
+    EXPECT_FALSE(connection.protoTcp());
+    EXPECT_EQ(OpenvpnConnection::ProxyType::HTTP, connection.proxyType());
+    EXPECT_EQ("proxy.example.com", connection.proxyServer());
+    EXPECT_EQ(1, caSpy.size());
+    EXPECT_EQ(1, portSpy.size());
+    EXPECT_EQ(1, portSetSpy.size());
+
+    // Unchanged values are not announced again
+    connection.updateData({
+        {"connection-type", "password"},
+        {"ca", "/ca.crt"},
+        {"port", "443"}
+    });
+    EXPECT_EQ(1, caSpy.size());
+    EXPECT_EQ(1, portSpy.size());
+
+    // Keys that go away take their absent value
+    EXPECT_EQ("", connection.remote());
+    EXPECT_FALSE(connection.compLzo());
+
+    connection.updateData({});
+    EXPECT_EQ("", connection.ca());
+    EXPECT_FALSE(connection.portSet());
+    EXPECT_EQ(443, connection.port());
+    EXPECT_EQ(2, caSpy.size());
+    EXPECT_EQ(2, portSetSpy.size());
+}
+
+TEST(TestVpnSettings, OpenvpnSecrets)
+{
+    OpenvpnConnection connection;
+    connection.updateData({{"connection-type", "password-tls"}, {"proxy-type", "socks"}});
+
+    connection.updateSecrets({
+        {"cert-pass", "certificate"},
+        {"password", "secret"},
+        {"socks-proxy-password", "proxy"}
+    });
+    EXPECT_EQ("certificate", connection.certPass());
+    EXPECT_EQ("secret", connection.password());
+    EXPECT_EQ("proxy", connection.proxyPassword());
+}
+
+TEST(TestVpnSettings, PptpFields)
+{
+    PptpConnection connection;
+    QSignalSpy papSpy(&connection, &PptpConnection::allowPapChanged);
+
+    EXPECT_TRUE(connection.allowPap());
+    EXPECT_TRUE(connection.bsdCompression());
+
+    connection.updateData({
+        {"gateway", "vpn.example.com"},
+        {"refuse-pap", "yes"},
+        {"refuse-chap", "no"},
+        {"nobsdcomp", "yes"},
+        {"require-mppe-128", "yes"},
+        {"mppe-stateful", "yes"},
+        {"lcp-echo-interval", "30"}
+    });
+    EXPECT_EQ("vpn.example.com", connection.gateway());
+    EXPECT_FALSE(connection.allowPap());
+    EXPECT_TRUE(connection.allowChap());
+    EXPECT_FALSE(connection.bsdCompression());
+    EXPECT_TRUE(connection.requireMppe());
+    EXPECT_EQ(PptpConnection::MppeType::MPPE_128, connection.mppeType());
+    EXPECT_TRUE(connection.mppeStateful());
+    EXPECT_TRUE(connection.sendPppEchoPackets());
+    EXPECT_EQ(1, papSpy.size());
+
+    connection.updateData({{"gateway", "vpn.example.com"}});
+    EXPECT_TRUE(connection.allowPap());
+    EXPECT_TRUE(connection.bsdCompression());
+    EXPECT_FALSE(connection.mppeStateful());
+    EXPECT_FALSE(connection.sendPppEchoPackets());
+    EXPECT_EQ(2, papSpy.size());
+
+    connection.updateSecrets({{"password", "secret"}});
+    EXPECT_EQ("secret", connection.password());
+}
+
+}
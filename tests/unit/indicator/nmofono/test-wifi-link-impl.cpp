@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <nmofono/connection/active-connection-manager.h>
+#include <nmofono/wifi/grouped-access-point.h>
+#include <nmofono/wifi/network-manager-wifi-toggle.h>
+#include <nmofono/wifi/wifi-connection-index.h>
+#include <nmofono/wifi/wifi-link-impl.h>
+
+#include <dbus-types.h>
+#include <NetworkManager.h>
+#include <NetworkManagerDeviceInterface.h>
+#include <NetworkManagerInterface.h>
+#include <NetworkManagerSettingsInterface.h>
+
+#include <libqtdbustest/DBusTestRunner.h>
+#include <libqtdbusmock/DBusMock.h>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+
+using namespace std;
+using namespace testing;
+using namespace QtDBusTest;
+using namespace QtDBusMock;
+using namespace nmofono;
+using namespace nmofono::connection;
+using namespace nmofono::wifi;
+
+namespace
+{
+
+/**
+ * Drives a WifiLinkImpl with the AccessPointAdded and AccessPointRemoved
+ * signals of a mock NetworkManager.
+ */
+class TestWifiLinkImpl : public Test
+{
+protected:
+    struct Change
+    {
+        QSet<AccessPoint::Ptr> added;
+        QSet<AccessPoint::Ptr> removed;
+    };
+
+    TestWifiLinkImpl() :
+            dbusMock(dbusTestRunner)
+    {
+        DBusTypes::registerMetaTypes();
+
+        dbusMock.registerTemplate(NM_DBUS_SERVICE, DBUSMOCK_TEMPLATE_DIR "networkmanager.py", {}, QDBusConnection::SystemBus);
+        dbusTestRunner.startServices();
+    }
+
+    static QString accessPointPath(const QString& id)
+    {
+        return "/org/freedesktop/NetworkManager/AccessPoint/" + id;
+    }
+
+    void addDevice()
+    {
+        auto reply = dbusMock.networkManagerInterface().AddWiFiDevice("0", "wlan0", NM_DEVICE_STATE_DISCONNECTED);
+        reply.waitForFinished();
+        EXPECT_FALSE(reply.isError()) << reply.error().message().toStdString();
+        m_device = reply;
+    }
+
+    shared_ptr<WifiLinkImpl> wifiLink()
+    {
+        addDevice();
+        return createLink();
+    }
+
+    shared_ptr<WifiLinkImpl> createLink()
+    {
+        auto connection = dbusTestRunner.systemConnection();
+
+        m_nm = make_shared<OrgFreedesktopNetworkManagerInterface>(NM_DBUS_SERVICE, NM_DBUS_PATH, connection);
+        auto nm = m_nm;
+        auto link = make_shared<WifiLinkImpl>(
+                make_shared<OrgFreedesktopNetworkManagerDeviceInterface>(NM_DBUS_SERVICE, m_device, connection),
+                nm,
+                make_shared<NetworkManagerWifiToggle>(connection),
+                make_shared<ActiveConnectionManager>(nm),
+                make_shared<WifiConnectionIndex>(
+                        make_shared<OrgFreedesktopNetworkManagerSettingsInterface>(
+                                NM_DBUS_SERVICE, NM_DBUS_PATH_SETTINGS, connection)));
+
+        QObject::connect(link.get(), &WifiLink::accessPointsChanged,
+                [this](const QSet<AccessPoint::Ptr>& added, const QSet<AccessPoint::Ptr>& removed)
+                {
+                    m_changes.push_back({added, removed});
+                });
+
+        return link;
+    }
+
+    QDBusPendingCall addAccessPoint(const QString& id, const QString& ssid)
+    {
+        return dbusMock.networkManagerInterface().AddAccessPoint(
+                m_device, id, ssid, "00:00:00:00:00:00", NM_802_11_MODE_INFRA,
+                0, 0, 50, NM_802_11_AP_SEC_NONE);
+    }
+
+    QDBusPendingCall removeAccessPoint(const QString& id)
+    {
+        return dbusMock.networkManagerInterface().RemoveAccessPoint(m_device, accessPointPath(id));
+    }
+
+    // Every call is sent before waiting for any of the replies
+    static void finish(const QList<QDBusPendingCall>& calls)
+    {
+        for (auto call : calls)
+        {
+            call.waitForFinished();
+            EXPECT_FALSE(call.isError()) << call.error().message().toStdString();
+        }
+    }
+
+    // Lets D-Bus traffic through until the condition holds, or gives up
+    static bool waitFor(function<bool()> condition)
+    {
+        for (int i = 0; i < 2000 && !condition(); ++i)
+        {
+            QTest::qWait(10);
+        }
+        return condition();
+    }
+
+    DBusTestRunner dbusTestRunner;
+
+    DBusMock dbusMock;
+
+    QString m_device;
+
+    shared_ptr<OrgFreedesktopNetworkManagerInterface> m_nm;
+
+    vector<Change> m_changes;
+};
+
+TEST_F(TestWifiLinkImpl, ScanBurstStress)
+{
+    static const int COUNT = 1000;
+    static const int NETWORKS = 100;
+
+    auto link = wifiLink();
+    // Publish every change straight away, so that the counts are exact
+    link->setScanDebounce(0, 0);
+
+    QList<QDBusPendingCall> calls;
+    for (int i = 0; i < COUNT; ++i)
+    {
+        calls << addAccessPoint(QString::number(i), "ssid" + QString::number(i % NETWORKS));
+    }
+    finish(calls);
+    calls.clear();
+
+    // The properties of each access point are fetched in the order they
+    // were added, so once this one is published all the others are in.
+    finish({addAccessPoint("last", "last")});
+    ASSERT_TRUE(waitFor([this]() { return m_changes.size() >= NETWORKS + 1; }));
+
+    // One change per network, not per access point
+    EXPECT_EQ(NETWORKS + 1, m_changes.size());
+    auto networks = link->accessPoints();
+    EXPECT_EQ(NETWORKS + 1, networks.size());
+    int members = 0;
+    for (const auto& network : networks)
+    {
+        auto group = dynamic_pointer_cast<GroupedAccessPoint>(network);
+        ASSERT_TRUE(bool(group));
+        members += group->num_aps();
+    }
+    EXPECT_EQ(COUNT + 1, members);
+
+    for (int i = 0; i < COUNT; ++i)
+    {
+        calls << removeAccessPoint(QString::number(i));
+    }
+    finish(calls);
+    finish({removeAccessPoint("last")});
+    ASSERT_TRUE(waitFor([this]() { return m_changes.size() >= 2 * (NETWORKS + 1); }));
+
+    EXPECT_EQ(2 * (NETWORKS + 1), m_changes.size());
+    EXPECT_TRUE(link->accessPoints().isEmpty());
+    EXPECT_EQ(2 * (NETWORKS + 1), link->emittedUpdates());
+    EXPECT_EQ(0, link->coalescedUpdates());
+}
+
+TEST_F(TestWifiLinkImpl, OneUpdatePerWindow)
+{
+    auto link = wifiLink();
+    link->setScanDebounce(500, 10000);
+
+    finish({addAccessPoint("0", "home"), addAccessPoint("1", "work"), addAccessPoint("2", "cafe")});
+    ASSERT_TRUE(waitFor([this]() { return !m_changes.empty(); }));
+    // Long enough for a second window to close
+    QTest::qWait(1000);
+
+    ASSERT_EQ(1, m_changes.size());
+    EXPECT_EQ(3, m_changes.front().added.size());
+    EXPECT_TRUE(m_changes.front().removed.isEmpty());
+
+    finish({removeAccessPoint("0"), removeAccessPoint("1"), removeAccessPoint("2")});
+    ASSERT_TRUE(waitFor([this]() { return m_changes.size() >= 2; }));
+    QTest::qWait(1000);
+
+    ASSERT_EQ(2, m_changes.size());
+    EXPECT_TRUE(m_changes.back().added.isEmpty());
+    EXPECT_EQ(3, m_changes.back().removed.size());
+    EXPECT_TRUE(link->accessPoints().isEmpty());
+
+    EXPECT_EQ(2, link->emittedUpdates());
+    EXPECT_EQ(4, link->coalescedUpdates());
+}
+
+TEST_F(TestWifiLinkImpl, FlushesAtLatencyCap)
+{
+    static const int COUNT = 25;
+
+    auto link = wifiLink();
+    link->setScanDebounce(400, 1000);
+
+    // A new network every 100ms, so the window never closes by itself
+    for (int i = 0; i < COUNT; ++i)
+    {
+        finish({addAccessPoint(QString::number(i), "ssid" + QString::number(i))});
+        QTest::qWait(100);
+    }
+
+    // The cap went off at least once a second while the burst was going
+    EXPECT_GE(m_changes.size(), 2);
+
+    ASSERT_TRUE(waitFor([&link]() { return link->accessPoints().size() == COUNT; }));
+    QTest::qWait(1000);
+
+    int added = 0;
+    for (const auto& change : m_changes)
+    {
+        added += change.added.size();
+        EXPECT_TRUE(change.removed.isEmpty());
+    }
+    EXPECT_EQ(COUNT, added);
+    EXPECT_LT(m_changes.size(), COUNT);
+    EXPECT_EQ(m_changes.size(), link->emittedUpdates());
+    EXPECT_EQ(COUNT - m_changes.size(), link->coalescedUpdates());
+}
+
+TEST_F(TestWifiLinkImpl, AddThenRemoveCancels)
+{
+    auto link = wifiLink();
+    link->setScanDebounce(1000, 10000);
+
+    finish({addAccessPoint("0", "home")});
+    ASSERT_TRUE(waitFor([&link]() { return link->coalescedUpdates() == 1; }));
+    finish({removeAccessPoint("0")});
+    ASSERT_TRUE(waitFor([&link]() { return link->coalescedUpdates() == 2; }));
+
+    // Let the window close
+    QTest::qWait(1500);
+
+    EXPECT_TRUE(m_changes.empty());
+    EXPECT_TRUE(link->accessPoints().isEmpty());
+    EXPECT_EQ(0, link->emittedUpdates());
+    EXPECT_EQ(2, link->coalescedUpdates());
+}
+
+TEST_F(TestWifiLinkImpl, SuppressedWhileDisconnected)
+{
+    auto link = wifiLink();
+    link->setScanDebounce(0, 0);
+    link->setDisconnectWifi(true);
+    m_changes.clear();
+
+    finish({addAccessPoint("0", "home")});
+    ASSERT_TRUE(waitFor([&link]() { return link->suppressedUpdates() == 1; }));
+
+    EXPECT_TRUE(m_changes.empty());
+    EXPECT_TRUE(link->accessPoints().isEmpty());
+    EXPECT_EQ(0, link->emittedUpdates());
+    EXPECT_EQ(0, link->coalescedUpdates());
+}
+
+TEST_F(TestWifiLinkImpl, ConnectsWhenDevicePropertiesFail)
+{
+    // The device only turns up after the link asked for its properties,
+    // so it never learns which saved connections the device can use
+    m_device = "/org/freedesktop/NetworkManager/Devices/0";
+    auto link = createLink();
+    QTest::qWait(100);
+    addDevice();
+    link->setScanDebounce(0, 0);
+
+    finish({addAccessPoint("0", "home")});
+    ASSERT_TRUE(waitFor([&link]() { return link->accessPoints().size() == 1; }));
+
+    link->connect_to(*link->accessPoints().begin());
+
+    EXPECT_TRUE(waitFor([this]() { return !m_nm->activeConnections().isEmpty(); }));
+}
+
+}
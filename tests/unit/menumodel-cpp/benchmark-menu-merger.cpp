@@ -0,0 +1,179 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <menumodel-cpp/menu.h>
+#include <menumodel-cpp/menu-merger.h>
+
+#include <QElapsedTimer>
+#include <gtest/gtest.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace testing;
+
+namespace
+{
+
+/*
+ * Mirrors the menu layout for one Wi-Fi device: WifiLinkItem merges the
+ * "connected before" and "never connected" AP menus, and is itself merged
+ * into a section, which is merged into the top level indicator menu.
+ */
+class BenchmarkMenuMerger: public TestWithParam<int>
+{
+protected:
+    void
+    SetUp() override
+    {
+        m_connected = make_shared<Menu>();
+        m_neverConnected = make_shared<Menu>();
+        for (int i = 0; i < GetParam(); ++i)
+        {
+            auto item = make_shared<MenuItem>(QString("ssid%1").arg(i, 4, 10, QChar('0')), "indicator.ap");
+            item->setAttribute("x-canonical-type", TypedVariant<string>("unity.widgets.systemsettings.tablet.accesspoint"));
+            m_items.push_back(item);
+            m_neverConnected->append(item);
+        }
+
+        auto aps = make_shared<MenuMerger>();
+        aps->append(m_connected);
+        aps->append(m_neverConnected);
+
+        auto link = make_shared<MenuMerger>();
+        link->append(make_shared<Menu>());
+        link->append(aps);
+
+        auto section = make_shared<MenuMerger>();
+        section->append(menuWithItem("Wi-Fi"));
+        section->append(link);
+        section->append(menuWithItem("Wi-Fi settings…"));
+
+        m_root = make_shared<MenuMerger>();
+        m_root->append(menuWithItem("Flight mode"));
+        m_root->append(section);
+        m_root->append(menuWithItem("Mobile data"));
+
+        m_handler = g_signal_connect(static_cast<GMenuModel*>(*m_root), "items-changed", G_CALLBACK(itemsChanged), &m_signals);
+    }
+
+    void
+    TearDown() override
+    {
+        g_signal_handler_disconnect(static_cast<GMenuModel*>(*m_root), m_handler);
+    }
+
+    static void
+    itemsChanged(GMenuModel*, gint, gint, gint, gpointer user_data)
+    {
+        ++*static_cast<int*>(user_data);
+    }
+
+    static Menu::Ptr
+    menuWithItem(const QString& label)
+    {
+        auto menu = make_shared<Menu>();
+        menu->append(make_shared<MenuItem>(label));
+        return menu;
+    }
+
+    void
+    report(const string& name, int operations, qint64 nsecs)
+    {
+        RecordProperty(name + "_ns_per_op", nsecs / operations);
+        RecordProperty(name + "_signals", m_signals);
+        cout << "[ BENCHMARK] " << GetParam() << " APs, " << name << ": "
+             << nsecs / operations << " ns/op, " << m_signals
+             << " top level items-changed for " << operations << " operations" << endl;
+        m_signals = 0;
+    }
+
+    Menu::Ptr m_connected;
+    Menu::Ptr m_neverConnected;
+    vector<MenuItem::Ptr> m_items;
+
+    MenuMerger::Ptr m_root;
+    gulong m_handler = 0;
+    int m_signals = 0;
+};
+
+TEST_P(BenchmarkMenuMerger, AttributeChurn)
+{
+    const int rounds = 2000;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < rounds; ++i)
+    {
+        auto& item = m_items[(i * 7919) % m_items.size()];
+        ScopedTransaction<MenuItem> transaction(*item);
+        item->setAttribute("x-canonical-wifi-ap-is-secure", TypedVariant<bool>(i % 2));
+        item->setAttribute("x-canonical-wifi-ap-is-adhoc", TypedVariant<bool>(i % 3 == 0));
+    }
+    report("attribute_churn", rounds, timer.nsecsElapsed());
+}
+
+TEST_P(BenchmarkMenuMerger, ActiveAccessPointChurn)
+{
+    const int rounds = 2000;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < rounds; ++i)
+    {
+        // what WifiLinkItem does when the active access point changes
+        auto& item = m_items[(i * 7919) % m_items.size()];
+        ScopedTransaction<Menu> connected(*m_connected);
+        ScopedTransaction<Menu> neverConnected(*m_neverConnected);
+        auto current = m_connected->begin();
+        if (current != m_connected->end())
+        {
+            m_neverConnected->insert(*current, m_neverConnected->begin());
+            m_connected->clear();
+        }
+        m_connected->append(item);
+        m_neverConnected->removeAll(item);
+    }
+    report("active_ap_churn", rounds, timer.nsecsElapsed());
+}
+
+TEST_P(BenchmarkMenuMerger, Lookup)
+{
+    const int rounds = 20000;
+    int n = g_menu_model_get_n_items(*m_root);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < rounds; ++i)
+    {
+        GVariant* value = g_menu_model_get_item_attribute_value(*m_root, (i * 7919) % n, G_MENU_ATTRIBUTE_LABEL, nullptr);
+        if (value)
+        {
+            g_variant_unref(value);
+        }
+    }
+    report("lookup", rounds, timer.nsecsElapsed());
+}
+
+INSTANTIATE_TEST_CASE_P(
+        MenuMerger,
+        BenchmarkMenuMerger,
+        Values(50, 500));
+
+}
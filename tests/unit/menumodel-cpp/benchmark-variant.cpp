@@ -0,0 +1,184 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <menumodel-cpp/action.h>
+#include <menumodel-cpp/gio-helpers/variant.h>
+
+#include <QElapsedTimer>
+#include <gtest/gtest.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace testing;
+
+namespace
+{
+
+Variant
+icon(const string& name)
+{
+    auto gicon = shared_ptr<GIcon>(g_themed_icon_new(name.c_str()), GObjectDeleter());
+    return Variant::fromGVariant(g_icon_serialize(gicon.get()));
+}
+
+// Builds the indicator root state the same way RootState does.
+Variant
+rootState(const vector<string>& icons)
+{
+    map<string, Variant> state;
+    vector<Variant> iconVariants;
+    for (const auto& name : icons)
+    {
+        iconVariants.push_back(icon(name));
+    }
+    state["icon"] = iconVariants.back();
+    state["icons"] = TypedVariant<vector<Variant>>(iconVariants);
+    state["title"] = TypedVariant<string>("Network");
+    state["visible"] = TypedVariant<bool>(true);
+    return TypedVariant<map<string, Variant>>(state);
+}
+
+// How Variant::operator== used to compare containers.
+bool
+printedEqual(const Variant& a, const Variant& b)
+{
+    return a.to_string(true) == b.to_string(true);
+}
+
+class BenchmarkVariant: public Test
+{
+protected:
+    void
+    report(const string& name, int operations, qint64 nsecs)
+    {
+        RecordProperty(name + "_ns_per_op", nsecs / operations);
+        cout << "[ BENCHMARK] " << name << ": " << nsecs / operations << " ns/op" << endl;
+    }
+
+    const vector<string> icons {"airplane-mode", "gsm-3g-full", "network-cellular-roaming",
+        "nm-signal-100-secure", "transfer-progress-download", "hotspot-active"};
+
+    const int rounds = 10000;
+};
+
+TEST_F(BenchmarkVariant, CompareEqualStates)
+{
+    auto current = rootState(icons);
+
+    // every update builds a fresh state to compare with the current one
+    vector<Variant> updates;
+    for (int i = 0; i < rounds; ++i)
+    {
+        updates.push_back(rootState(icons));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const auto& update : updates)
+    {
+        EXPECT_TRUE(printedEqual(current, update));
+    }
+    report("printed_compare", rounds, timer.nsecsElapsed());
+
+    timer.restart();
+    for (const auto& update : updates)
+    {
+        EXPECT_TRUE(current == update);
+    }
+    report("structural_compare", rounds, timer.nsecsElapsed());
+}
+
+TEST_F(BenchmarkVariant, CompareChangedStates)
+{
+    auto current = rootState(icons);
+
+    auto changedIcons = icons;
+    changedIcons[4] = "transfer-progress-upload";
+    vector<Variant> updates;
+    for (int i = 0; i < rounds; ++i)
+    {
+        updates.push_back(rootState(i % 2 ? icons : changedIcons));
+    }
+
+    int printedMatches = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (const auto& update : updates)
+    {
+        printedMatches += printedEqual(current, update);
+    }
+    report("printed_compare_changed", rounds, timer.nsecsElapsed());
+
+    int structuralMatches = 0;
+    timer.restart();
+    for (const auto& update : updates)
+    {
+        structuralMatches += (current == update);
+    }
+    report("structural_compare_changed", rounds, timer.nsecsElapsed());
+
+    EXPECT_EQ(rounds / 2, printedMatches);
+    EXPECT_EQ(printedMatches, structuralMatches);
+}
+
+TEST_F(BenchmarkVariant, RootStateUpdate)
+{
+    // one action per indicator profile (phone, greeter, ubiquity)
+    vector<shared_ptr< ::Action>> actions;
+    for (auto profile : {"phone", "greeter", "ubiquity"})
+    {
+        actions.push_back(make_shared< ::Action>(profile, nullptr, rootState(icons)));
+    }
+
+    auto changedIcons = icons;
+    changedIcons[4] = "transfer-progress-upload";
+    vector<Variant> updates;
+    for (int i = 0; i < rounds; ++i)
+    {
+        // mostly unchanged, as with the one second transfer updates
+        updates.push_back(rootState(i % 4 ? icons : changedIcons));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const auto& update : updates)
+    {
+        for (auto& action : actions)
+        {
+            if (!printedEqual(update, action->state()))
+            {
+                g_simple_action_set_state(G_SIMPLE_ACTION(action->gaction().get()), update);
+            }
+        }
+    }
+    report("root_state_update_printed", rounds, timer.nsecsElapsed());
+
+    timer.restart();
+    for (const auto& update : updates)
+    {
+        for (auto& action : actions)
+        {
+            action->setState(update);
+        }
+    }
+    report("root_state_update_structural", rounds, timer.nsecsElapsed());
+}
+
+}
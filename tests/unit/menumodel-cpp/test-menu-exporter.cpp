@@ -27,6 +27,7 @@
 
 #include <libqtdbustest/DBusTestRunner.h>
 #include <QSignalSpy>
+#include <QTest>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <unity/gmenuharness/MenuMatcher.h>
@@ -72,6 +73,100 @@ protected:
 }
 ;
 
+/**
+ * Listens for the Changed signals of the exported action group, after the
+ * exporter itself does.
+ */
+class ChangedWatch
+{
+public:
+    ChangedWatch(SessionBus::Ptr sessionBus, const ActionGroupExporter& exporter) :
+        m_sessionBus(sessionBus), m_exporter(exporter)
+    {
+        m_subscription = g_dbus_connection_signal_subscribe(m_sessionBus->bus().get(),
+                g_dbus_connection_get_unique_name(m_sessionBus->bus().get()),
+                "org.gtk.Actions",
+                "Changed",
+                "/actions/path",
+                nullptr,
+                G_DBUS_SIGNAL_FLAGS_NONE,
+                changed,
+                this,
+                nullptr);
+    }
+
+    ~ChangedWatch()
+    {
+        g_dbus_connection_signal_unsubscribe(m_sessionBus->bus().get(), m_subscription);
+    }
+
+    int m_count = 0;
+
+    // Whether the exporter had noticed by the time we did
+    bool m_exportedFirst = false;
+
+private:
+    static void changed(GDBusConnection *, const gchar *, const gchar *,
+                        const gchar *, const gchar *, GVariant *,
+                        gpointer user_data)
+    {
+        auto that = static_cast<ChangedWatch*>(user_data);
+        if (that->m_count++ == 0)
+        {
+            that->m_exportedFirst = that->m_exporter.isExported();
+        }
+    }
+
+    SessionBus::Ptr m_sessionBus;
+
+    const ActionGroupExporter& m_exporter;
+
+    guint m_subscription = 0;
+};
+
+TEST_F(TestMenuExporter, ExportedOnFirstChangedSignal)
+{
+    // Adding the actions to the exported group emits Changed
+    actionGroup->add(make_shared< ::Action>("apple"));
+    actionGroupExporter.reset(
+            new ActionGroupExporter(sessionBus, actionGroup, "/actions/path"));
+    ChangedWatch watch(sessionBus, *actionGroupExporter);
+    QSignalSpy spy(actionGroupExporter.get(), SIGNAL(exported()));
+
+    EXPECT_FALSE(actionGroupExporter->isExported());
+
+    ASSERT_TRUE(spy.wait());
+    for (int i = 0; i < 100 && watch.m_count == 0; ++i)
+    {
+        QTest::qWait(10);
+    }
+    ASSERT_GT(watch.m_count, 0);
+    EXPECT_TRUE(watch.m_exportedFirst);
+    EXPECT_TRUE(actionGroupExporter->isExported());
+
+    // The fallback timer doesn't announce it again
+    QTest::qWait(300);
+    EXPECT_EQ(1, spy.size());
+}
+
+TEST_F(TestMenuExporter, ExportedAfterTimeoutWithoutChanges)
+{
+    // Nothing to add, so no Changed signal
+    actionGroupExporter.reset(
+            new ActionGroupExporter(sessionBus, actionGroup, "/actions/path"));
+    ChangedWatch watch(sessionBus, *actionGroupExporter);
+    QSignalSpy spy(actionGroupExporter.get(), SIGNAL(exported()));
+
+    EXPECT_FALSE(actionGroupExporter->isExported());
+
+    ASSERT_TRUE(spy.wait());
+    EXPECT_TRUE(actionGroupExporter->isExported());
+    EXPECT_EQ(0, watch.m_count);
+
+    QTest::qWait(300);
+    EXPECT_EQ(1, spy.size());
+}
+
 TEST_F(TestMenuExporter, ExportBasicActionsAndMenu)
 {
     actionGroup->add(make_shared< ::Action>("apple"));
@@ -0,0 +1,332 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <menumodel-cpp/menu.h>
+#include <menumodel-cpp/menu-merger.h>
+#include <menumodel-cpp/sorted-menu.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+using namespace std;
+using namespace testing;
+
+namespace
+{
+
+struct ItemsChanged
+{
+    int position;
+    int removed;
+    int added;
+
+    bool operator==(const ItemsChanged& other) const
+    {
+        return position == other.position && removed == other.removed
+                && added == other.added;
+    }
+};
+
+class TestMenu : public Test
+{
+protected:
+    void
+    TearDown() override
+    {
+        for (auto handler : handlers)
+        {
+            g_signal_handler_disconnect(handler.first, handler.second);
+        }
+    }
+
+    static void
+    itemsChangedCallback(GMenuModel*, gint position, gint removed, gint added, gpointer user_data)
+    {
+        auto signals = static_cast<vector<ItemsChanged>*>(user_data);
+        signals->push_back({position, removed, added});
+    }
+
+    void
+    watch(GMenuModel* model, vector<ItemsChanged>& signals)
+    {
+        handlers.push_back(make_pair(model, g_signal_connect(model, "items-changed", G_CALLBACK(itemsChangedCallback), &signals)));
+    }
+
+    static vector<string>
+    labels(GMenuModel* model)
+    {
+        vector<string> result;
+        for (int i = 0; i < g_menu_model_get_n_items(model); ++i)
+        {
+            gchar* label = nullptr;
+            if (g_menu_model_get_item_attribute(model, i, G_MENU_ATTRIBUTE_LABEL, "s", &label))
+            {
+                result.push_back(label);
+                g_free(label);
+            }
+            else
+            {
+                result.push_back(string());
+            }
+        }
+        return result;
+    }
+
+    static Menu::Ptr
+    menuWith(initializer_list<const char*> items)
+    {
+        auto menu = make_shared<Menu>();
+        for (auto label : items)
+        {
+            menu->append(make_shared<MenuItem>(label));
+        }
+        return menu;
+    }
+
+    vector<pair<GMenuModel*, gulong>> handlers;
+};
+
+TEST_F(TestMenu, ItemEditsOutsideTransactionEmitOnce)
+{
+    auto menu = make_shared<Menu>();
+    menu->append(make_shared<MenuItem>("Apple"));
+    auto banana = make_shared<MenuItem>("Banana");
+    menu->append(banana);
+
+    vector<ItemsChanged> signals;
+    watch(*menu, signals);
+
+    banana->setLabel("Blueberry");
+
+    ASSERT_EQ(1u, signals.size());
+    EXPECT_EQ((ItemsChanged{1, 1, 1}), signals.front());
+}
+
+TEST_F(TestMenu, ItemTransactionCollapsesEdits)
+{
+    auto menu = make_shared<Menu>();
+    auto item = make_shared<MenuItem>("Apple");
+    menu->append(item);
+
+    vector<ItemsChanged> signals;
+    watch(*menu, signals);
+
+    item->beginTransaction();
+    item->setLabel("Apricot");
+    item->setAttribute("x-a", TypedVariant<bool>(true));
+    item->setAttribute("x-b", TypedVariant<bool>(true));
+    item->setAttribute("x-c", TypedVariant<bool>(true));
+    EXPECT_TRUE(signals.empty());
+    item->commitTransaction();
+
+    ASSERT_EQ(1u, signals.size());
+    EXPECT_EQ((ItemsChanged{0, 1, 1}), signals.front());
+
+    gchar* label = nullptr;
+    ASSERT_TRUE(g_menu_model_get_item_attribute(*menu, 0, G_MENU_ATTRIBUTE_LABEL, "s", &label));
+    EXPECT_STREQ("Apricot", label);
+    g_free(label);
+}
+
+TEST_F(TestMenu, EmptyTransactionEmitsNothing)
+{
+    auto menu = make_shared<Menu>();
+    auto item = make_shared<MenuItem>("Apple");
+    menu->append(item);
+
+    vector<ItemsChanged> signals;
+    watch(*menu, signals);
+
+    {
+        ScopedTransaction<Menu> transaction(*menu);
+        auto transient = make_shared<MenuItem>("Banana");
+        menu->append(transient);
+        menu->removeAll(transient);
+    }
+    {
+        ScopedTransaction<MenuItem> transaction(*item);
+        item->setLabel("Apple");
+    }
+
+    EXPECT_TRUE(signals.empty());
+}
+
+TEST_F(TestMenu, MenuTransactionCoversAllEdits)
+{
+    auto menu = make_shared<Menu>();
+    vector<MenuItem::Ptr> items;
+    for (auto label : {"a", "b", "c", "d", "e"})
+    {
+        items.push_back(make_shared<MenuItem>(label));
+        menu->append(items.back());
+    }
+
+    vector<ItemsChanged> signals;
+    watch(*menu, signals);
+
+    {
+        ScopedTransaction<Menu> transaction(*menu);
+        items[1]->setLabel("B");
+        items[1]->setAttribute("x-a", TypedVariant<bool>(true));
+        menu->remove(menu->find(items[3]));
+        menu->insert(make_shared<MenuItem>("f"), menu->find(items[2]));
+    }
+
+    // a B f c e
+    ASSERT_EQ(1u, signals.size());
+    EXPECT_EQ((ItemsChanged{1, 3, 3}), signals.front());
+    EXPECT_EQ(5, g_menu_model_get_n_items(*menu));
+}
+
+TEST_F(TestMenu, MergerForwardsOneChangePerCommit)
+{
+    auto first = make_shared<Menu>();
+    auto second = make_shared<Menu>();
+    first->append(make_shared<MenuItem>("a"));
+    second->append(make_shared<MenuItem>("b"));
+
+    auto merger = make_shared<MenuMerger>();
+    merger->append(first);
+    merger->append(second);
+
+    vector<ItemsChanged> signals;
+    watch(*merger, signals);
+
+    {
+        ScopedTransaction<MenuMerger> mergerTransaction(*merger);
+        ScopedTransaction<Menu> transaction(*second);
+        second->clear();
+        for (auto label : {"c", "d", "e"})
+        {
+            second->append(make_shared<MenuItem>(label));
+        }
+        first->append(make_shared<MenuItem>("f"));
+    }
+
+    // a f c d e
+    ASSERT_EQ(1u, signals.size());
+    EXPECT_EQ((ItemsChanged{1, 1, 4}), signals.front());
+    EXPECT_EQ(5, g_menu_model_get_n_items(*merger));
+}
+
+TEST_F(TestMenu, MergerResolvesNestedItems)
+{
+    auto a = menuWith({"a1", "a2"});
+    auto b = menuWith({});
+    auto c = menuWith({"c1", "c2", "c3"});
+    auto d = menuWith({"d1"});
+
+    auto inner = make_shared<MenuMerger>();
+    inner->append(b);
+    inner->append(c);
+
+    auto outer = make_shared<MenuMerger>();
+    outer->append(a);
+    outer->append(inner);
+    outer->append(d);
+
+    EXPECT_EQ(vector<string>({"a1", "a2", "c1", "c2", "c3", "d1"}), labels(*outer));
+
+    vector<ItemsChanged> signals;
+    watch(*outer, signals);
+
+    c->remove(c->find(*next(c->begin())));
+    EXPECT_EQ(vector<string>({"a1", "a2", "c1", "c3", "d1"}), labels(*outer));
+
+    b->append(make_shared<MenuItem>("b1"));
+    EXPECT_EQ(vector<string>({"a1", "a2", "b1", "c1", "c3", "d1"}), labels(*outer));
+
+    outer->remove(a);
+    EXPECT_EQ(vector<string>({"b1", "c1", "c3", "d1"}), labels(*outer));
+
+    d->append(make_shared<MenuItem>("d2"));
+    EXPECT_EQ(vector<string>({"b1", "c1", "c3", "d1", "d2"}), labels(*outer));
+
+    EXPECT_EQ(vector<ItemsChanged>({{3, 1, 0}, {2, 0, 1}, {0, 2, 0}, {4, 0, 1}}), signals);
+}
+
+TEST_F(TestMenu, MergerTracksManyChildren)
+{
+    auto merger = make_shared<MenuMerger>();
+    vector<Menu::Ptr> menus;
+    vector<string> expected;
+    for (int i = 0; i < 37; ++i)
+    {
+        menus.push_back(make_shared<Menu>());
+        // leave some children empty
+        for (int j = 0; j < i % 3; ++j)
+        {
+            auto label = to_string(i) + "." + to_string(j);
+            menus.back()->append(make_shared<MenuItem>(QString::fromStdString(label)));
+            expected.push_back(label);
+        }
+        merger->append(menus.back());
+    }
+    EXPECT_EQ(expected, labels(*merger));
+
+    for (int i = 0; i < 37; i += 5)
+    {
+        auto label = to_string(i) + ".x";
+        menus[i]->insert(make_shared<MenuItem>(QString::fromStdString(label)), menus[i]->begin());
+        expected.insert(find_if(expected.begin(), expected.end(), [i](const string& l)
+        {
+            return stoi(l) >= i;
+        }), label);
+    }
+    EXPECT_EQ(expected, labels(*merger));
+
+    merger->clear();
+    EXPECT_EQ(0, g_menu_model_get_n_items(*merger));
+}
+
+TEST_F(TestMenu, SortedMenuOrdersByKey)
+{
+    auto menu = make_shared<SortedMenu>();
+
+    map<string, MenuItem::Ptr> items;
+    for (auto label : {"delta", "Alpha", "charlie", "bravo", "alpha"})
+    {
+        items[label] = make_shared<MenuItem>(label);
+        menu->insert(items[label], QString(label).toUpper());
+    }
+    // equal keys keep their insertion order
+    EXPECT_EQ(vector<string>({"Alpha", "alpha", "bravo", "charlie", "delta"}), labels(*menu));
+
+    // already present
+    menu->insert(items["delta"], "A");
+    EXPECT_EQ(5u, menu->size());
+
+    vector<ItemsChanged> signals;
+    watch(*menu, signals);
+
+    menu->remove(items["alpha"]);
+    EXPECT_FALSE(menu->contains(items["alpha"]));
+    items["charlie"]->setLabel("Charlie");
+    EXPECT_EQ(vector<string>({"Alpha", "bravo", "Charlie", "delta"}), labels(*menu));
+    EXPECT_EQ(vector<ItemsChanged>({{1, 1, 0}, {2, 1, 1}}), signals);
+
+    // removed items are no longer tracked
+    items["alpha"]->setLabel("ALPHA");
+    EXPECT_EQ(2u, signals.size());
+}
+
+} // namespace
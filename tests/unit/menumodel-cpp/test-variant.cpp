@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <menumodel-cpp/gio-helpers/variant.h>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace testing;
+
+namespace
+{
+
+Variant
+parse(const char* text)
+{
+    return Variant::fromGVariant(g_variant_parse(nullptr, text, nullptr, nullptr, nullptr));
+}
+
+TEST(TestVariant, NullVariants)
+{
+    EXPECT_TRUE(Variant() == Variant());
+    EXPECT_FALSE(Variant() == TypedVariant<bool>(true));
+    EXPECT_FALSE(TypedVariant<bool>(true) == Variant());
+}
+
+TEST(TestVariant, BasicTypes)
+{
+    EXPECT_TRUE(TypedVariant<string>("a") == TypedVariant<string>("a"));
+    EXPECT_FALSE(TypedVariant<string>("a") == TypedVariant<string>("b"));
+    EXPECT_FALSE(parse("uint32 1") == parse("int32 1"));
+    EXPECT_TRUE(parse("1.5") == parse("1.5"));
+}
+
+TEST(TestVariant, Containers)
+{
+    auto a = parse("{'icon': <('themed', <['nm-signal-100', 'nm-signal-100-symbolic']>)>, 'visible': <true>}");
+    auto b = parse("{'icon': <('themed', <['nm-signal-100', 'nm-signal-100-symbolic']>)>, 'visible': <true>}");
+    EXPECT_EQ(a.hash(), b.hash());
+    EXPECT_TRUE(a == b);
+
+    EXPECT_FALSE(a == parse("{'icon': <('themed', <['nm-signal-75', 'nm-signal-75-symbolic']>)>, 'visible': <true>}"));
+    EXPECT_FALSE(a == parse("{'icon': <('themed', <['nm-signal-100', 'nm-signal-100-symbolic']>)>}"));
+
+    // same value boxed with a different type
+    EXPECT_FALSE(parse("[<uint32 1>]") == parse("[<int32 1>]"));
+    EXPECT_TRUE(parse("[<byte 1>, <'x'>]") == parse("[<byte 1>, <'x'>]"));
+    EXPECT_FALSE(parse("[<byte 1>, <'x'>]") == parse("[<byte 1>, <'y'>]"));
+}
+
+TEST(TestVariant, CopiesKeepHash)
+{
+    auto a = parse("[1, 2, 3]");
+    auto hash = a.hash();
+    Variant b(a);
+    EXPECT_EQ(hash, b.hash());
+    Variant c;
+    c = b;
+    EXPECT_TRUE(a == c);
+    EXPECT_EQ(hash, c.hash());
+}
+
+}
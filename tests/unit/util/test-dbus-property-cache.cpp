@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Pete Woods <pete.woods@canonical.com>
+ */
+
+#include <util/dbus-property-cache.h>
+
+#include <libqtdbustest/DBusTestRunner.h>
+#include <libqtdbusmock/DBusMock.h>
+#include <QSignalSpy>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace testing;
+using namespace QtDBusTest;
+using namespace QtDBusMock;
+using namespace util;
+
+namespace
+{
+
+static const char* SERVICE = "com.example.Cached";
+static const char* PATH = "/com/example/Cached";
+static const char* INTERFACE = "com.example.Cached";
+// Not on the object until a test adds it
+static const char* LATE_INTERFACE = "com.example.Cached.Late";
+
+class TestDBusPropertyCache : public Test
+{
+protected:
+    TestDBusPropertyCache() :
+            dbusMock(dbusTestRunner)
+    {
+        dbusMock.registerCustomMock(SERVICE, PATH, INTERFACE, QDBusConnection::SessionBus);
+        dbusTestRunner.startServices();
+    }
+
+    void addProperties(const QString& interface, const QVariantMap& properties)
+    {
+        auto& mock = dbusMock.mockInterface(SERVICE, PATH, INTERFACE, QDBusConnection::SessionBus);
+        auto reply = mock.AddProperties(interface, properties);
+        reply.waitForFinished();
+        EXPECT_FALSE(reply.isError()) << reply.error().message().toStdString();
+    }
+
+    DBusPropertyCache::UPtr newCache(const QString& interface)
+    {
+        return make_unique<DBusPropertyCache>(SERVICE, interface, PATH, dbusTestRunner.sessionConnection());
+    }
+
+    DBusTestRunner dbusTestRunner;
+
+    DBusMock dbusMock;
+};
+
+TEST_F(TestDBusPropertyCache, WhenInitializedWaitsForTheProperties)
+{
+    addProperties(INTERFACE, {{"name", "first"}});
+    auto cache = newCache(INTERFACE);
+    QSignalSpy spy(cache.get(), SIGNAL(initialized()));
+
+    QObject context;
+    QVariant seen;
+    int calls = 0;
+    cache->whenInitialized(&context, [&]()
+    {
+        seen = cache->get("name");
+        ++calls;
+    });
+    EXPECT_EQ(0, calls);
+
+    ASSERT_TRUE(spy.wait());
+    EXPECT_EQ(1, calls);
+    EXPECT_EQ(QVariant("first"), seen);
+
+    // Already initialized, so straight away
+    cache->whenInitialized(&context, [&]()
+    {
+        ++calls;
+    });
+    EXPECT_EQ(2, calls);
+}
+
+TEST_F(TestDBusPropertyCache, WhenInitializedIsDroppedWithItsContext)
+{
+    auto cache = newCache(INTERFACE);
+    QSignalSpy spy(cache.get(), SIGNAL(initialized()));
+
+    bool called = false;
+    {
+        QObject context;
+        cache->whenInitialized(&context, [&called]()
+        {
+            called = true;
+        });
+    }
+
+    ASSERT_TRUE(spy.wait());
+    EXPECT_FALSE(called);
+}
+
+TEST_F(TestDBusPropertyCache, RetriesAFailedFetch)
+{
+    auto cache = newCache(LATE_INTERFACE);
+    QSignalSpy spy(cache.get(), SIGNAL(initialized()));
+
+    // The first GetAll fails, as the interface isn't there yet
+    EXPECT_FALSE(spy.wait(500));
+    EXPECT_FALSE(cache->isInitialized());
+
+    addProperties(LATE_INTERFACE, {{"name", "late"}});
+
+    ASSERT_TRUE(spy.wait(5000));
+    EXPECT_TRUE(cache->isInitialized());
+    EXPECT_EQ(QVariant("late"), cache->get("name"));
+}
+
+}